@@ -0,0 +1,192 @@
+#include "asset_cache.h"
+#include <SDL_image.h>
+#include <iostream>
+#include <vector>
+
+AssetCache::AssetCache(SDL_Renderer* renderer, size_t budgetBytes)
+    : renderer(renderer), pack(nullptr), budget(budgetBytes), residentBytes(0), useClock(0) {}
+
+AssetCache::~AssetCache() {
+    for (auto& item : entries) {
+        if (item.second.refs > 0) {
+            std::cerr << "Asset still in use at shutdown: " << item.first << std::endl;
+        }
+        destroy(item.second);
+    }
+}
+
+SDL_Texture* AssetCache::AcquireTexture(const std::string& path) {
+    return static_cast<SDL_Texture*>(acquire(path, ASSET_TEXTURE));
+}
+
+Mix_Chunk* AssetCache::AcquireChunk(const std::string& path) {
+    return static_cast<Mix_Chunk*>(acquire(path, ASSET_CHUNK));
+}
+
+Mix_Music* AssetCache::AcquireMusic(const std::string& path) {
+    return static_cast<Mix_Music*>(acquire(path, ASSET_MUSIC));
+}
+
+void* AssetCache::acquire(const std::string& path, AssetKind kind) {
+    auto it = entries.find(path);
+    if (it != entries.end()) {
+        if (it->second.kind != kind) {
+            std::cerr << "Asset " << path << " requested as a different type" << std::endl;
+            return nullptr;
+        }
+        it->second.refs++;
+        it->second.lastUse = ++useClock;
+        return it->second.asset;
+    }
+
+    Entry entry = {kind, nullptr, 0, 1, ++useClock};
+    if (!load(path, kind, entry)) return nullptr;  // Lỗi không được cache để lần sau còn thử lại
+    insert(path, entry);
+    return entry.asset;
+}
+
+void AssetCache::AdoptTexture(const std::string& path, SDL_Texture* texture, size_t bytes) {
+    adopt(path, Entry{ASSET_TEXTURE, texture, bytes, 0, ++useClock});
+}
+
+void AssetCache::AdoptChunk(const std::string& path, Mix_Chunk* chunk) {
+    adopt(path, Entry{ASSET_CHUNK, chunk, chunk->alen, 0, ++useClock});
+}
+
+void AssetCache::adopt(const std::string& path, const Entry& entry) {
+    if (entries.count(path)) {
+        Entry duplicate = entry;  // Đã được nạp đồng bộ trong lúc chờ
+        destroy(duplicate);
+        return;
+    }
+    insert(path, entry);
+}
+
+void AssetCache::insert(const std::string& path, const Entry& entry) {
+    entries[path] = entry;
+    pathOf[entry.asset] = path;
+    residentBytes += entry.bytes;
+    evictToBudget();
+}
+
+SDL_RWops* AssetCache::OpenFile(const std::string& path) const {
+    SDL_RWops* file = pack ? pack->OpenRW(path) : nullptr;
+    return file ? file : SDL_RWFromFile(path.c_str(), "rb");
+}
+
+bool AssetCache::load(const std::string& path, AssetKind kind, Entry& entry) {
+    switch (kind) {
+        case ASSET_TEXTURE: {
+            // Ảnh đã giải mã sẵn trong gói: chép thẳng pixel từ vùng map, không qua SDL_image
+            AssetPack::Blob blob;
+            if (pack && pack->Find(path, &blob) && blob.format != AssetPack::FORMAT_RAW) {
+                SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC,
+                                                         blob.width, blob.height);
+                const void* pixels = blob.data;
+                std::vector<Uint8> straight;
+                if (texture && !SetPackTextureBlendMode(texture, blob.format)) {
+                    // Renderer không blend được màu nhân sẵn: upload bản sao đã đổi về màu thẳng
+                    straight.assign(blob.data, blob.data + static_cast<size_t>(blob.pitch) * blob.height);
+                    UnpremultiplyPixels(straight.data(), blob.width, blob.height, blob.pitch);
+                    pixels = straight.data();
+                }
+                if (!texture || SDL_UpdateTexture(texture, nullptr, pixels, blob.pitch) < 0) {
+                    std::cerr << "Unable to create texture from " << path << "! SDL_Error: " << SDL_GetError() << std::endl;
+                    if (texture) SDL_DestroyTexture(texture);
+                    return false;
+                }
+                entry.asset = texture;
+                entry.bytes = static_cast<size_t>(blob.width) * blob.height * 4;
+                return true;
+            }
+
+            SDL_Surface* surface = IMG_Load_RW(OpenFile(path), 1);
+            if (!surface) {
+                std::cerr << "Unable to load image " << path << "! SDL_image Error: " << IMG_GetError() << std::endl;
+                return false;
+            }
+            SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+            entry.bytes = static_cast<size_t>(surface->w) * surface->h * 4;
+            SDL_FreeSurface(surface);
+            if (!texture) {
+                std::cerr << "Unable to create texture from " << path << "! SDL_Error: " << SDL_GetError() << std::endl;
+                return false;
+            }
+            entry.asset = texture;
+            return true;
+        }
+        case ASSET_CHUNK: {
+            Mix_Chunk* chunk = Mix_LoadWAV_RW(OpenFile(path), 1);
+            if (!chunk) {
+                std::cerr << "Failed to load sound " << path << "! SDL_mixer Error: " << Mix_GetError() << std::endl;
+                return false;
+            }
+            entry.asset = chunk;
+            entry.bytes = chunk->alen;
+            return true;
+        }
+        case ASSET_MUSIC: {
+            // Nhạc được stream trong lúc phát; nếu nằm trong gói thì đọc từ vùng map nên gói phải còn mở
+            SDL_RWops* file = OpenFile(path);
+            Sint64 size = file ? SDL_RWsize(file) : -1;
+            Mix_Music* music = file ? Mix_LoadMUS_RW(file, 1) : nullptr;
+            if (!music) {
+                std::cerr << "Failed to load music " << path << "! SDL_mixer Error: " << Mix_GetError() << std::endl;
+                return false;
+            }
+            entry.asset = music;
+            entry.bytes = size > 0 ? static_cast<size_t>(size) : 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+void AssetCache::Release(const void* asset) {
+    if (!asset) return;
+    auto path = pathOf.find(asset);
+    if (path == pathOf.end()) {
+        std::cerr << "Releasing an asset that is not in the cache" << std::endl;
+        return;
+    }
+    Entry& entry = entries[path->second];
+    if (entry.refs <= 0) {
+        std::cerr << "Asset released too many times: " << path->second << std::endl;
+        return;
+    }
+    entry.refs--;
+    entry.lastUse = ++useClock;
+    if (entry.refs == 0) evictToBudget();
+}
+
+void AssetCache::SetBudget(size_t bytes) {
+    budget = bytes;
+    evictToBudget();
+}
+
+void AssetCache::destroy(Entry& entry) {
+    switch (entry.kind) {
+        case ASSET_TEXTURE: SDL_DestroyTexture(static_cast<SDL_Texture*>(entry.asset)); break;
+        case ASSET_CHUNK: Mix_FreeChunk(static_cast<Mix_Chunk*>(entry.asset)); break;
+        case ASSET_MUSIC: Mix_FreeMusic(static_cast<Mix_Music*>(entry.asset)); break;
+    }
+    entry.asset = nullptr;
+}
+
+void AssetCache::evictToBudget() {
+    // Số tài nguyên chỉ vài chục nên mỗi lần tìm tuyến tính tài nguyên rảnh cũ nhất là đủ
+    while (residentBytes > budget) {
+        auto oldest = entries.end();
+        for (auto it = entries.begin(); it != entries.end(); ++it) {
+            if (it->second.refs == 0 && (oldest == entries.end() || it->second.lastUse < oldest->second.lastUse)) {
+                oldest = it;
+            }
+        }
+        if (oldest == entries.end()) return;  // Mọi thứ đều đang được dùng
+
+        residentBytes -= oldest->second.bytes;
+        pathOf.erase(oldest->second.asset);
+        destroy(oldest->second);
+        entries.erase(oldest);
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef ASSET_CACHE_H
+#define ASSET_CACHE_H
+
+#include <SDL.h>
+#include <SDL_mixer.h>
+#include <string>
+#include <unordered_map>
+#include "asset_pack.h"
+
+// Kho tài nguyên dùng chung cho Game và các chế độ chơi, khóa theo đường dẫn file.
+// Acquire*() tăng số tham chiếu (file chỉ được đọc và giải mã ở lần đầu), Release() giảm.
+// Tài nguyên hết tham chiếu vẫn được giữ để vào lại mode không phải đọc đĩa; chỉ khi tổng dung lượng
+// vượt ngân sách mới bị giải phóng, cũ nhất trước. Tài nguyên đang được dùng không bao giờ bị giải phóng.
+class AssetCache {
+public:
+    static const size_t DEFAULT_BUDGET_BYTES = 256u * 1024u * 1024u;
+
+    explicit AssetCache(SDL_Renderer* renderer, size_t budgetBytes = DEFAULT_BUDGET_BYTES);
+    ~AssetCache();  // Giải phóng mọi thứ, phải chạy trước khi hủy renderer và đóng SDL_mixer
+
+    SDL_Texture* AcquireTexture(const std::string& path);
+    Mix_Chunk* AcquireChunk(const std::string& path);
+    Mix_Music* AcquireMusic(const std::string& path);
+    void Release(const void* asset);  // nullptr được bỏ qua
+
+    // Cho AssetLoader: đưa vào cache tài nguyên đã được giải mã ở nơi khác, chưa ai giữ tham chiếu.
+    // Đường dẫn đã có trong cache thì bản mới bị hủy.
+    bool Contains(const std::string& path) const { return entries.count(path) != 0; }
+    void AdoptTexture(const std::string& path, SDL_Texture* texture, size_t bytes);
+    void AdoptChunk(const std::string& path, Mix_Chunk* chunk);
+    SDL_Renderer* Renderer() const { return renderer; }
+
+    // Có gói thì tài nguyên trong gói được đọc từ vùng nhớ đã map thay cho file rời; gói phải sống lâu hơn cache
+    void SetPack(const AssetPack* assetPack) { pack = assetPack; }
+    const AssetPack* Pack() const { return pack; }
+    SDL_RWops* OpenFile(const std::string& path) const;  // Trong gói nếu có, không thì file rời
+
+    void SetBudget(size_t bytes);
+    size_t ResidentBytes() const { return residentBytes; }
+
+private:
+    enum AssetKind {
+        ASSET_TEXTURE,
+        ASSET_CHUNK,
+        ASSET_MUSIC
+    };
+
+    struct Entry {
+        AssetKind kind;
+        void* asset;
+        size_t bytes;   // Ước lượng bộ nhớ: w*h*4 với texture, độ dài mẫu với chunk, kích thước file với nhạc
+        int refs;
+        Uint64 lastUse;  // Để chọn tài nguyên hết tham chiếu lâu nhất khi phải giải phóng
+    };
+
+    void* acquire(const std::string& path, AssetKind kind);
+    bool load(const std::string& path, AssetKind kind, Entry& entry);
+    void adopt(const std::string& path, const Entry& entry);
+    void insert(const std::string& path, const Entry& entry);
+    void destroy(Entry& entry);
+    void evictToBudget();
+
+    SDL_Renderer* renderer;
+    const AssetPack* pack;
+    size_t budget;
+    size_t residentBytes;
+    Uint64 useClock;
+    std::unordered_map<std::string, Entry> entries;
+    std::unordered_map<const void*, std::string> pathOf;
+};
+
+#endif // ASSET_CACHE_H
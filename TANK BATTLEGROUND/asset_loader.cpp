@@ -0,0 +1,184 @@
+#include "asset_loader.h"
+#include <SDL_image.h>
+#include <algorithm>
+#include <iostream>
+#include "texture_atlas.h"
+
+AssetLoader::AssetLoader(AssetCache& cache, JobSystem* jobs)
+    : cache(cache), jobs(jobs), nextUpload(0), completed(0) {
+    SDL_AtomicSet(&cancelled, 0);
+}
+
+AssetLoader::~AssetLoader() {
+    if (jobs) jobs->Wait(&decoding);
+    for (size_t i = nextUpload; i < items.size(); i++) discard(items[i]);
+}
+
+void AssetLoader::QueueTexture(const std::string& path) {
+    queue(ITEM_TEXTURE, path);
+}
+
+void AssetLoader::QueueChunk(const std::string& path) {
+    queue(ITEM_CHUNK, path);
+}
+
+void AssetLoader::QueueMusic(const std::string& path) {
+    queue(ITEM_MUSIC, path);
+}
+
+void AssetLoader::QueueSprites(const std::string& directory, std::initializer_list<const char*> ids) {
+    AtlasManifest manifest;
+    bool packed = TextureAtlas::ReadManifest(cache, directory, manifest);
+    if (packed) QueueTexture(directory + "/" + manifest.image);
+
+    for (const char* id : ids) {
+        bool inAtlas = packed && std::any_of(manifest.entries.begin(), manifest.entries.end(),
+                                             [id](const AtlasManifest::Entry& entry) { return entry.id == id; });
+        if (!inAtlas) QueueTexture(directory + "/" + id + ".png");
+    }
+}
+
+void AssetLoader::queue(ItemKind kind, const std::string& path) {
+    if (cache.Contains(path)) return;
+    for (const Item& item : items) {
+        if (item.path == path) return;
+    }
+
+    items.push_back(Item{kind, path, {0}, nullptr, AssetPack::FORMAT_RAW, nullptr, nullptr, 0, this});
+    if (asyncDecode()) {
+        SDL_AtomicAdd(&decoding.pending, 1);
+        jobs->Submit(decodeJob, &items.back(), 0, 1, &decoding);
+    }
+}
+
+void AssetLoader::decodeJob(void* item, int, int) {
+    Item* queued = static_cast<Item*>(item);
+    queued->loader->decode(*queued);
+}
+
+void AssetLoader::decode(Item& item) {
+    if (SDL_AtomicGet(&cancelled)) {
+        SDL_AtomicSet(&item.decoded, 1);
+        return;
+    }
+
+    switch (item.kind) {
+        case ITEM_TEXTURE: {
+            AssetPack::Blob blob;
+            const AssetPack* pack = cache.Pack();
+            if (pack && pack->Find(item.path, &blob) && blob.format != AssetPack::FORMAT_RAW) {
+                // Không cần giải mã, surface chỉ bọc pixel trong vùng map
+                item.surface = SDL_CreateRGBSurfaceWithFormatFrom(const_cast<Uint8*>(blob.data), blob.width, blob.height,
+                                                                  32, blob.pitch, SDL_PIXELFORMAT_ARGB8888);
+                item.format = blob.format;
+                break;
+            }
+
+            SDL_Surface* loaded = IMG_Load_RW(cache.OpenFile(item.path), 1);
+            if (!loaded) {
+                std::cerr << "Unable to load image " << item.path << "! SDL_image Error: " << IMG_GetError() << std::endl;
+                break;
+            }
+            // Đổi sẵn sang định dạng của texture để main thread chỉ còn chép pixel
+            item.surface = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888, 0);
+            SDL_FreeSurface(loaded);
+            if (!item.surface) {
+                std::cerr << "Unable to convert image " << item.path << "! SDL_Error: " << SDL_GetError() << std::endl;
+            }
+            break;
+        }
+        case ITEM_CHUNK:
+            item.chunk = Mix_LoadWAV_RW(cache.OpenFile(item.path), 1);
+            if (!item.chunk) {
+                std::cerr << "Failed to load sound " << item.path << "! SDL_mixer Error: " << Mix_GetError() << std::endl;
+            }
+            break;
+        case ITEM_MUSIC:
+            break;
+    }
+    SDL_AtomicSet(&item.decoded, 1);
+}
+
+bool AssetLoader::Pump(Uint32 budgetMs) {
+    Uint64 deadline = SDL_GetPerformanceCounter() + SDL_GetPerformanceFrequency() * budgetMs / 1000;
+    while (nextUpload < items.size() && !SDL_AtomicGet(&cancelled)) {
+        Item& item = items[nextUpload];
+        if (!SDL_AtomicGet(&item.decoded)) {
+            if (asyncDecode()) return false;  // Worker chưa giải mã xong, frame sau thử lại
+            decode(item);
+        }
+
+        if (upload(item, deadline)) {
+            nextUpload++;
+            completed++;
+            if (onProgress) onProgress(completed, Total());
+        }
+        if (SDL_GetPerformanceCounter() >= deadline) break;
+    }
+    return IsDone();
+}
+
+bool AssetLoader::upload(Item& item, Uint64 deadline) {
+    switch (item.kind) {
+        case ITEM_TEXTURE: {
+            if (!item.surface) return true;  // Lỗi đã được báo; Acquire sau này sẽ thử nạp lại
+            SDL_Surface* surface = item.surface;
+            if (!item.texture) {
+                item.texture = SDL_CreateTexture(cache.Renderer(), SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC,
+                                                 surface->w, surface->h);
+                if (!item.texture) {
+                    std::cerr << "Unable to create texture for " << item.path << "! SDL_Error: " << SDL_GetError() << std::endl;
+                    discard(item);
+                    return true;
+                }
+                if (!SetPackTextureBlendMode(item.texture, item.format)) {
+                    // Renderer không blend được màu nhân sẵn: chép pixel ra surface riêng rồi đổi về màu thẳng
+                    SDL_Surface* straight = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+                    if (straight) {
+                        UnpremultiplyPixels(static_cast<Uint8*>(straight->pixels), straight->w, straight->h,
+                                            straight->pitch);
+                        SDL_FreeSurface(surface);
+                        item.surface = surface = straight;
+                        item.format = AssetPack::FORMAT_PIXELS;
+                    } else {
+                        std::cerr << "Unable to copy " << item.path << "! SDL_Error: " << SDL_GetError() << std::endl;
+                    }
+                }
+            }
+
+            // Chép từng dải hàng, ảnh lớn được chia ra nhiều frame
+            while (item.uploadedRows < surface->h) {
+                int rows = surface->h - item.uploadedRows;
+                if (rows > UPLOAD_ROWS) rows = UPLOAD_ROWS;
+                SDL_Rect band = {0, item.uploadedRows, surface->w, rows};
+                const Uint8* pixels = static_cast<const Uint8*>(surface->pixels) + item.uploadedRows * surface->pitch;
+                SDL_UpdateTexture(item.texture, &band, pixels, surface->pitch);
+                item.uploadedRows += rows;
+                if (item.uploadedRows < surface->h && SDL_GetPerformanceCounter() >= deadline) return false;
+            }
+
+            cache.AdoptTexture(item.path, item.texture, static_cast<size_t>(surface->w) * surface->h * 4);
+            item.texture = nullptr;
+            SDL_FreeSurface(item.surface);
+            item.surface = nullptr;
+            return true;
+        }
+        case ITEM_CHUNK:
+            if (item.chunk) cache.AdoptChunk(item.path, item.chunk);
+            item.chunk = nullptr;
+            return true;
+        case ITEM_MUSIC:
+            cache.Release(cache.AcquireMusic(item.path));  // Giữ lại trong cache, không ai giữ tham chiếu
+            return true;
+    }
+    return true;
+}
+
+void AssetLoader::discard(Item& item) {
+    if (item.surface) SDL_FreeSurface(item.surface);
+    if (item.chunk) Mix_FreeChunk(item.chunk);
+    if (item.texture) SDL_DestroyTexture(item.texture);
+    item.surface = nullptr;
+    item.chunk = nullptr;
+    item.texture = nullptr;
+}
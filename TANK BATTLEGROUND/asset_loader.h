@@ -0,0 +1,78 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <SDL.h>
+#include <SDL_mixer.h>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include "asset_cache.h"
+#include "job_system.h"
+
+// Nạp trước tài nguyên vào AssetCache mà không làm đứng khung hình.
+// Worker giải mã PNG/WAV thành surface/chunk; main thread gọi Pump() mỗi frame để tạo texture và
+// chép pixel theo từng dải trong ngân sách thời gian cho trước. Xong thì Acquire*() của cache đều trúng.
+class AssetLoader {
+public:
+    typedef std::function<void(int done, int total)> ProgressFn;  // Gọi trên main thread mỗi khi xong một tài nguyên
+
+    AssetLoader(AssetCache& cache, JobSystem* jobs);  // jobs == nullptr hoặc không có worker: giải mã ngay trong Pump()
+    ~AssetLoader();  // Chờ job đang giải mã rồi bỏ phần chưa kịp đưa vào cache
+
+    void QueueTexture(const std::string& path);
+    void QueueChunk(const std::string& path);
+    void QueueMusic(const std::string& path);  // Nhạc được đọc dạng stream nên chỉ mở file ở main thread
+    // Sprite của một mode: atlas.png nếu đã đóng gói, cộng <directory>/<id>.png cho id không có trong atlas
+    void QueueSprites(const std::string& directory, std::initializer_list<const char*> ids);
+
+    void SetProgressCallback(const ProgressFn& callback) { onProgress = callback; }
+
+    // Bỏ nạp trước: job chưa chạy trả về ngay, Pump() không upload thêm. Tài nguyên đã vào cache vẫn được giữ.
+    void Cancel() { SDL_AtomicSet(&cancelled, 1); }
+
+    // Upload tới khi hết budgetMs (ít nhất một dải); trả về true khi mọi tài nguyên đã vào cache
+    bool Pump(Uint32 budgetMs);
+    bool IsDone() const { return completed == Total(); }
+    int Completed() const { return completed; }
+    int Total() const { return static_cast<int>(items.size()); }
+
+private:
+    static const int UPLOAD_ROWS = 64;  // Số hàng pixel mỗi lần SDL_UpdateTexture
+
+    enum ItemKind {
+        ITEM_TEXTURE,
+        ITEM_CHUNK,
+        ITEM_MUSIC
+    };
+
+    struct Item {
+        ItemKind kind;
+        std::string path;
+        SDL_atomic_t decoded;  // Worker đặt 1 sau khi đã ghi xong surface/chunk
+        SDL_Surface* surface;  // ARGB8888, giải phóng khi upload xong; ảnh giải mã sẵn trong gói thì trỏ vào vùng map
+        AssetPack::Format format;
+        Mix_Chunk* chunk;
+        SDL_Texture* texture;  // Texture đang upload dở
+        int uploadedRows;
+        AssetLoader* loader;   // Job giải mã chỉ mang con trỏ item
+    };
+
+    void queue(ItemKind kind, const std::string& path);
+    bool asyncDecode() const { return jobs && jobs->WorkerCount() > 0; }
+    static void decodeJob(void* item, int, int);
+    void decode(Item& item);
+    bool upload(Item& item, Uint64 deadline);  // true khi item đã xong (kể cả lỗi)
+    static void discard(Item& item);
+
+    AssetCache& cache;
+    JobSystem* jobs;
+    JobSystem::Counter decoding;
+    SDL_atomic_t cancelled;
+    std::deque<Item> items;  // deque để con trỏ job giữ không bị đổi khi thêm item
+    size_t nextUpload;       // Upload theo thứ tự xếp hàng
+    int completed;
+    ProgressFn onProgress;
+};
+
+#endif // ASSET_LOADER_H
@@ -0,0 +1,186 @@
+#include "asset_pack.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+const char* AssetPack::FILE_NAME = "assets.pak";
+
+AssetPack::AssetPack()
+    : data(nullptr), size(0), entries(nullptr), strings(nullptr), entryCount(0),
+      fileHandle(nullptr), mappingHandle(nullptr) {}
+
+AssetPack::~AssetPack() {
+    Close();
+}
+
+bool AssetPack::Open(const std::string& path) {
+    Close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;  // Không có gói: dùng file rời
+    LARGE_INTEGER fileSize;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        std::cerr << "Unable to map asset pack " << path << std::endl;
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int file = open(path.c_str(), O_RDONLY);
+    if (file < 0) return false;  // Không có gói: dùng file rời
+    struct stat info;
+    void* view = MAP_FAILED;
+    if (fstat(file, &info) == 0 && info.st_size > 0) {
+        view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    }
+    close(file);  // Vùng map vẫn còn sau khi đóng file
+    if (view == MAP_FAILED) {
+        std::cerr << "Unable to map asset pack " << path << std::endl;
+        return false;
+    }
+    size = static_cast<size_t>(info.st_size);
+#endif
+    data = static_cast<const Uint8*>(view);
+
+    if (!validate(path)) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool AssetPack::validate(const std::string& path) {
+    if (size < sizeof(Header)) {
+        std::cerr << "Asset pack " << path << " is truncated" << std::endl;
+        return false;
+    }
+    const Header* header = reinterpret_cast<const Header*>(data);
+    if (std::memcmp(header->magic, "TBPK", 4) != 0 || header->version != VERSION) {
+        std::cerr << "Asset pack " << path << " has an unknown format or version" << std::endl;
+        return false;
+    }
+
+    Uint64 indexEnd = sizeof(Header) + static_cast<Uint64>(header->entryCount) * sizeof(Entry) + header->stringTableSize;
+    if (indexEnd > size) {
+        std::cerr << "Asset pack " << path << " has a truncated index" << std::endl;
+        return false;
+    }
+    entries = reinterpret_cast<const Entry*>(data + sizeof(Header));
+    strings = reinterpret_cast<const char*>(entries + header->entryCount);
+    entryCount = header->entryCount;
+
+    // Kiểm tra hết một lần lúc mở để Find() không phải kiểm tra biên
+    for (Uint32 i = 0; i < entryCount; i++) {
+        const Entry& entry = entries[i];
+        bool pathOk = static_cast<Uint64>(entry.pathOffset) + entry.pathLength <= header->stringTableSize;
+        bool dataOk = entry.dataOffset <= size && entry.dataSize <= size - entry.dataOffset;
+        bool pixelsOk = entry.format == FORMAT_RAW ||
+                        (entry.format <= FORMAT_PIXELS_PREMULTIPLIED && entry.pitch >= entry.width * 4 &&
+                         static_cast<Uint64>(entry.pitch) * entry.height <= entry.dataSize);
+        if (!pathOk || !dataOk || !pixelsOk) {
+            std::cerr << "Asset pack " << path << " has a corrupt entry " << i << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void AssetPack::Close() {
+    if (!data) return;
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+    CloseHandle(static_cast<HANDLE>(mappingHandle));
+    CloseHandle(static_cast<HANDLE>(fileHandle));
+#else
+    munmap(const_cast<Uint8*>(data), size);
+#endif
+    data = nullptr;
+    size = 0;
+    entries = nullptr;
+    strings = nullptr;
+    entryCount = 0;
+    fileHandle = mappingHandle = nullptr;
+}
+
+std::string AssetPack::NormalizePath(const std::string& path) {
+    std::string normalized = path;
+    for (char& c : normalized) {
+        c = (c == '\\') ? '/' : static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return normalized;
+}
+
+bool AssetPack::Find(const std::string& path, Blob* blob) const {
+    if (!data) return false;
+    std::string key = NormalizePath(path);
+
+    // Entry đã được pack_builder sắp theo đường dẫn
+    const Entry* end = entries + entryCount;
+    const Entry* found = std::lower_bound(entries, end, key, [this](const Entry& entry, const std::string& value) {
+        return value.compare(0, std::string::npos, strings + entry.pathOffset, entry.pathLength) > 0;
+    });
+    if (found == end || key.compare(0, std::string::npos, strings + found->pathOffset, found->pathLength) != 0) {
+        return false;
+    }
+
+    blob->data = data + found->dataOffset;
+    blob->size = static_cast<size_t>(found->dataSize);
+    blob->format = static_cast<Format>(found->format);
+    blob->width = static_cast<int>(found->width);
+    blob->height = static_cast<int>(found->height);
+    blob->pitch = static_cast<int>(found->pitch);
+    return true;
+}
+
+SDL_RWops* AssetPack::OpenRW(const std::string& path) const {
+    Blob blob;
+    if (!Find(path, &blob)) return nullptr;
+    return SDL_RWFromConstMem(blob.data, static_cast<int>(blob.size));
+}
+
+bool SetPackTextureBlendMode(SDL_Texture* texture, AssetPack::Format format) {
+    if (format == AssetPack::FORMAT_PIXELS_PREMULTIPLIED) {
+        SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(
+            SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+            SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+        if (SDL_SetTextureBlendMode(texture, premultiplied) == 0) return true;
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        return false;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    return true;
+}
+
+void UnpremultiplyPixels(Uint8* pixels, int width, int height, int pitch) {
+    for (int y = 0; y < height; y++) {
+        Uint32* row = reinterpret_cast<Uint32*>(pixels + y * pitch);
+        for (int x = 0; x < width; x++) {
+            Uint32 p = row[x];
+            Uint32 a = p >> 24;
+            if (a == 0 || a == 255) continue;
+            Uint32 r = std::min<Uint32>(255, (((p >> 16) & 0xFF) * 255 + a / 2) / a);
+            Uint32 g = std::min<Uint32>(255, (((p >> 8) & 0xFF) * 255 + a / 2) / a);
+            Uint32 b = std::min<Uint32>(255, ((p & 0xFF) * 255 + a / 2) / a);
+            row[x] = (a << 24) | (r << 16) | (g << 8) | b;
+        }
+    }
+}
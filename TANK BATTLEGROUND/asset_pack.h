@@ -0,0 +1,78 @@
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <SDL.h>
+#include <string>
+
+// Gói tài nguyên một file (assets.pak, tạo bằng pack_builder), được map vào bộ nhớ khi mở.
+// Bố cục (little-endian): Header | Entry[entryCount] sắp theo đường dẫn | bảng chuỗi đường dẫn | dữ liệu.
+// Mỗi khối dữ liệu bắt đầu ở offset chia hết cho ALIGNMENT. Đường dẫn tương đối so với thư mục game,
+// dùng '/' và chữ thường để tra giống như mở file trên Windows.
+class AssetPack {
+public:
+    static const Uint32 VERSION = 1;
+    static const Uint32 ALIGNMENT = 64;
+    static const char* FILE_NAME;  // "assets.pak"
+
+    enum Format {
+        FORMAT_RAW = 0,                 // Nguyên nội dung file (PNG, WAV, MP3, TTF...)
+        FORMAT_PIXELS = 1,              // Ảnh đã giải mã sẵn, ARGB8888
+        FORMAT_PIXELS_PREMULTIPLIED = 2 // Như trên nhưng màu đã nhân sẵn alpha
+    };
+
+    struct Header {
+        char magic[4];  // "TBPK"
+        Uint32 version;
+        Uint32 entryCount;
+        Uint32 stringTableSize;
+    };
+
+    struct Entry {
+        Uint32 pathOffset;  // Trong bảng chuỗi
+        Uint32 pathLength;
+        Uint32 format;
+        Uint32 width, height, pitch;  // Chỉ dùng với FORMAT_PIXELS*
+        Uint64 dataOffset;            // Tính từ đầu file
+        Uint64 dataSize;
+    };
+
+    // Một tài nguyên trong vùng đã map; hợp lệ tới khi Close()
+    struct Blob {
+        const Uint8* data;
+        size_t size;
+        Format format;
+        int width, height, pitch;
+    };
+
+    AssetPack();
+    ~AssetPack();
+
+    bool Open(const std::string& path);  // false nếu không có file hoặc sai định dạng: game đọc file rời
+    void Close();
+    bool IsOpen() const { return data != nullptr; }
+
+    bool Find(const std::string& path, Blob* blob) const;
+    SDL_RWops* OpenRW(const std::string& path) const;  // RW chỉ đọc trên vùng đã map; nullptr nếu không có
+
+    static std::string NormalizePath(const std::string& path);
+
+private:
+    bool validate(const std::string& path);
+
+    const Uint8* data;
+    size_t size;
+    const Entry* entries;
+    const char* strings;
+    Uint32 entryCount;
+    void* fileHandle;     // Chỉ dùng trên Windows
+    void* mappingHandle;
+};
+
+// Texture tạo từ FORMAT_PIXELS_PREMULTIPLIED cần blend (ONE, ONE_MINUS_SRC_ALPHA), còn lại blend thường.
+// Trả về false nếu renderer không nhận blend đó (vd. renderer software): texture dùng blend thường,
+// người gọi phải UnpremultiplyPixels() trước khi upload để viền trong suốt không bị tối.
+bool SetPackTextureBlendMode(SDL_Texture* texture, AssetPack::Format format);
+// Đổi pixel ARGB8888 đã nhân alpha về màu thẳng, ghi đè tại chỗ
+void UnpremultiplyPixels(Uint8* pixels, int width, int height, int pitch);
+
+#endif // ASSET_PACK_H
@@ -0,0 +1,49 @@
+#include "atlas_manifest.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+const char* AtlasManifest::FILE_NAME = "atlas.txt";
+
+bool AtlasManifest::Read(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) return false;
+    return Parse(file, path);
+}
+
+bool AtlasManifest::Parse(std::istream& in, const std::string& source) {
+    std::string line, tag;
+    if (!std::getline(in, line)) return false;
+    std::istringstream header(line);
+    if (!(header >> tag >> image >> width >> height) || tag != "atlas") {
+        std::cerr << "Invalid atlas manifest header in " << source << std::endl;
+        return false;
+    }
+
+    entries.clear();
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        std::istringstream fields(line);
+        Entry entry;
+        if (!(fields >> entry.id >> entry.rect.x >> entry.rect.y >> entry.rect.w >> entry.rect.h)) {
+            std::cerr << "Invalid atlas manifest line in " << source << ": " << line << std::endl;
+            return false;
+        }
+        entries.push_back(entry);
+    }
+    return true;
+}
+
+bool AtlasManifest::Write(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Unable to write atlas manifest " << path << std::endl;
+        return false;
+    }
+    file << "atlas " << image << " " << width << " " << height << "\n";
+    for (const Entry& entry : entries) {
+        file << entry.id << " " << entry.rect.x << " " << entry.rect.y << " "
+             << entry.rect.w << " " << entry.rect.h << "\n";
+    }
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,29 @@
+#ifndef ATLAS_MANIFEST_H
+#define ATLAS_MANIFEST_H
+
+#include <SDL.h>
+#include <istream>
+#include <string>
+#include <vector>
+
+// Manifest do atlas_packer sinh ra, dạng văn bản:
+//   atlas <tên ảnh> <rộng> <cao>
+//   <id sprite> <x> <y> <w> <h>   (mỗi sprite một dòng)
+struct AtlasManifest {
+    static const char* FILE_NAME;  // "atlas.txt", nằm cạnh ảnh atlas trong thư mục của mode
+
+    struct Entry {
+        std::string id;
+        SDL_Rect rect;
+    };
+
+    std::string image;
+    int width, height;
+    std::vector<Entry> entries;
+
+    bool Read(const std::string& path);
+    bool Parse(std::istream& in, const std::string& source);  // source chỉ dùng cho thông báo lỗi
+    bool Write(const std::string& path) const;
+};
+
+#endif // ATLAS_MANIFEST_H
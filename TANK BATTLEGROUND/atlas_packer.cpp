@@ -0,0 +1,210 @@
+// Công cụ đóng gói atlas (chạy lúc build, không nằm trong game):
+//   atlas_packer <thư mục ảnh> [--max-sprite N] [--max-size N] [--skip tên]...
+// Gom mọi PNG trong thư mục (trừ các ảnh bị --skip) vào <thư mục>/atlas.png và ghi manifest atlas.txt.
+// Ảnh nguồn lớn hơn nhiều so với kích thước vẽ nên mỗi sprite được thu nhỏ về tối đa --max-sprite pixel.
+#include <SDL.h>
+#include <SDL_image.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "atlas_manifest.h"
+
+namespace {
+
+const int PADDING = 2;  // Khoảng cách giữa các sprite; 1 pixel trong đó là viền kéo dài để lọc tuyến tính không lem
+
+struct PackedSprite {
+    std::string id;
+    SDL_Surface* surface;  // RGBA32 đã thu nhỏ
+    SDL_Rect rect;         // Vị trí trong atlas, không tính padding
+};
+
+// Thu nhỏ bằng trung bình vùng, trọng số theo alpha để viền trong suốt không bị tối màu
+SDL_Surface* downscale(SDL_Surface* source, int maxEdge) {
+    int longest = std::max(source->w, source->h);
+    if (longest <= maxEdge) return SDL_ConvertSurfaceFormat(source, SDL_PIXELFORMAT_RGBA32, 0);
+
+    double scale = static_cast<double>(maxEdge) / longest;
+    int width = std::max(1, static_cast<int>(std::lround(source->w * scale)));
+    int height = std::max(1, static_cast<int>(std::lround(source->h * scale)));
+    SDL_Surface* input = SDL_ConvertSurfaceFormat(source, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_Surface* output = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!input || !output) {
+        if (input) SDL_FreeSurface(input);
+        if (output) SDL_FreeSurface(output);
+        return nullptr;
+    }
+
+    for (int y = 0; y < height; y++) {
+        int y0 = y * input->h / height;
+        int y1 = std::max(y0 + 1, (y + 1) * input->h / height);
+        Uint8* outRow = static_cast<Uint8*>(output->pixels) + y * output->pitch;
+        for (int x = 0; x < width; x++) {
+            int x0 = x * input->w / width;
+            int x1 = std::max(x0 + 1, (x + 1) * input->w / width);
+            double r = 0, g = 0, b = 0, a = 0;
+            for (int sy = y0; sy < y1; sy++) {
+                const Uint8* p = static_cast<const Uint8*>(input->pixels) + sy * input->pitch + x0 * 4;
+                for (int sx = x0; sx < x1; sx++, p += 4) {
+                    r += p[0] * p[3];
+                    g += p[1] * p[3];
+                    b += p[2] * p[3];
+                    a += p[3];
+                }
+            }
+            int count = (y1 - y0) * (x1 - x0);
+            Uint8* out = outRow + x * 4;
+            out[0] = a > 0 ? static_cast<Uint8>(r / a + 0.5) : 0;
+            out[1] = a > 0 ? static_cast<Uint8>(g / a + 0.5) : 0;
+            out[2] = a > 0 ? static_cast<Uint8>(b / a + 0.5) : 0;
+            out[3] = static_cast<Uint8>(a / count + 0.5);
+        }
+    }
+    SDL_FreeSurface(input);
+    return output;
+}
+
+// Xếp theo kệ (shelf): sprite cao trước, hết chiều ngang thì sang kệ mới. Trả về chiều cao cần dùng.
+int packShelves(std::vector<PackedSprite>& sprites, int atlasWidth) {
+    int x = PADDING, y = PADDING, shelfHeight = 0;
+    for (PackedSprite& sprite : sprites) {
+        int w = sprite.surface->w, h = sprite.surface->h;
+        if (w + 2 * PADDING > atlasWidth) return -1;
+        if (x + w + PADDING > atlasWidth) {
+            x = PADDING;
+            y += shelfHeight + PADDING;
+            shelfHeight = 0;
+        }
+        sprite.rect = {x, y, w, h};
+        x += w + PADDING;
+        shelfHeight = std::max(shelfHeight, h);
+    }
+    return y + shelfHeight + PADDING;
+}
+
+Uint32* pixelAt(SDL_Surface* surface, int x, int y) {
+    return reinterpret_cast<Uint32*>(static_cast<Uint8*>(surface->pixels) + y * surface->pitch) + x;
+}
+
+// Chép sprite vào atlas và kéo dài viền ra 1 pixel
+void copyWithExtrude(SDL_Surface* atlas, SDL_Surface* sprite, const SDL_Rect& rect) {
+    for (int y = -1; y <= rect.h; y++) {
+        int sy = std::min(std::max(y, 0), rect.h - 1);
+        for (int x = -1; x <= rect.w; x++) {
+            int sx = std::min(std::max(x, 0), rect.w - 1);
+            *pixelAt(atlas, rect.x + x, rect.y + y) = *pixelAt(sprite, sx, sy);
+        }
+    }
+}
+
+int run(const std::string& directory, int maxSprite, int maxSize, const std::vector<std::string>& skip) {
+    namespace fs = std::filesystem;
+    std::vector<PackedSprite> sprites;
+    std::vector<fs::path> files;
+    for (const fs::directory_entry& entry : fs::directory_iterator(directory)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".png") files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());  // Thứ tự ổn định để atlas giống nhau giữa các lần build
+
+    for (const fs::path& file : files) {
+        std::string id = file.stem().string();
+        if (id == "atlas" || std::find(skip.begin(), skip.end(), id) != skip.end()) continue;
+        SDL_Surface* loaded = IMG_Load(file.string().c_str());
+        if (!loaded) {
+            std::cerr << "Unable to load image " << file.string() << "! SDL_image Error: " << IMG_GetError() << std::endl;
+            return 1;
+        }
+        SDL_Surface* scaled = downscale(loaded, maxSprite);
+        SDL_FreeSurface(loaded);
+        if (!scaled) {
+            std::cerr << "Unable to scale " << file.string() << "! SDL_Error: " << SDL_GetError() << std::endl;
+            return 1;
+        }
+        sprites.push_back(PackedSprite{id, scaled, {0, 0, 0, 0}});
+    }
+    if (sprites.empty()) {
+        std::cerr << "No sprites to pack in " << directory << std::endl;
+        return 1;
+    }
+
+    std::stable_sort(sprites.begin(), sprites.end(), [](const PackedSprite& a, const PackedSprite& b) {
+        return a.surface->h > b.surface->h;
+    });
+
+    // Chọn chiều rộng lũy thừa 2 nhỏ nhất mà atlas không cao hơn rộng
+    int width = 64, height = -1;
+    for (; width <= maxSize; width *= 2) {
+        height = packShelves(sprites, width);
+        if (height > 0 && height <= width) break;
+    }
+    if (width > maxSize || height <= 0 || height > maxSize) {
+        std::cerr << "Sprites in " << directory << " do not fit in a " << maxSize << "x" << maxSize << " atlas" << std::endl;
+        return 1;
+    }
+
+    SDL_Surface* atlas = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!atlas) {
+        std::cerr << "Unable to create atlas surface! SDL_Error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+    SDL_FillRect(atlas, nullptr, 0);
+
+    AtlasManifest manifest;
+    manifest.image = "atlas.png";
+    manifest.width = width;
+    manifest.height = height;
+    for (PackedSprite& sprite : sprites) {
+        copyWithExtrude(atlas, sprite.surface, sprite.rect);
+        manifest.entries.push_back(AtlasManifest::Entry{sprite.id, sprite.rect});
+        SDL_FreeSurface(sprite.surface);
+    }
+
+    std::string imagePath = directory + "/" + manifest.image;
+    int result = IMG_SavePNG(atlas, imagePath.c_str());
+    SDL_FreeSurface(atlas);
+    if (result != 0) {
+        std::cerr << "Unable to save " << imagePath << "! SDL_image Error: " << IMG_GetError() << std::endl;
+        return 1;
+    }
+    if (!manifest.Write(directory + "/" + AtlasManifest::FILE_NAME)) return 1;
+
+    std::cout << "Packed " << manifest.entries.size() << " sprites into " << imagePath
+              << " (" << width << "x" << height << ")" << std::endl;
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: atlas_packer <image directory> [--max-sprite N] [--max-size N] [--skip name]..." << std::endl;
+        return 1;
+    }
+
+    std::string directory = argv[1];
+    int maxSprite = 256;
+    int maxSize = 4096;
+    std::vector<std::string> skip;
+    for (int i = 2; i < argc; i++) {
+        if (std::strcmp(argv[i], "--max-sprite") == 0 && i + 1 < argc) maxSprite = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--max-size") == 0 && i + 1 < argc) maxSize = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--skip") == 0 && i + 1 < argc) skip.push_back(argv[++i]);
+        else {
+            std::cerr << "Unknown option: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG)) {
+        std::cerr << "SDL_image could not initialize! SDL_image Error: " << IMG_GetError() << std::endl;
+        return 1;
+    }
+    int result = run(directory, maxSprite, maxSize, skip);
+    IMG_Quit();
+    return result;
+}
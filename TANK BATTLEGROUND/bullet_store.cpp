@@ -0,0 +1,140 @@
+#include "bullet_store.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define BULLET_STORE_SSE
+#include <xmmintrin.h>
+#endif
+
+static bool insideAny(float px, float py, const BulletBounds* bounds, int boundsCount) {
+    for (int b = 0; b < boundsCount; b++) {
+        if (px >= bounds[b].minX && px <= bounds[b].maxX && py >= bounds[b].minY && py <= bounds[b].maxY) return true;
+    }
+    return false;
+}
+
+BulletStore::BulletStore(size_t capacity) : capacity(capacity), highWater(0) {
+    x.reserve(capacity);
+    y.reserve(capacity);
+    vx.reserve(capacity);
+    vy.reserve(capacity);
+    angle.reserve(capacity);
+    chunkEnd.reserve((capacity + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK);
+}
+
+bool BulletStore::Add(float startX, float startY, float angleRad, float speed) {
+    if (x.size() >= capacity) return false;
+    x.push_back(startX);
+    y.push_back(startY);
+    vx.push_back(speed * std::cos(angleRad));
+    vy.push_back(speed * std::sin(angleRad));
+    angle.push_back(angleRad);
+    highWater = std::max(highWater, x.size());
+    return true;
+}
+
+void BulletStore::moveTo(size_t dst, size_t src, float newX, float newY) {
+    x[dst] = newX;
+    y[dst] = newY;
+    vx[dst] = vx[src];
+    vy[dst] = vy[src];
+    angle[dst] = angle[src];
+}
+
+size_t BulletStore::integrateRange(size_t begin, size_t end, const BulletBounds* bounds, int boundsCount) {
+    size_t count = end;
+    size_t kept = begin;
+    size_t i = begin;
+
+#ifdef BULLET_STORE_SSE
+    // Mỗi lượt xử lý 4 viên: cộng vận tốc, so biên ra mặt nạ 4 bit rồi dồn các viên còn sống.
+    // Cả 4 viên đã được nạp vào thanh ghi trước khi ghi, và kept <= i nên không ghi đè viên chưa đọc.
+    for (; i + 4 <= count; i += 4) {
+        __m128 px = _mm_add_ps(_mm_loadu_ps(&x[i]), _mm_loadu_ps(&vx[i]));
+        __m128 py = _mm_add_ps(_mm_loadu_ps(&y[i]), _mm_loadu_ps(&vy[i]));
+
+        __m128 inside = _mm_setzero_ps();
+        for (int b = 0; b < boundsCount; b++) {
+            __m128 inX = _mm_and_ps(_mm_cmpge_ps(px, _mm_set1_ps(bounds[b].minX)),
+                                    _mm_cmple_ps(px, _mm_set1_ps(bounds[b].maxX)));
+            __m128 inY = _mm_and_ps(_mm_cmpge_ps(py, _mm_set1_ps(bounds[b].minY)),
+                                    _mm_cmple_ps(py, _mm_set1_ps(bounds[b].maxY)));
+            inside = _mm_or_ps(inside, _mm_and_ps(inX, inY));
+        }
+        int mask = _mm_movemask_ps(inside);
+
+        if (mask == 0xF && kept == i) {
+            // Trường hợp thường gặp: chưa có viên nào bị xóa, ghi thẳng vị trí mới
+            _mm_storeu_ps(&x[i], px);
+            _mm_storeu_ps(&y[i], py);
+            kept += 4;
+            continue;
+        }
+
+        float newX[4], newY[4];
+        _mm_storeu_ps(newX, px);
+        _mm_storeu_ps(newY, py);
+        for (int lane = 0; lane < 4; lane++) {
+            if (mask & (1 << lane)) moveTo(kept++, i + lane, newX[lane], newY[lane]);
+        }
+    }
+#endif
+
+    for (; i < count; i++) {
+        float newX = x[i] + vx[i];
+        float newY = y[i] + vy[i];
+        if (insideAny(newX, newY, bounds, boundsCount)) moveTo(kept++, i, newX, newY);
+    }
+    return kept;
+}
+
+void BulletStore::IntegrateAndCull(const BulletBounds* bounds, int boundsCount, JobSystem* jobs) {
+    size_t count = x.size();
+    if (!jobs || count <= PARALLEL_CHUNK) {
+        resize(integrateRange(0, count, bounds, boundsCount));
+        return;
+    }
+
+    // Mỗi đoạn tự dồn đạn còn sống về đầu đoạn, sau đó ghép các đoạn theo thứ tự:
+    // kết quả giống hệt bản tuần tự với mọi số thread
+    int chunkCount = static_cast<int>((count + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK);
+    chunkEnd.resize(chunkCount);
+    jobs->ParallelFor(chunkCount, 1, [&](int first, int last) {
+        for (int chunk = first; chunk < last; chunk++) {
+            size_t begin = chunk * PARALLEL_CHUNK;
+            chunkEnd[chunk] = integrateRange(begin, std::min(count, begin + PARALLEL_CHUNK), bounds, boundsCount);
+        }
+    });
+
+    size_t kept = chunkEnd[0];
+    for (int chunk = 1; chunk < chunkCount; chunk++) {
+        for (size_t src = chunk * PARALLEL_CHUNK; src < chunkEnd[chunk]; src++) moveTo(kept++, src, x[src], y[src]);
+    }
+    resize(kept);
+}
+
+void BulletStore::Compact(const std::vector<bool>& dead) {
+    size_t kept = 0;
+    for (size_t i = 0; i < x.size(); i++) {
+        if (dead[i]) continue;
+        moveTo(kept++, i, x[i], y[i]);
+    }
+    resize(kept);
+}
+
+void BulletStore::resize(size_t count) {
+    x.resize(count);
+    y.resize(count);
+    vx.resize(count);
+    vy.resize(count);
+    angle.resize(count);
+}
+
+void BulletStore::Clear() {
+    x.clear();
+    y.clear();
+    vx.clear();
+    vy.clear();
+    angle.clear();
+}
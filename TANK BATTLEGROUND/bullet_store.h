@@ -0,0 +1,52 @@
+#ifndef BULLET_STORE_H
+#define BULLET_STORE_H
+
+#include <SDL.h>
+#include <vector>
+#include "job_system.h"
+
+// Hình chữ nhật (tính cả biên) mà đạn được phép bay trong đó
+struct BulletBounds {
+    float minX, minY, maxX, maxY;
+};
+
+// Lưu đạn theo dạng structure-of-arrays. Vận tốc được tính một lần lúc bắn,
+// mỗi tick chỉ còn cộng vận tốc và kiểm tra biên trong IntegrateAndCull().
+// Dung lượng cố định, cấp phát một lần lúc tạo; đạn bắn khi đầy sẽ bị bỏ qua.
+struct BulletStore {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> vx;
+    std::vector<float> vy;
+    std::vector<float> angle;  // Radian, dùng để vẽ và đoán người bắn
+
+    explicit BulletStore(size_t capacity);
+
+    size_t Size() const { return x.size(); }
+    bool Empty() const { return x.empty(); }
+    size_t Capacity() const { return capacity; }
+    size_t HighWater() const { return highWater; }  // Số đạn bay cùng lúc nhiều nhất từng có
+
+    bool Add(float startX, float startY, float angleRad, float speed);  // false nếu đầy
+
+    // Di chuyển mọi viên đạn một tick rồi xóa những viên không nằm trong vùng nào của bounds.
+    // Dùng SSE khi trình biên dịch hỗ trợ, ngược lại chạy bản vô hướng; thứ tự đạn được giữ nguyên.
+    // Có jobs thì chia thành từng đoạn PARALLEL_CHUNK viên chạy song song.
+    void IntegrateAndCull(const BulletBounds* bounds, int boundsCount, JobSystem* jobs = nullptr);
+
+    void Compact(const std::vector<bool>& dead);  // Xóa mọi viên có dead[i], giữ thứ tự
+    void Clear();
+
+private:
+    static const size_t PARALLEL_CHUNK = 4096;
+
+    size_t integrateRange(size_t begin, size_t end, const BulletBounds* bounds, int boundsCount);
+    void moveTo(size_t dst, size_t src, float newX, float newY);
+    void resize(size_t count);
+
+    size_t capacity;
+    size_t highWater;
+    std::vector<size_t> chunkEnd;  // Vị trí kết thúc phần còn sống của từng đoạn
+};
+
+#endif // BULLET_STORE_H
@@ -3,76 +3,214 @@
 Player::Player(float startX, float startY, float startAngle)
     : x(startX), y(startY), angle(startAngle), isAlive(true) {}
 
-Bullet::Bullet(float x, float y, float angle) : x(x), y(y), angle(angle) {}
-
-int Enemy::nextID = 0;
-
-Enemy::Enemy(float startX, float startY, SDL_Texture* tex, int hp)
-    : x(startX), y(startY), texture(tex), health(hp), id(nextID++) {}
-
-Enemy2::Enemy2(float startX, float startY, SDL_Texture* tex, Mix_Chunk* sound)
-    : Enemy(startX, startY, tex, ENEMY2_HEALTH) { // Truyền texture vào constructor cha
-    Mix_PlayChannel(-1, sound, 0); // Sử dụng tham số sound
+Explosion::Explosion(float x, float y, Uint32 startTick) : x(x), y(y), startTick(startTick), active(true) {}
+
+CampaignGame::Snapshot::Snapshot()
+    : simTick(0), generation(0), alpha(1.0f), publishedAt(0), player1(0, 0), player2(0, 0),
+      previousPlayer1(0, 0), previousPlayer2(0, 0), player1InvincibleUntil(0), player2InvincibleUntil(0),
+      player1Info{0, 0, Sprite{}, Sprite{}}, player2Info{0, 0, Sprite{}, Sprite{}},
+      player1BulletInfo{MAX_BULLETS, 0.0f, std::vector<bool>(MAX_BULLETS, true), Sprite{}},
+      player2BulletInfo{MAX_BULLETS, 0.0f, std::vector<bool>(MAX_BULLETS, true), Sprite{}},
+      bullets(0), enemies(0),  // Dung lượng do constructor của game đặt
+      diamondState(DIAMOND_ON_GROUND), diamondCarrier(-1), diamondX(0), diamondY(0),
+      previousDiamondX(0), previousDiamondY(0),
+      isPaused(false), showGameOverScreen(false), endGameTime(0), highScore(0), musicVolume(0), sfxVolume(0) {
+    explosions.reserve(MAX_EXPLOSIONS);
 }
 
-Boss::Boss(float startX, float startY, SDL_Texture* tex, Mix_Chunk* sound)
-    : Enemy(startX, startY, tex, BOSS_HEALTH) { // Truyền texture vào constructor cha
-    Mix_PlayChannel(-1, sound, 0); // Sử dụng tham số sound
-}
-
-Explosion::Explosion(float x, float y) : x(x), y(y), startTime(SDL_GetTicks()), active(true) {}
-
-AfterBoomMark::AfterBoomMark(float x, float y) : x(x), y(y) {}
-
-CampaignGame::CampaignGame(SDL_Renderer* rend, TTF_Font* fnt)
-    : renderer(rend), font(fnt), window(nullptr), playerTexture(nullptr), player2Texture(nullptr),
-      bulletTexture(nullptr), backgroundTexture(nullptr), enemyTexture(nullptr), boomTexture(nullptr),
-      afterBoomTexture(nullptr), enemyDeathSound(nullptr), playerDeathSound(nullptr), spawnSound(nullptr),
-      startTime(0), lastFireTime1(0), lastFireTime2(0), lastSpawnTime(0), spawnRate(5000),
-      diamondTexture(nullptr), diamondState(DIAMOND_ON_GROUND), diamondCarrierID(-1),
+CampaignGame::CampaignGame(SDL_Renderer* rend, TTF_Font* fnt, int maxEnemies, int maxBullets)
+    : running(false), headless(rend == nullptr), resourcesLoaded(false), rng(static_cast<unsigned int>(time(nullptr))),
+      renderer(rend), font(fnt), window(nullptr), playerSprite{}, player2Sprite{},
+      bulletSprite{}, backgroundTexture(nullptr), enemySprites{}, boomSprite{},
+      afterBoomSprite{}, enemyDeathSound(nullptr), playerDeathSound(nullptr), spawnSound(nullptr),
+      simTick(0), nextFireTick1(0), nextFireTick2(0), nextSpawnTick(0), spawnRate(5000),
+      diamondSprite{}, diamondState(DIAMOND_ON_GROUND), diamondCarrierID(-1),
       diamondX(SCREEN_WIDTH / 2 - DIAMOND_SIZE / 2), diamondY(SCREEN_HEIGHT / 2 - DIAMOND_SIZE / 2),
-      gameEnded(false), shieldTexture(nullptr), player1InvincibleStart(0), player2InvincibleStart(0),
-      player1IsInvincible(false), player2IsInvincible(false), enemy2Texture(nullptr),
-      portalStartTexture(nullptr), portalEndTexture(nullptr), bossTexture(nullptr), isPaused(false),
+      previousPlayer1(0, 0), previousPlayer2(0, 0), previousDiamondState(DIAMOND_ON_GROUND),
+      previousDiamondX(diamondX), previousDiamondY(diamondY), gameEnded(false), shieldSprite{}, player1InvincibleUntil(0), player2InvincibleUntil(0),
+      player1IsInvincible(false), player2IsInvincible(false),
+      portalStartSprite{}, portalEndSprite{}, isPaused(false),
       highScore(0), showGameOverScreen(false), endGameTime(0), gameOverBackgroundTexture(nullptr),
-      backgroundMusic(nullptr), pauseTexture(nullptr), menuButtonTexture(nullptr),
+      backgroundMusic(nullptr), pauseTexture(nullptr), menuButtonTexture(nullptr), restartButtonTexture(nullptr),
       musicVolume(64), sfxVolume(64),
       musicSlider{SCREEN_WIDTH / 2 - 150, SCREEN_HEIGHT / 2 - 40, 300, 30},
       sfxSlider{SCREEN_WIDTH / 2 - 150, SCREEN_HEIGHT / 2 + 40, 300, 30},
       isDraggingMusic(false), isDraggingSFX(false),
       player1(PLAY_AREA_MIN_X + PLAYER_OFFSET, SCREEN_HEIGHT / 2, 0),
       player2(PLAY_AREA_MAX_X - PLAYER_WIDTH - PLAYER_OFFSET, SCREEN_HEIGHT / 2, 180),
-      player1Info{MAX_LIVES, 0, nullptr, nullptr},
-      player2Info{MAX_LIVES, 0, nullptr, nullptr},
-      player1BulletInfo{MAX_BULLETS, 0.0f, std::vector<bool>(MAX_BULLETS, true), nullptr},
-      player2BulletInfo{MAX_BULLETS, 0.0f, std::vector<bool>(MAX_BULLETS, true), nullptr},
-      running(false) {}
+      player1Input{}, player2Input{},
+      player1Info{MAX_LIVES, 0, Sprite{}, Sprite{}},
+      player2Info{MAX_LIVES, 0, Sprite{}, Sprite{}},
+      bullets(maxBullets), enemies(maxEnemies),
+      explosions(MAX_EXPLOSIONS),
+      assets(nullptr), ownedAssets(nullptr),
+      player1BulletInfo{MAX_BULLETS, 0.0f, std::vector<bool>(MAX_BULLETS, true), Sprite{}},
+      player2BulletInfo{MAX_BULLETS, 0.0f, std::vector<bool>(MAX_BULLETS, true), Sprite{}},
+      enemyGrid(PLAY_AREA_MIN_X, PLAY_AREA_MIN_Y, PLAY_AREA_MAX_X, PLAY_AREA_MAX_Y, COLLISION_CELL_SIZE),
+      flowField(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, FLOW_CELL_SIZE, FLOW_GOAL_COUNT), jobs(nullptr),
+      generation(0), renderedGeneration(0), renderedIdle(false) {
+    // Nút về menu trong màn pause; cố định để thread mô phỏng kiểm tra click mà không cần Render()
+    menuButtonRect = {SCREEN_WIDTH / 2 - BUTTON_WIDTH / 2, sfxSlider.y + sfxSlider.h + 50, BUTTON_WIDTH, BUTTON_HEIGHT};
+
+    // Mảng tạm theo từng enemy/đạn cũng cấp phát đủ từ đầu, lúc chơi chỉ assign trong dung lượng sẵn có
+    enemyGrid.Reserve(maxEnemies);
+    enemyDead.reserve(maxEnemies);
+    separationX.reserve(maxEnemies);
+    separationY.reserve(maxEnemies);
+    bulletDead.reserve(maxBullets);
+    bulletHitCandidate.reserve(maxBullets);
+    // Mỗi bản snapshot cũng đủ chỗ cho cả pool để publishSnapshot() chỉ chép trong dung lượng sẵn có
+    for (int i = 0; i < 3; i++) {
+        snapshots.Slot(i).bullets = BulletStore(maxBullets);
+        snapshots.Slot(i).enemies = EnemyStore(maxEnemies);
+    }
+    initFlowField();
+    buildStepGraph();
+}
 
 bool CampaignGame::Initialize() {
-    // Xóa phần initSDL() và chỉ giữ lại phần load resources
-    loadResources();
+    StopSimulation();
+    // Xóa phần initSDL() và chỉ giữ lại phần load resources; vào lại mode thì không nạp lại
+    if (!headless && !resourcesLoaded) {
+        loadResources();
+        resourcesLoaded = true;
+    }
+    ResetGame();
+    if (backgroundMusic) {
+        Mix_VolumeMusic(musicVolume);
+        Mix_PlayMusic(backgroundMusic, -1);
+    }
     running = true;
-    startTime = SDL_GetTicks();
-    return true;
+    if (headless) return true;
+
+    // Từ đây trạng thái game thuộc về thread mô phỏng; Render() chỉ đọc snapshot
+    publishSnapshot();
+    return simulation.Start("CampaignSim", [this]() { return simulateFrame(); });
 }
 
-void CampaignGame::Run() {
-    while (running) {
-        if (showGameOverScreen) {
-            handleGameOverInput();
-        } else {
-            HandleInput();
-            Update();
+void CampaignGame::StopSimulation() {
+    simulation.Stop();
+}
+
+void CampaignGame::QueueEvent(const SDL_Event& event) {
+    if (event.type == SDL_RENDER_TARGETS_RESET) {
+        decals.Restore();  // Nội dung render target đã mất: in lại nền và các vết; decal thuộc về main thread
+        return;
+    }
+    InputMessage message;
+    message.event = event;
+    input.Push(message);
+}
+
+void CampaignGame::QueueKeys() {
+    input.Push(ReadPlayerKeys());
+}
+
+bool CampaignGame::simulateFrame() {
+    bool wasIdle = isPaused || showGameOverScreen;
+    bool handledEvent = false;
+    InputMessage message;
+    while (input.Pop(message)) {
+        if (message.event.type != SDL_FIRSTEVENT) {
+            handleEvent(message.event);
+            handledEvent = true;
+        } else if (!isPaused) {
+            player1Input = message.player1;
+            player2Input = message.player2;
         }
-        Render();
-        SDL_Delay(16);
     }
+    if (!showGameOverScreen) Update();
+    // Đứng yên từ trước và không có event: snapshot cũ vẫn đúng, không chép lại để main thread được nghỉ
+    if (!wasIdle || handledEvent || !(isPaused || showGameOverScreen)) publishSnapshot();
+    return running;
+}
+
+void CampaignGame::publishSnapshot() {
+    Snapshot& view = snapshots.WriteBuffer();
+    view.simTick = simTick;
+    view.generation = generation;
+    view.alpha = (isPaused || gameEnded) ? 1.0f : clock.Alpha();
+    view.publishedAt = SDL_GetPerformanceCounter();
+    view.player1 = player1;
+    view.player2 = player2;
+    view.previousPlayer1 = previousPlayer1;
+    view.previousPlayer2 = previousPlayer2;
+    view.player1InvincibleUntil = player1InvincibleUntil;
+    view.player2InvincibleUntil = player2InvincibleUntil;
+    view.player1Info = player1Info;
+    view.player2Info = player2Info;
+    view.player1BulletInfo = player1BulletInfo;
+    view.player2BulletInfo = player2BulletInfo;
+    view.bullets = bullets;
+    view.enemies = enemies;
+    view.explosions.clear();
+    explosions.ForEach([&](const Explosion& explosion) { view.explosions.push_back(explosion); });
+    view.diamondState = diamondState;
+    view.diamondCarrier = diamondState == DIAMOND_WITH_ENEMY ? enemies.IndexOf(diamondCarrierID) : -1;
+    view.diamondX = diamondX;
+    view.diamondY = diamondY;
+    bool sameHolder = previousDiamondState == diamondState;
+    view.previousDiamondX = sameHolder ? previousDiamondX : diamondX;
+    view.previousDiamondY = sameHolder ? previousDiamondY : diamondY;
+    view.isPaused = isPaused;
+    view.showGameOverScreen = showGameOverScreen;
+    view.endGameTime = endGameTime;
+    view.highScore = highScore;
+    view.musicVolume = musicVolume;
+    view.sfxVolume = sfxVolume;
+    snapshots.Publish();
+}
+
+void CampaignGame::savePreviousState() {
+    previousPlayer1 = player1;
+    previousPlayer2 = player2;
+    previousDiamondState = diamondState;
+    previousDiamondX = diamondX;
+    previousDiamondY = diamondY;
+    enemies.SavePrevious();
+}
+
+void CampaignGame::ResetGame() {
+    showGameOverScreen = false;
+    gameEnded = false;
+    isPaused = false;
+    isDraggingMusic = false;
+    isDraggingSFX = false;
+    player1 = Player(PLAY_AREA_MIN_X + PLAYER_OFFSET, SCREEN_HEIGHT / 2, 0);
+    player2 = Player(PLAY_AREA_MAX_X - PLAYER_WIDTH - PLAYER_OFFSET, SCREEN_HEIGHT / 2, 180);
+    player1Input = PlayerInput{};
+    player2Input = PlayerInput{};
+    player1Info = {MAX_LIVES, 0, player1Info.avatar, player1Info.heartSprite};
+    player2Info = {MAX_LIVES, 0, player2Info.avatar, player2Info.heartSprite};
+    player1BulletInfo.Refill();
+    player2BulletInfo.Refill();
+    // Các pool giữ nguyên bộ nhớ, chơi lại không cấp phát
+    bullets.Clear();
+    enemies.Clear();
+    explosions.Clear();
+    pendingSounds.clear();
+    generation++;  // Decal thuộc main thread: Render() xóa khi thấy generation đổi; vết mới mang generation này
+    diamondState = DIAMOND_ON_GROUND;
+    diamondCarrierID = -1;
+    diamondX = SCREEN_WIDTH / 2 - DIAMOND_SIZE / 2;
+    diamondY = SCREEN_HEIGHT / 2 - DIAMOND_SIZE / 2;
+    simTick = 0;
+    nextSpawnTick = 0;
+    nextFireTick1 = 0;
+    nextFireTick2 = 0;
+    spawnRate = 5000;
+    player1IsInvincible = false;
+    player2IsInvincible = false;
+    player1InvincibleUntil = 0;
+    player2InvincibleUntil = 0;
+    endGameTime = 0;
+    savePreviousState();
+    clock.Reset();
 }
 
 void CampaignGame::Cleanup() {
+    StopSimulation();
     closeSDL();
-    SDL_DestroyTexture(restartButtonTexture);
-    SDL_DestroyTexture(menuButtonTexture);
 }
 
 CampaignGame::~CampaignGame() {
@@ -101,56 +239,75 @@ bool CampaignGame::initSDL() {
 }
 
 SDL_Texture* CampaignGame::loadTexture(const char* path) {
-    SDL_Texture* newTexture = nullptr;
-    SDL_Surface* loadedSurface = IMG_Load(path);
-    if (!loadedSurface) {
-        std::cerr << "Unable to load image " << path << "! SDL_image Error: " << IMG_GetError() << std::endl;
-        return nullptr;
-    }
-    newTexture = SDL_CreateTextureFromSurface(renderer, loadedSurface);
-    SDL_FreeSurface(loadedSurface);
-    return newTexture;
+    return assets->AcquireTexture(path);
+}
+
+Sprite CampaignGame::loadSprite(const char* id) {
+    Sprite sprite;
+    if (atlas.Find(id, &sprite)) return sprite;
+    std::string path = std::string("images/CampaignMode/") + id + ".png";
+    return MakeSprite(loadTexture(path.c_str()));
+}
+
+void CampaignGame::destroySprite(Sprite& sprite) {
+    // Sprite trong atlas không giữ tham chiếu riêng, atlas trả texture khi Destroy()
+    if (!atlas.Owns(sprite.texture)) releaseAsset(sprite.texture);
+    sprite.texture = nullptr;
+}
+
+void CampaignGame::QueueAssets(AssetLoader& loader) {
+    loader.QueueSprites("images/CampaignMode", {
+        "player1", "player2", "bullet", "enemy", "boom", "afterboom", "bullet_icon", "diamond", "shield",
+        "enemy2", "portal_start", "portal_end", "boss", "player1_avatar", "player2_avatar", "heart"});
+    loader.QueueTexture("images/CampaignMode/background.png");
+    loader.QueueTexture("images/CampaignMode/gameover_background.png");
+    loader.QueueTexture("images/CampaignMode/pause.png");
+    loader.QueueTexture("images/CampaignMode/menu_button.png");
+    loader.QueueTexture("images/CampaignMode/restart_button.png");
+    loader.QueueChunk("audio/enemydeath.wav");
+    loader.QueueChunk("audio/playerdeath.wav");
+    loader.QueueChunk("audio/spawn.wav");
+    loader.QueueMusic("audio/CampaignMode.mp3");
 }
 
 void CampaignGame::loadResources() {
-    playerTexture = loadTexture("images/CampaignMode/player1.png");
-    player2Texture = loadTexture("images/CampaignMode/player2.png");
-    bulletTexture = loadTexture("images/CampaignMode/bullet.png");
+    if (!assets) assets = ownedAssets = new AssetCache(renderer);
+
+    // Sprite nhỏ lấy từ atlas nếu đã đóng gói (atlas_packer), không thì nạp ảnh rời
+    atlas.Load(*assets, "images/CampaignMode");
+    playerSprite = loadSprite("player1");
+    player2Sprite = loadSprite("player2");
+    bulletSprite = loadSprite("bullet");
     backgroundTexture = loadTexture("images/CampaignMode/background.png");
-    enemyTexture = loadTexture("images/CampaignMode/enemy.png");
-    boomTexture = loadTexture("images/CampaignMode/boom.png");
-    afterBoomTexture = loadTexture("images/CampaignMode/afterboom.png");
-    player1BulletInfo.bulletIcon = loadTexture("images/CampaignMode/bullet_icon.png");
-    player2BulletInfo.bulletIcon = player1BulletInfo.bulletIcon;
-    diamondTexture = loadTexture("images/CampaignMode/diamond.png");
-    shieldTexture = loadTexture("images/CampaignMode/shield.png");
-    enemy2Texture = loadTexture("images/CampaignMode/enemy2.png");
-    portalStartTexture = loadTexture("images/CampaignMode/portal_start.png");
-    portalEndTexture = loadTexture("images/CampaignMode/portal_end.png");
-    bossTexture = loadTexture("images/CampaignMode/boss.png");
+    enemySprites[ENEMY_BASIC] = loadSprite("enemy");
+    boomSprite = loadSprite("boom");
+    afterBoomSprite = loadSprite("afterboom");
+    decals.Create(renderer, backgroundTexture, SCREEN_WIDTH, SCREEN_HEIGHT);
+    textRenderer.Create(renderer, font);
+    sprites.SetRenderer(renderer);
+    player1BulletInfo.bulletIcon = loadSprite("bullet_icon");
+    player2BulletInfo.bulletIcon = loadSprite("bullet_icon");
+    diamondSprite = loadSprite("diamond");
+    shieldSprite = loadSprite("shield");
+    enemySprites[ENEMY_TYPE2] = loadSprite("enemy2");
+    portalStartSprite = loadSprite("portal_start");
+    portalEndSprite = loadSprite("portal_end");
+    enemySprites[ENEMY_BOSS] = loadSprite("boss");
     gameOverBackgroundTexture = loadTexture("images/CampaignMode/gameover_background.png");
     pauseTexture = loadTexture("images/CampaignMode/pause.png");
     menuButtonTexture = loadTexture("images/CampaignMode/menu_button.png");
     restartButtonTexture = loadTexture("images/CampaignMode/restart_button.png");
-    menuButtonTexture = loadTexture("images/CampaignMode/menu_button.png");
 
-    player1Info.avatar = loadTexture("images/CampaignMode/player1_avatar.png");
-    player2Info.avatar = loadTexture("images/CampaignMode/player2_avatar.png");
-    player1Info.heartTexture = loadTexture("images/CampaignMode/heart.png");
-    player2Info.heartTexture = player1Info.heartTexture;
+    player1Info.avatar = loadSprite("player1_avatar");
+    player2Info.avatar = loadSprite("player2_avatar");
+    player1Info.heartSprite = loadSprite("heart");
+    player2Info.heartSprite = loadSprite("heart");
 
-    enemyDeathSound = Mix_LoadWAV("audio/enemydeath.wav");
-    playerDeathSound = Mix_LoadWAV("audio/playerdeath.wav");
-    spawnSound = Mix_LoadWAV("audio/spawn.wav");
+    enemyDeathSound = assets->AcquireChunk("audio/enemydeath.wav");
+    playerDeathSound = assets->AcquireChunk("audio/playerdeath.wav");
+    spawnSound = assets->AcquireChunk("audio/spawn.wav");
 
-backgroundMusic = Mix_LoadMUS("audio/CampaignMode.mp3");
-    if (!backgroundMusic) {
-        std::cerr << "Failed to load background music! SDL_mixer Error: " << Mix_GetError() << std::endl;
-    } else {
-        Mix_VolumeMusic(musicVolume);
-        Mix_PlayMusic(backgroundMusic, -1);
-        std::cout << "Background music loaded and playing, volume: " << musicVolume << std::endl;
-    }
+    backgroundMusic = assets->AcquireMusic("audio/CampaignMode.mp3");  // Initialize() bật nhạc mỗi lần vào mode
 
     Mix_VolumeChunk(enemyDeathSound, sfxVolume);
     Mix_VolumeChunk(playerDeathSound, sfxVolume);
@@ -158,35 +315,43 @@ backgroundMusic = Mix_LoadMUS("audio/CampaignMode.mp3");
 }
 
 void CampaignGame::closeSDL() {
-    SDL_DestroyTexture(playerTexture);
-    SDL_DestroyTexture(player2Texture);
-    SDL_DestroyTexture(bulletTexture);
-    SDL_DestroyTexture(backgroundTexture);
-    SDL_DestroyTexture(enemyTexture);
-    SDL_DestroyTexture(boomTexture);
-    SDL_DestroyTexture(afterBoomTexture);
-    SDL_DestroyTexture(player1Info.avatar);
-    SDL_DestroyTexture(player2Info.avatar);
-    SDL_DestroyTexture(player1Info.heartTexture);
-    SDL_DestroyTexture(player1BulletInfo.bulletIcon);
-    SDL_DestroyTexture(diamondTexture);
-    SDL_DestroyTexture(shieldTexture);
-    SDL_DestroyTexture(enemy2Texture);
-    SDL_DestroyTexture(portalStartTexture);
-    SDL_DestroyTexture(portalEndTexture);
-    SDL_DestroyTexture(bossTexture);
-    SDL_DestroyTexture(gameOverBackgroundTexture);
-    SDL_DestroyTexture(pauseTexture);
-    SDL_DestroyTexture(menuButtonTexture);
-
-    Mix_FreeChunk(enemyDeathSound);
-    Mix_FreeChunk(playerDeathSound);
-    Mix_FreeChunk(spawnSound);
-    Mix_FreeMusic(backgroundMusic);
-
-    SDL_DestroyWindow(window);
-    Mix_Quit();
-    SDL_Quit();
+    destroySprite(playerSprite);
+    destroySprite(player2Sprite);
+    destroySprite(bulletSprite);
+    releaseAsset(backgroundTexture);
+    destroySprite(enemySprites[ENEMY_BASIC]);
+    destroySprite(boomSprite);
+    destroySprite(afterBoomSprite);
+    decals.Destroy();
+    textRenderer.Destroy();
+    destroySprite(player1Info.avatar);
+    destroySprite(player2Info.avatar);
+    destroySprite(player1Info.heartSprite);
+    destroySprite(player2Info.heartSprite);
+    destroySprite(player1BulletInfo.bulletIcon);
+    destroySprite(player2BulletInfo.bulletIcon);
+    destroySprite(diamondSprite);
+    destroySprite(shieldSprite);
+    destroySprite(enemySprites[ENEMY_TYPE2]);
+    destroySprite(portalStartSprite);
+    destroySprite(portalEndSprite);
+    destroySprite(enemySprites[ENEMY_BOSS]);
+    atlas.Destroy();
+    releaseAsset(gameOverBackgroundTexture);
+    releaseAsset(pauseTexture);
+    releaseAsset(menuButtonTexture);
+    releaseAsset(restartButtonTexture);
+
+    if (backgroundMusic && Mix_PlayingMusic()) Mix_HaltMusic();  // Nhạc vẫn nằm trong cache nên phải tự dừng
+    releaseAsset(enemyDeathSound);
+    releaseAsset(playerDeathSound);
+    releaseAsset(spawnSound);
+    releaseAsset(backgroundMusic);
+    if (assets == ownedAssets) assets = nullptr;
+    delete ownedAssets;
+    ownedAssets = nullptr;
+    resourcesLoaded = false;
+    // SDL, cửa sổ và audio thuộc về Game; game mode chỉ trả tài nguyên của mình
 }
 
 bool CampaignGame::isAtPortalCenter(float x, float y) {
@@ -196,152 +361,216 @@ bool CampaignGame::isAtPortalCenter(float x, float y) {
     return distance < 10.0f;
 }
 
-bool CampaignGame::isPathClear(float x1, float y1, float x2, float y2) {
-    bool startInHallway = (x1 >= HALLWAY_X_START && x1 <= HALLWAY_X_END - ENEMY_SIZE);
-    bool endInHallway = (x2 >= HALLWAY_X_START && x2 <= HALLWAY_X_END - ENEMY_SIZE);
-    bool startInGate = (x1 >= GATE_X_START && x1 <= GATE_X_END - ENEMY_SIZE);
-    bool endInGate = (x2 >= GATE_X_START && x2 <= GATE_X_END - ENEMY_SIZE);
+void CampaignGame::initFlowField() {
+    // Enemy đi được trong sân và trong cột cổng/hành lang nối ra mép màn hình
+    for (int row = 0; row < flowField.Rows(); row++) {
+        for (int col = 0; col < flowField.Cols(); col++) {
+            float x = flowField.CellCenterX(col);
+            float y = flowField.CellCenterY(row);
+            bool inPlayArea = (x >= PLAY_AREA_MIN_X && x <= PLAY_AREA_MAX_X && y >= PLAY_AREA_MIN_Y && y <= PLAY_AREA_MAX_Y);
+            bool inGate = (x >= GATE_X_START && x <= GATE_X_END);
+            bool inHallway = (x >= HALLWAY_X_START && x <= HALLWAY_X_END);
+            flowField.SetWalkable(col, row, inPlayArea || inGate || inHallway);
+        }
+    }
+    flowField.SetGoal(FLOW_GOAL_EXIT, SCREEN_WIDTH / 2, PLAY_AREA_MAX_Y);
+}
 
-    if ((startInHallway && endInHallway) || (startInGate && endInGate)) return true;
-    if ((y1 < PLAY_AREA_MIN_Y || y1 > PLAY_AREA_MAX_Y - ENEMY_SIZE) &&
-        (y2 < PLAY_AREA_MIN_Y || y2 > PLAY_AREA_MAX_Y - ENEMY_SIZE)) return false;
-    return true;
+void CampaignGame::buildStepGraph() {
+    // Thứ tự thêm trùng thứ tự chạy tuần tự; phụ thuộc theo dữ liệu mỗi pha đọc/ghi
+    int players = stepGraph.Add("players", [this]() { updatePlayers(); });
+    int reload = stepGraph.Add("reload", [this]() { updateBulletSystem(SIM_TICK_MS); }, {players});
+    int steer = stepGraph.Add("enemies", [this]() { updateEnemies(); }, {players});
+    int separate = stepGraph.Add("separate", [this]() { separateEnemies(); }, {steer});
+    int diamond = stepGraph.Add("diamond", [this]() { updateDiamond(); }, {separate});
+    int bulletHits = stepGraph.Add("bulletHits", [this]() { checkBulletCollisions(); }, {separate, diamond});
+    int enemyPlayer = stepGraph.Add("enemyPlayer", [this]() { checkEnemyPlayerCollision(); }, {bulletHits});
+    int explosionAge = stepGraph.Add("explosions", [this]() { updateExplosions(); }, {enemyPlayer});
+    int spawn = stepGraph.Add("spawn", [this]() { spawnEnemy(); }, {enemyPlayer});
+    int bulletMove = stepGraph.Add("bullets", [this]() { updateBullets(); }, {bulletHits});
+    stepGraph.Add("gameOver", [this]() { isGameOver(); }, {reload, explosionAge, spawn, bulletMove});
+}
+
+FlowGoal CampaignGame::selectEnemyGoal(float& goalX, float& goalY) {
+    switch (diamondState) {
+        case DIAMOND_WITH_PLAYER1:
+            goalX = player1.x + PLAYER_WIDTH / 2;
+            goalY = player1.y + PLAYER_HEIGHT / 2;
+            flowField.SetGoal(FLOW_GOAL_PLAYER1, goalX, goalY);
+            return FLOW_GOAL_PLAYER1;
+        case DIAMOND_WITH_PLAYER2:
+            goalX = player2.x + PLAYER_WIDTH / 2;
+            goalY = player2.y + PLAYER_HEIGHT / 2;
+            flowField.SetGoal(FLOW_GOAL_PLAYER2, goalX, goalY);
+            return FLOW_GOAL_PLAYER2;
+        case DIAMOND_ON_GROUND:
+            goalX = diamondX + DIAMOND_SIZE / 2;
+            goalY = diamondY + DIAMOND_SIZE / 2;
+            flowField.SetGoal(FLOW_GOAL_DIAMOND, goalX, goalY);
+            return FLOW_GOAL_DIAMOND;
+        case DIAMOND_WITH_ENEMY:
+            break;
+    }
+    // Kim cương đã bị cướp: các enemy khác hộ tống về phía lối ra
+    goalX = SCREEN_WIDTH / 2;
+    goalY = PLAY_AREA_MAX_Y;
+    return FLOW_GOAL_EXIT;
+}
+
+void CampaignGame::steerEnemy(size_t index, FlowGoal goal, float goalX, float goalY, float speed) {
+    float size = ENEMY_ARCHETYPES[enemies.type[index]].size;
+    float centerX = enemies.x[index] + size / 2;
+    float centerY = enemies.y[index] + size / 2;
+
+    float dirX, dirY;
+    if (!flowField.GetDirection(goal, centerX, centerY, dirX, dirY)) {
+        // Đã ở ô đích: đi thẳng tới goal, không vượt quá
+        float dx = goalX - centerX;
+        float dy = goalY - centerY;
+        float distance = std::sqrt(dx * dx + dy * dy);
+        if (distance <= 0) return;
+        float step = std::min(speed, distance);
+        dirX = dx / distance * step / speed;
+        dirY = dy / distance * step / speed;
+    }
+    enemies.x[index] += dirX * speed;
+    enemies.y[index] += dirY * speed;
 }
 
 bool CampaignGame::isSpawnPointClear() {
     float spawnX = SCREEN_WIDTH / 2 - ENEMY_SIZE / 2;
     float spawnY = -ENEMY_SIZE;
-    for (const auto& e : enemies) {
-        if (abs(e->x - spawnX) < ENEMY_SIZE * 1.5f && abs(e->y - spawnY) < ENEMY_SIZE * 1.5f) return false;
+    for (size_t i = 0; i < enemies.Size(); i++) {
+        if (std::abs(enemies.x[i] - spawnX) < ENEMY_SIZE * 1.5f && std::abs(enemies.y[i] - spawnY) < ENEMY_SIZE * 1.5f) return false;
     }
     return true;
 }
 
 void CampaignGame::spawnEnemy() {
-    Uint32 currentTime = SDL_GetTicks();
-    if (currentTime - lastSpawnTime >= spawnRate && isSpawnPointClear()) {
+    if (simTick >= nextSpawnTick && !enemies.Full() && isSpawnPointClear()) {
         float spawnX = PORTAL_START_X + PORTAL_SIZE / 2 - ENEMY_SIZE / 2;
         float spawnY = PORTAL_START_Y + PORTAL_SIZE / 2;
-        Uint32 timeElapsed = currentTime - startTime;
-        int bossCount = std::count_if(enemies.begin(), enemies.end(),
-                                      [](const auto& e) { return dynamic_cast<Boss*>(e.get()) != nullptr; });
-
-        if (timeElapsed > BOSS_SPAWN_TIME && rand() % 100 < 10 && bossCount < 1) {
-            enemies.push_back(std::make_unique<Boss>(spawnX, spawnY, bossTexture, spawnSound)); // Truyền spawnSound
-        } else if (timeElapsed > 30000 && rand() % 100 < 30) {
-            enemies.push_back(std::make_unique<Enemy2>(spawnX, spawnY, enemy2Texture, spawnSound)); // Truyền spawnSound
-        } else {
-            enemies.push_back(std::make_unique<Enemy>(spawnX, spawnY, enemyTexture));
+        Uint32 timeElapsed = TicksToMs(simTick);
+        int bossCount = std::count(enemies.type.begin(), enemies.type.end(), ENEMY_BOSS);
+
+        EnemyType type = ENEMY_BASIC;
+        if (timeElapsed > BOSS_SPAWN_TIME && rng() % 100 < 10 && bossCount < 1) {
+            type = ENEMY_BOSS;
+        } else if (timeElapsed > 30000 && rng() % 100 < 30) {
+            type = ENEMY_TYPE2;
         }
+        enemies.Add(spawnX, spawnY, type, ENEMY_ARCHETYPES[type].textureSlot, ENEMY_ARCHETYPES[type].health);
 
-        lastSpawnTime = currentTime;
-        Mix_PlayChannel(-1, spawnSound, 0); // Giữ nguyên âm thanh phát ở đây nếu muốn
+        nextSpawnTick = simTick + MsToTicks(spawnRate);
+        queueSound(SOUND_SPAWN);
     }
 }
 
 void CampaignGame::updateEnemies() {
-    for (auto& enemy : enemies) {
-        float enemySize = (dynamic_cast<Boss*>(enemy.get()) ? BOSS_SIZE : ENEMY_SIZE);
-        if (enemy->y < 0) {
-            enemy->y += ENEMY_SPAWN_SPEED;
-            continue;
-        }
-
-        // Thêm điều kiện kiểm tra nếu kim cương đang ở trên đất
-        if (diamondState == DIAMOND_ON_GROUND) {
-            checkEnemyDiamondCollision(enemy.get());
-        }
-
-        if (diamondState == DIAMOND_WITH_ENEMY && enemy->id == diamondCarrierID) {
-            float currentSpeed = ENEMY_BOOSTED_SPEED;
-            float targetX = SCREEN_WIDTH / 2;
-            float targetY = PLAY_AREA_MAX_Y;
-            float dx = targetX - (enemy->x + enemySize / 2);
-            float dy = targetY - (enemy->y + enemySize / 2);
-            float distance = std::sqrt(dx * dx + dy * dy);
-
-            if (distance > 0) {
-                float newX = enemy->x + (dx / distance) * currentSpeed;
-                float newY = enemy->y + (dy / distance) * currentSpeed;
-                if (isPathClear(enemy->x, enemy->y, newX, newY)) {
-                    enemy->x = newX;
-                    enemy->y = newY;
-                } else {
-                    if (enemy->y + enemySize < PLAY_AREA_MAX_Y && isPathClear(enemy->x, enemy->y, enemy->x, enemy->y + currentSpeed)) {
-                        enemy->y += currentSpeed;
-                    } else if (dx > 0 && enemy->x < PLAY_AREA_MAX_X - enemySize && isPathClear(enemy->x, enemy->y, enemy->x + currentSpeed, enemy->y)) {
-                        enemy->x += currentSpeed;
-                    } else if (dx < 0 && enemy->x > PLAY_AREA_MIN_X && isPathClear(enemy->x, enemy->y, enemy->x - currentSpeed, enemy->y)) {
-                        enemy->x -= currentSpeed;
-                    }
-                }
+    // Nhặt kim cương và enemy mang kim cương đổi trạng thái chung nên xét tuần tự trước.
+    // Enemy đứng trước enemy nhặt được kim cương vẫn đuổi theo kim cương như khi duyệt lần lượt.
+    size_t count = enemies.Size();
+    float goalX, goalY;
+    FlowGoal goal = selectEnemyGoal(goalX, goalY);
+
+    size_t pickupIndex = count;
+    if (diamondState == DIAMOND_ON_GROUND) {
+        for (size_t i = 0; i < count; i++) {
+            if (enemies.y[i] >= 0 && checkEnemyDiamondCollision(i)) {
+                pickupIndex = i;
+                break;
             }
+        }
+    }
 
-            if (enemy->y + enemySize >= PLAY_AREA_MAX_Y) {
+    size_t carrierIndex = count;
+    size_t end = count;
+    if (diamondState == DIAMOND_WITH_ENEMY) {
+        int index = enemies.IndexOf(diamondCarrierID);
+        if (index != -1 && enemies.y[index] >= 0) {
+            carrierIndex = index;
+            float size = ENEMY_ARCHETYPES[enemies.type[carrierIndex]].size;
+            steerEnemy(carrierIndex, FLOW_GOAL_EXIT, SCREEN_WIDTH / 2, PLAY_AREA_MAX_Y, ENEMY_BOOSTED_SPEED);
+
+            if (enemies.y[carrierIndex] + size >= PLAY_AREA_MAX_Y) {
+                // Kim cương đã ra tới lối ra: các enemy sau carrier không di chuyển nữa
                 gameEnded = true;
-                return;
+                end = carrierIndex;
             }
-
-            diamondX = enemy->x + enemySize / 2 - DIAMOND_SIZE / 2;
-            diamondY = enemy->y + enemySize / 2 - DIAMOND_SIZE / 2;
-            continue;
         }
+    }
 
-        if (dynamic_cast<Enemy2*>(enemy.get())) {
-            for (auto& other : enemies) {
-                if (other.get() != enemy.get()) {
-                    float dx = enemy->x - other->x;
-                    float dy = enemy->y - other->y;
-                    float dist = sqrt(dx * dx + dy * dy);
-                    if (dist < ENEMY_SIZE * 1.5f) {
-                        other->x += dx * 0.05f;
-                        other->y += dy * 0.05f;
-                    }
-                }
+    // Mỗi enemy chỉ ghi vị trí của chính nó, flow field chỉ được đọc: chia đều cho các worker
+    ParallelFor(jobs, static_cast<int>(end), JOB_GRAIN_SIZE, [&](int begin, int last) {
+        for (int i = begin; i < last; i++) {
+            if (static_cast<size_t>(i) == carrierIndex) continue;
+            const EnemyArchetype& archetype = ENEMY_ARCHETYPES[enemies.type[i]];
+            float size = archetype.size;
+            if (enemies.y[i] < 0) {
+                enemies.y[i] += ENEMY_SPAWN_SPEED;
+                continue;
             }
-        }
 
-        float targetX, targetY;
-        if (diamondState == DIAMOND_WITH_PLAYER1) {
-            targetX = player1.x;
-            targetY = player1.y;
-        } else if (diamondState == DIAMOND_WITH_PLAYER2) {
-            targetX = player2.x;
-            targetY = player2.y;
-        } else if (diamondState == DIAMOND_ON_GROUND) {
-            targetX = diamondX + DIAMOND_SIZE / 2;
-            targetY = diamondY + DIAMOND_SIZE / 2;
-        } else {
-            targetX = enemy->x;
-            targetY = enemy->y + enemy->getSpeed();
-        }
-
-        float currentSpeed = enemy->getSpeed();
-        float dx = targetX - enemy->x;
-        float dy = targetY - enemy->y;
-        float distance = std::sqrt(dx * dx + dy * dy);
-
-        if (distance > 0) {
-            float newX = enemy->x + (dx / distance) * currentSpeed;
-            float newY = enemy->y + (dy / distance) * currentSpeed;
-            if (isPathClear(enemy->x, enemy->y, newX, newY)) {
-                enemy->x = newX;
-                enemy->y = newY;
+            if (static_cast<size_t>(i) < pickupIndex) {
+                steerEnemy(i, goal, goalX, goalY, archetype.speed);
             } else {
-                if (isPathClear(enemy->x, enemy->y, enemy->x + currentSpeed, enemy->y)) {
-                    enemy->x += (dx > 0) ? currentSpeed : -currentSpeed;
-                } else if (isPathClear(enemy->x, enemy->y, enemy->x, enemy->y + currentSpeed)) {
-                    enemy->y += (dy > 0) ? currentSpeed : -currentSpeed;
-                } else {
-                    enemy->x += (rand() % 3 - 1) * currentSpeed / 2;
-                    enemy->y += (rand() % 3 - 1) * currentSpeed / 2;
-                }
+                steerEnemy(i, FLOW_GOAL_EXIT, SCREEN_WIDTH / 2, PLAY_AREA_MAX_Y, archetype.speed);
             }
+
+            enemies.x[i] = std::max(float(PLAY_AREA_MIN_X), std::min(float(PLAY_AREA_MAX_X - size), enemies.x[i]));
+            enemies.y[i] = std::max(float(PLAY_AREA_MIN_Y), std::min(float(PLAY_AREA_MAX_Y - size), enemies.y[i]));
         }
+    });
+}
 
-        enemy->x = std::max(float(PLAY_AREA_MIN_X), std::min(float(PLAY_AREA_MAX_X - enemySize), enemy->x));
-        enemy->y = std::max(float(PLAY_AREA_MIN_Y), std::min(float(PLAY_AREA_MAX_Y - enemySize), enemy->y));
+void CampaignGame::separateEnemies() {
+    // Mỗi enemy cộng dồn lực đẩy từ tối đa MAX_SEPARATION_NEIGHBOURS enemy lân cận (tìm qua lưới),
+    // sau đó mới dịch chuyển tất cả: kết quả không phụ thuộc thứ tự duyệt
+    size_t count = enemies.Size();
+    separationX.assign(count, 0.0f);
+    separationY.assign(count, 0.0f);
+
+    enemyGrid.Begin();
+    for (size_t i = 0; i < count; i++) {
+        if (enemies.y[i] < 0) continue;  // Đang đi ra từ cổng
+        float size = ENEMY_ARCHETYPES[enemies.type[i]].size;
+        enemyGrid.Insert(i, enemies.x[i] + size / 2, enemies.y[i] + size / 2);
     }
+    enemyGrid.Finish();
+
+    // Mỗi enemy chỉ ghi vào ô separation của chính nó nên hai vòng dưới chia được cho các worker
+    ParallelFor(jobs, static_cast<int>(count), JOB_GRAIN_SIZE, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            if (enemies.y[i] < 0) continue;
+            float size = ENEMY_ARCHETYPES[enemies.type[i]].size;
+            float centerX = enemies.x[i] + size / 2;
+            float centerY = enemies.y[i] + size / 2;
+            float queryRadius = (size + MaxEnemyArchetypeSize()) / 2 * ENEMY_SEPARATION_RANGE;
+            int neighbours = 0;
+
+            enemyGrid.ForEachNear(centerX, centerY, queryRadius, [&](int j) {
+                if (j == i || neighbours >= MAX_SEPARATION_NEIGHBOURS) return;
+                const EnemyArchetype& other = ENEMY_ARCHETYPES[enemies.type[j]];
+                float dx = centerX - (enemies.x[j] + other.size / 2);
+                float dy = centerY - (enemies.y[j] + other.size / 2);
+                float range = (size + other.size) / 2 * ENEMY_SEPARATION_RANGE;
+                if (dx * dx + dy * dy < range * range) {
+                    separationX[i] += dx * other.separationStrength;
+                    separationY[i] += dy * other.separationStrength;
+                    neighbours++;
+                }
+            });
+        }
+    });
+
+    ParallelFor(jobs, static_cast<int>(count), JOB_GRAIN_SIZE, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            if (enemies.y[i] < 0) continue;
+            float size = ENEMY_ARCHETYPES[enemies.type[i]].size;
+            enemies.x[i] = std::max(float(PLAY_AREA_MIN_X), std::min(float(PLAY_AREA_MAX_X - size), enemies.x[i] + separationX[i]));
+            enemies.y[i] = std::max(float(PLAY_AREA_MIN_Y), std::min(float(PLAY_AREA_MAX_Y - size), enemies.y[i] + separationY[i]));
+        }
+    });
 }
 
 void CampaignGame::checkDiamondCollision(float x, float y, int width, int height) {
@@ -357,16 +586,17 @@ void CampaignGame::checkDiamondCollision(float x, float y, int width, int height
     if (!(objRight < diamondLeft || objLeft > diamondRight || objBottom < diamondTop || objTop > diamondBottom)) {
         if (x == player1.x && y == player1.y) diamondState = DIAMOND_WITH_PLAYER1;
         else if (x == player2.x && y == player2.y) diamondState = DIAMOND_WITH_PLAYER2;
-        Mix_PlayChannel(-1, spawnSound, 0);
+        queueSound(SOUND_SPAWN);
     }
 }
 
-void CampaignGame::checkEnemyDiamondCollision(Enemy* enemy) {
-    if (diamondState != DIAMOND_ON_GROUND) return;
+bool CampaignGame::checkEnemyDiamondCollision(size_t index) {
+    if (diamondState != DIAMOND_ON_GROUND) return false;
 
-    float enemySize = (dynamic_cast<Boss*>(enemy) ? BOSS_SIZE : ENEMY_SIZE);
-    float enemyCenterX = enemy->x + enemySize / 2;
-    float enemyCenterY = enemy->y + enemySize / 2;
+    const EnemyArchetype& archetype = ENEMY_ARCHETYPES[enemies.type[index]];
+    float size = archetype.size;
+    float enemyCenterX = enemies.x[index] + size / 2;
+    float enemyCenterY = enemies.y[index] + size / 2;
 
     float diamondCenterX = diamondX + DIAMOND_SIZE / 2;
     float diamondCenterY = diamondY + DIAMOND_SIZE / 2;
@@ -375,16 +605,16 @@ void CampaignGame::checkEnemyDiamondCollision(Enemy* enemy) {
     float dy = enemyCenterY - diamondCenterY;
     float distance = std::sqrt(dx * dx + dy * dy);
 
-    if (distance < (enemySize / 2 + DIAMOND_SIZE / 2)) {
+    if (distance < (size / 2 + DIAMOND_SIZE / 2)) {
         diamondState = DIAMOND_WITH_ENEMY;
-        diamondCarrierID = enemy->id;
-        Mix_PlayChannel(-1, spawnSound, 0);
+        diamondCarrierID = enemies.id[index];
+        queueSound(SOUND_SPAWN);
 
-        // Tăng máu cho boss nếu nhặt được kim cương
-        if (dynamic_cast<Boss*>(enemy)) {
-            enemy->health += 20;
-        }
+        // Boss được tăng máu khi nhặt được kim cương
+        enemies.health[index] += archetype.diamondHealthBonus;
+        return true;
     }
+    return false;
 }
 
 void CampaignGame::updateDiamond() {
@@ -397,63 +627,99 @@ void CampaignGame::updateDiamond() {
             diamondX = player2.x + PLAYER_WIDTH / 2 - DIAMOND_SIZE / 2;
             diamondY = player2.y + PLAYER_HEIGHT / 2 - DIAMOND_SIZE / 2;
             break;
-        case DIAMOND_WITH_ENEMY:
+        case DIAMOND_WITH_ENEMY: {
+            // Sau bước tách enemy để kim cương nằm đúng chỗ carrier; tới lối ra thì giữ vị trí cuối
+            int index = enemies.IndexOf(diamondCarrierID);
+            if (gameEnded || index == -1 || enemies.y[index] < 0) break;
+            float size = ENEMY_ARCHETYPES[enemies.type[index]].size;
+            diamondX = enemies.x[index] + size / 2 - DIAMOND_SIZE / 2;
+            diamondY = enemies.y[index] + size / 2 - DIAMOND_SIZE / 2;
             break;
+        }
         case DIAMOND_ON_GROUND:
             break;
     }
 }
 
 void CampaignGame::checkBulletCollisions() {
-    for (auto bulletIt = bullets.begin(); bulletIt != bullets.end();) {
-        bool hit = false;
-        for (auto enemyIt = enemies.begin(); enemyIt != enemies.end();) {
-            float size = (dynamic_cast<Boss*>(enemyIt->get()) ? BOSS_SIZE : ENEMY_SIZE);
-            float enemyCenterX = (*enemyIt)->x + size / 2;
-            float enemyCenterY = (*enemyIt)->y + size / 2;
-            float dx = bulletIt->x - enemyCenterX;
-            float dy = bulletIt->y - enemyCenterY;
-            float distance = std::sqrt(dx * dx + dy * dy);
-
-            if (distance < (BULLET_SIZE / 2 + size / 2)) {
-                bool isPlayer1Bullet = (std::fabs(bulletIt->angle - (player1.angle * M_PI / 180.0f)) <
-                                        std::fabs(bulletIt->angle - (player2.angle * M_PI / 180.0f)) && player1.isAlive);
-
-                if (dynamic_cast<Boss*>(enemyIt->get())) (*enemyIt)->health -= 5;
-                else (*enemyIt)->health--;
-
-                if ((*enemyIt)->health <= 0) {
-                    if (isPlayer1Bullet) player1Info.score += (*enemyIt)->getScoreValue();
-                    else player2Info.score += (*enemyIt)->getScoreValue();
-
-                if (diamondState == DIAMOND_WITH_ENEMY && (*enemyIt)->id == diamondCarrierID) {
+    // Broadphase: đưa tâm enemy vào lưới, mỗi viên đạn chỉ xét các ô lân cận
+    enemyDead.assign(enemies.Size(), false);
+    enemyGrid.Begin();
+    for (size_t i = 0; i < enemies.Size(); i++) {
+        float size = ENEMY_ARCHETYPES[enemies.type[i]].size;
+        enemyGrid.Insert(i, enemies.x[i] + size / 2, enemies.y[i] + size / 2);
+    }
+    enemyGrid.Finish();
+
+    // Tìm enemy trúng đạn song song, bỏ qua việc enemy có thể chết bởi viên trước đó.
+    // Khi xử lý tuần tự bên dưới, viên nào có ứng viên đã chết mới phải tìm lại.
+    bulletHitCandidate.resize(bullets.Size());
+    ParallelFor(jobs, static_cast<int>(bullets.Size()), JOB_GRAIN_SIZE, [&](int begin, int end) {
+        for (int b = begin; b < end; b++) bulletHitCandidate[b] = findBulletHit(b, false);
+    });
+
+    bulletDead.assign(bullets.Size(), false);
+    for (size_t b = 0; b < bullets.Size(); b++) {
+        float bulletX = bullets.x[b];
+        float bulletY = bullets.y[b];
+
+        int hitIndex = bulletHitCandidate[b];
+        if (hitIndex != -1 && enemyDead[hitIndex]) hitIndex = findBulletHit(b, true);
+
+        if (hitIndex != -1) {
+            const EnemyArchetype& archetype = ENEMY_ARCHETYPES[enemies.type[hitIndex]];
+            int& health = enemies.health[hitIndex];
+            float enemyCenterX = enemies.x[hitIndex] + archetype.size / 2;
+            float enemyCenterY = enemies.y[hitIndex] + archetype.size / 2;
+            bool isPlayer1Bullet = (std::fabs(bullets.angle[b] - (player1.angle * M_PI / 180.0f)) <
+                                    std::fabs(bullets.angle[b] - (player2.angle * M_PI / 180.0f)) && player1.isAlive);
+
+            health -= archetype.damagePerHit;
+
+            if (health <= 0) {
+                if (isPlayer1Bullet) player1Info.score += archetype.scoreValue;
+                else player2Info.score += archetype.scoreValue;
+
+                if (diamondState == DIAMOND_WITH_ENEMY && enemies.id[hitIndex] == diamondCarrierID) {
                     diamondState = DIAMOND_ON_GROUND;
                     diamondX = enemyCenterX - DIAMOND_SIZE / 2;
                     diamondY = enemyCenterY - DIAMOND_SIZE / 2;
                     diamondCarrierID = -1;
                 }
 
-                    explosions.emplace_back(enemyCenterX, enemyCenterY);
-                    afterBoomMarks.emplace_back(enemyCenterX, enemyCenterY);
-                    Mix_PlayChannel(-1, enemyDeathSound, 0);
-                    enemyIt = enemies.erase(enemyIt);
-                    hit = true;
-                } else {
-                    ++enemyIt;
-                    hit = true;
-                }
-                break;
-            } else {
-                ++enemyIt;
+                explosions.Acquire(Explosion(enemyCenterX, enemyCenterY, simTick));
+                addAfterBoomMark(enemyCenterX, enemyCenterY);
+                queueSound(SOUND_ENEMY_DEATH);
+                enemyDead[hitIndex] = true;
             }
+            bulletDead[b] = true;
+            continue;
         }
 
-        if (hit || bulletIt->x < 0 || bulletIt->x > SCREEN_WIDTH || bulletIt->y < 0 || bulletIt->y > SCREEN_HEIGHT) {
-            bulletIt = bullets.erase(bulletIt);
-        } else {
-            ++bulletIt;
-        }
+        if (bulletX < 0 || bulletX > SCREEN_WIDTH || bulletY < 0 || bulletY > SCREEN_HEIGHT) bulletDead[b] = true;
     }
+    bullets.Compact(bulletDead);
+
+    // Xóa enemy chết một lần sau khi xét hết đạn, giữ nguyên thứ tự
+    enemies.Compact(enemyDead);
+}
+
+int CampaignGame::findBulletHit(size_t bullet, bool skipDead) {
+    const float queryRadius = BULLET_SIZE / 2 + MaxEnemyArchetypeSize() / 2;
+    float bulletX = bullets.x[bullet];
+    float bulletY = bullets.y[bullet];
+
+    // Narrowphase: so sánh bình phương khoảng cách; nếu trúng nhiều enemy thì lấy enemy đứng trước trong danh sách
+    int hitIndex = -1;
+    enemyGrid.ForEachNear(bulletX, bulletY, queryRadius, [&](int i) {
+        if ((skipDead && enemyDead[i]) || (hitIndex != -1 && i > hitIndex)) return;
+        float size = ENEMY_ARCHETYPES[enemies.type[i]].size;
+        float dx = bulletX - (enemies.x[i] + size / 2);
+        float dy = bulletY - (enemies.y[i] + size / 2);
+        float hitDistance = BULLET_SIZE / 2 + size / 2;
+        if (dx * dx + dy * dy < hitDistance * hitDistance) hitIndex = i;
+    });
+    return hitIndex;
 }
 
 void CampaignGame::updateBulletSystem(float deltaTime) {
@@ -476,7 +742,11 @@ void CampaignGame::updateBulletSystem(float deltaTime) {
     }
 }
 
-void CampaignGame::renderUI() {
+void CampaignGame::renderUI(const Snapshot& view) {
+    const PlayerInfo& player1Info = view.player1Info;
+    const PlayerInfo& player2Info = view.player2Info;
+    const BulletInfo& player1BulletInfo = view.player1BulletInfo;
+    const BulletInfo& player2BulletInfo = view.player2BulletInfo;
     SDL_Color white = {255, 255, 255, 255};
     const int UI_ELEMENT_SPACING = 10;
     const int BULLET_ICON_SIZE = 20;
@@ -484,95 +754,84 @@ void CampaignGame::renderUI() {
     const int UI_TOP_OFFSET = 5;
 
     SDL_Rect avatar1Rect = {UI_MARGIN, UI_TOP_OFFSET, AVATAR_SIZE, AVATAR_SIZE};
-    SDL_RenderCopy(renderer, player1Info.avatar, NULL, &avatar1Rect);
+    sprites.Draw(player1Info.avatar, avatar1Rect);
 
     int rightOfAvatarX = UI_MARGIN + AVATAR_SIZE + UI_ELEMENT_SPACING;
     for (int i = 0; i < player1Info.lives; i++) {
         SDL_Rect heartRect = {rightOfAvatarX + i * (HEART_SIZE + UI_ELEMENT_SPACING),
                               UI_TOP_OFFSET + (AVATAR_SIZE - HEART_SIZE) / 2, HEART_SIZE, HEART_SIZE};
-        SDL_RenderCopy(renderer, player1Info.heartTexture, NULL, &heartRect);
+        sprites.Draw(player1Info.heartSprite, heartRect);
     }
 
     int score1Y = UI_TOP_OFFSET + AVATAR_SIZE - HEART_SIZE + UI_ELEMENT_SPACING - 3;
     std::string score1Text = "Score: " + std::to_string(player1Info.score);
-    SDL_Surface* score1Surface = TTF_RenderText_Solid(font, score1Text.c_str(), white);
-    SDL_Texture* score1Texture = SDL_CreateTextureFromSurface(renderer, score1Surface);
-    SDL_Rect score1Rect = {rightOfAvatarX, score1Y, score1Surface->w, score1Surface->h};
-    SDL_RenderCopy(renderer, score1Texture, NULL, &score1Rect);
+    SDL_Point score1Size = textRenderer.MeasureGlyphs(score1Text);
+    textRenderer.DrawGlyphs(score1Text, white, rightOfAvatarX, score1Y);
 
-    int bullet1Y = score1Y + score1Surface->h + UI_ELEMENT_SPACING - 3;
+    int bullet1Y = score1Y + score1Size.y + UI_ELEMENT_SPACING - 3;
     for (int i = 0; i < MAX_BULLETS; i++) {
         if (player1BulletInfo.bulletStates[i]) {
             SDL_Rect bulletRect = {rightOfAvatarX + i * (BULLET_ICON_SIZE + BULLET_MARGIN), bullet1Y,
                                    BULLET_ICON_SIZE, BULLET_ICON_SIZE};
-            SDL_RenderCopy(renderer, player1BulletInfo.bulletIcon, NULL, &bulletRect);
+            sprites.Draw(player1BulletInfo.bulletIcon, bulletRect);
         }
     }
 
     int player2AvatarX = SCREEN_WIDTH - UI_MARGIN - AVATAR_SIZE;
     SDL_Rect avatar2Rect = {player2AvatarX, UI_TOP_OFFSET, AVATAR_SIZE, AVATAR_SIZE};
-    SDL_RenderCopy(renderer, player2Info.avatar, NULL, &avatar2Rect);
+    sprites.Draw(player2Info.avatar, avatar2Rect);
 
     int player2UIStartX = player2AvatarX - UI_ELEMENT_SPACING;
     for (int i = 0; i < player2Info.lives; i++) {
         SDL_Rect heartRect = {player2UIStartX - (i + 1) * (HEART_SIZE + UI_ELEMENT_SPACING),
                               UI_TOP_OFFSET + (AVATAR_SIZE - HEART_SIZE) / 2, HEART_SIZE, HEART_SIZE};
-        SDL_RenderCopy(renderer, player2Info.heartTexture, NULL, &heartRect);
+        sprites.Draw(player2Info.heartSprite, heartRect);
     }
 
     std::string score2Text = "Score: " + std::to_string(player2Info.score);
-    SDL_Surface* score2Surface = TTF_RenderText_Solid(font, score2Text.c_str(), white);
-    SDL_Texture* score2Texture = SDL_CreateTextureFromSurface(renderer, score2Surface);
-    int score2X = player2UIStartX - score2Surface->w;
-    SDL_Rect score2Rect = {score2X, score1Y, score2Surface->w, score2Surface->h};
-    SDL_RenderCopy(renderer, score2Texture, NULL, &score2Rect);
+    SDL_Point score2Size = textRenderer.MeasureGlyphs(score2Text);
+    int score2X = player2UIStartX - score2Size.x;
+    textRenderer.DrawGlyphs(score2Text, white, score2X, score1Y);
 
-    int bullet2Y = score1Y + score2Surface->h + UI_ELEMENT_SPACING - 3;
+    int bullet2Y = score1Y + score2Size.y + UI_ELEMENT_SPACING - 3;
     for (int i = 0; i < MAX_BULLETS; i++) {
         if (player2BulletInfo.bulletStates[i]) {
             SDL_Rect bulletRect = {player2UIStartX - (i + 1) * (BULLET_ICON_SIZE + BULLET_MARGIN), bullet2Y,
                                    BULLET_ICON_SIZE, BULLET_ICON_SIZE};
-            SDL_RenderCopy(renderer, player2BulletInfo.bulletIcon, NULL, &bulletRect);
+            sprites.Draw(player2BulletInfo.bulletIcon, bulletRect);
         }
     }
 
-    Uint32 currentTime = (SDL_GetTicks() - startTime) / 1000;
+    Uint32 currentTime = TicksToMs(view.simTick) / 1000;
     int minutes = currentTime / 60;
     int seconds = currentTime % 60;
     std::string timeText = std::to_string(minutes) + ":" + (seconds < 10 ? "0" : "") + std::to_string(seconds);
-    SDL_Surface* timeSurface = TTF_RenderText_Solid(font, timeText.c_str(), white);
-    SDL_Texture* timeTexture = SDL_CreateTextureFromSurface(renderer, timeSurface);
-    SDL_Rect timeRect = {SCREEN_WIDTH / 2 - timeSurface->w / 2, UI_TOP_OFFSET, timeSurface->w, timeSurface->h};
-    SDL_RenderCopy(renderer, timeTexture, NULL, &timeRect);
-
-    SDL_FreeSurface(score1Surface);
-    SDL_DestroyTexture(score1Texture);
-    SDL_FreeSurface(score2Surface);
-    SDL_DestroyTexture(score2Texture);
-    SDL_FreeSurface(timeSurface);
-    SDL_DestroyTexture(timeTexture);
+    SDL_Point timeSize = textRenderer.MeasureGlyphs(timeText);
+    textRenderer.DrawGlyphs(timeText, white, SCREEN_WIDTH / 2 - timeSize.x / 2, UI_TOP_OFFSET);
+
+    sprites.Flush();  // Avatar, tim và icon đạn: mỗi texture một lần vẽ
 }
 
 void CampaignGame::checkEnemyPlayerCollision() {
-    if (player1.isAlive && !isPlayerInvincible(player1InvincibleStart)) {
-        for (auto& enemy : enemies) {
-            if (std::abs(enemy->x - player1.x) < ENEMY_SIZE / 2 + PLAYER_WIDTH / 2 &&
-                std::abs(enemy->y - player1.y) < ENEMY_SIZE / 2 + PLAYER_HEIGHT / 2) {
+    if (player1.isAlive && !isPlayerInvincible(player1InvincibleUntil)) {
+        for (size_t i = 0; i < enemies.Size(); i++) {
+            if (std::abs(enemies.x[i] - player1.x) < ENEMY_SIZE / 2 + PLAYER_WIDTH / 2 &&
+                std::abs(enemies.y[i] - player1.y) < ENEMY_SIZE / 2 + PLAYER_HEIGHT / 2) {
                 if (diamondState == DIAMOND_WITH_PLAYER1) {
                     diamondState = DIAMOND_WITH_ENEMY;
-                    diamondCarrierID = enemy->id;
-                    Mix_PlayChannel(-1, spawnSound, 0);
-                    if (dynamic_cast<Boss*>(enemy.get())) enemy->health += 20;
+                    diamondCarrierID = enemies.id[i];
+                    queueSound(SOUND_SPAWN);
+                    enemies.health[i] += ENEMY_ARCHETYPES[enemies.type[i]].diamondHealthBonus;
                 }
 
                 player1Info.lives--;
-                Mix_PlayChannel(-1, playerDeathSound, 0);
-                player1InvincibleStart = SDL_GetTicks();
+                queueSound(SOUND_PLAYER_DEATH);
+                player1InvincibleUntil = simTick + MsToTicks(INVINCIBLE_DURATION);
                 player1IsInvincible = true;
 
                 if (player1Info.lives <= 0) {
-                    explosions.emplace_back(player1.x, player1.y);
-                    afterBoomMarks.emplace_back(player1.x, player1.y);
+                    explosions.Acquire(Explosion(player1.x, player1.y, simTick));
+                    addAfterBoomMark(player1.x, player1.y);
                     player1.isAlive = false;
                     player1IsInvincible = false;
                 }
@@ -581,25 +840,25 @@ void CampaignGame::checkEnemyPlayerCollision() {
         }
     }
 
-    if (player2.isAlive && !isPlayerInvincible(player2InvincibleStart)) {
-        for (auto& enemy : enemies) {
-            if (std::abs(enemy->x - player2.x) < ENEMY_SIZE / 2 + PLAYER_WIDTH / 2 &&
-                std::abs(enemy->y - player2.y) < ENEMY_SIZE / 2 + PLAYER_HEIGHT / 2) {
+    if (player2.isAlive && !isPlayerInvincible(player2InvincibleUntil)) {
+        for (size_t i = 0; i < enemies.Size(); i++) {
+            if (std::abs(enemies.x[i] - player2.x) < ENEMY_SIZE / 2 + PLAYER_WIDTH / 2 &&
+                std::abs(enemies.y[i] - player2.y) < ENEMY_SIZE / 2 + PLAYER_HEIGHT / 2) {
                 if (diamondState == DIAMOND_WITH_PLAYER2) {
                     diamondState = DIAMOND_WITH_ENEMY;
-                    diamondCarrierID = enemy->id;
-                    Mix_PlayChannel(-1, spawnSound, 0);
-                    if (dynamic_cast<Boss*>(enemy.get())) enemy->health += 20;
+                    diamondCarrierID = enemies.id[i];
+                    queueSound(SOUND_SPAWN);
+                    enemies.health[i] += ENEMY_ARCHETYPES[enemies.type[i]].diamondHealthBonus;
                 }
 
                 player2Info.lives--;
-                Mix_PlayChannel(-1, playerDeathSound, 0);
-                player2InvincibleStart = SDL_GetTicks();
+                queueSound(SOUND_PLAYER_DEATH);
+                player2InvincibleUntil = simTick + MsToTicks(INVINCIBLE_DURATION);
                 player2IsInvincible = true;
 
                 if (player2Info.lives <= 0) {
-                    explosions.emplace_back(player2.x, player2.y);
-                    afterBoomMarks.emplace_back(player2.x, player2.y);
+                    explosions.Acquire(Explosion(player2.x, player2.y, simTick));
+                    addAfterBoomMark(player2.x, player2.y);
                     player2.isAlive = false;
                     player2IsInvincible = false;
                 }
@@ -614,220 +873,201 @@ bool CampaignGame::checkCollision(float x1, float y1, float w1, float h1, float
 }
 
 void CampaignGame::updateExplosions() {
-    const Uint32 explosionDuration = 500;
-    Uint32 currentTime = SDL_GetTicks();
-    for (auto it = explosions.begin(); it != explosions.end();) {
-        if (currentTime - it->startTime > explosionDuration) it = explosions.erase(it);
-        else ++it;
-    }
+    const Uint32 explosionDuration = MsToTicks(500);
+    explosions.ReleaseIf([&](const Explosion& explosion) { return simTick - explosion.startTick > explosionDuration; });
 }
 
-void CampaignGame::HandleInput() {
-    SDL_Event e;
-    int mouseX, mouseY;
-    while (SDL_PollEvent(&e)) {
-        if (e.type == SDL_QUIT) running = false;
-
-        if (e.type == SDL_KEYDOWN) {
-            if (e.key.keysym.sym == SDLK_p) {
-                isPaused = !isPaused;
-                if (isPaused) {
-                    Mix_PauseMusic();
-                } else {
-                    Mix_ResumeMusic();
-                }
-            }
-            // Exit pause with ESC
-            if (isPaused && e.key.keysym.sym == SDLK_ESCAPE) {
-                isPaused = false;
+void CampaignGame::handleEvent(const SDL_Event& e) {
+    // Chạy trên thread mô phỏng: tọa độ chuột lấy từ event, không gọi SDL_GetMouseState()
+    if (e.type == SDL_QUIT) running = false;
+    if (showGameOverScreen) {
+        if (e.type == SDL_MOUSEBUTTONDOWN) handleGameOverClick(e.button.x, e.button.y);
+        return;
+    }
+
+    if (e.type == SDL_KEYDOWN) {
+        if (e.key.keysym.sym == SDLK_p) {
+            isPaused = !isPaused;
+            if (isPaused) {
+                Mix_PauseMusic();
+            } else {
                 Mix_ResumeMusic();
             }
         }
+        // Exit pause with ESC
+        if (isPaused && e.key.keysym.sym == SDLK_ESCAPE) {
+            isPaused = false;
+            Mix_ResumeMusic();
+        }
+    }
 
-        if (isPaused) {
-            if (e.type == SDL_MOUSEBUTTONDOWN) {
-                SDL_GetMouseState(&mouseX, &mouseY);
-                if (mouseX >= musicSlider.x && mouseX <= musicSlider.x + musicSlider.w &&
-                    mouseY >= musicSlider.y && mouseY <= musicSlider.y + musicSlider.h) {
-                    isDraggingMusic = true;
-                }
-                if (mouseX >= sfxSlider.x && mouseX <= sfxSlider.x + sfxSlider.w &&
-                    mouseY >= sfxSlider.y && mouseY <= sfxSlider.y + sfxSlider.h) {
-                    isDraggingSFX = true;
-                }
-                if (mouseX >= menuButtonRect.x && mouseX <= menuButtonRect.x + menuButtonRect.w &&
-                    mouseY >= menuButtonRect.y && mouseY <= menuButtonRect.y + menuButtonRect.h) {
-                    running = false;
-                }
+    if (isPaused) {
+        if (e.type == SDL_MOUSEBUTTONDOWN) {
+            int mouseX = e.button.x;
+            int mouseY = e.button.y;
+            if (mouseX >= musicSlider.x && mouseX <= musicSlider.x + musicSlider.w &&
+                mouseY >= musicSlider.y && mouseY <= musicSlider.y + musicSlider.h) {
+                isDraggingMusic = true;
             }
-            if (e.type == SDL_MOUSEBUTTONUP) {
-                isDraggingMusic = false;
-                isDraggingSFX = false;
+            if (mouseX >= sfxSlider.x && mouseX <= sfxSlider.x + sfxSlider.w &&
+                mouseY >= sfxSlider.y && mouseY <= sfxSlider.y + sfxSlider.h) {
+                isDraggingSFX = true;
+            }
+            if (mouseX >= menuButtonRect.x && mouseX <= menuButtonRect.x + menuButtonRect.w &&
+                mouseY >= menuButtonRect.y && mouseY <= menuButtonRect.y + menuButtonRect.h) {
+                running = false;
+            }
+        }
+        if (e.type == SDL_MOUSEBUTTONUP) {
+            isDraggingMusic = false;
+            isDraggingSFX = false;
+        }
+        if (e.type == SDL_MOUSEMOTION && (isDraggingMusic || isDraggingSFX)) {
+            int mouseX = e.motion.x;
+            if (isDraggingMusic) {
+                musicVolume = ((mouseX - musicSlider.x) * 128) / musicSlider.w;
+                musicVolume = std::max(0, std::min(128, musicVolume));
+                Mix_VolumeMusic(musicVolume);
+                // Lưu cài đặt âm lượng
             }
-            if (e.type == SDL_MOUSEMOTION && (isDraggingMusic || isDraggingSFX)) {
-                SDL_GetMouseState(&mouseX, &mouseY);
-                if (isDraggingMusic) {
-                    musicVolume = ((mouseX - musicSlider.x) * 128) / musicSlider.w;
-                    musicVolume = std::max(0, std::min(128, musicVolume));
-                    Mix_VolumeMusic(musicVolume);
-                    // Lưu cài đặt âm lượng
-                }
 
-                if (isDraggingSFX) {
-                    sfxVolume = ((mouseX - sfxSlider.x) * 128) / sfxSlider.w;
-                    sfxVolume = std::max(0, std::min(128, sfxVolume));
-                    // Cập nhật âm lượng cho tất cả hiệu ứng âm thanh
-                    Mix_VolumeChunk(enemyDeathSound, sfxVolume);
-                    Mix_VolumeChunk(playerDeathSound, sfxVolume);
-                    Mix_VolumeChunk(spawnSound, sfxVolume);
-                    // Lưu cài đặt âm lượng
-                }
+            if (isDraggingSFX) {
+                sfxVolume = ((mouseX - sfxSlider.x) * 128) / sfxSlider.w;
+                sfxVolume = std::max(0, std::min(128, sfxVolume));
+                // Cập nhật âm lượng cho tất cả hiệu ứng âm thanh
+                Mix_VolumeChunk(enemyDeathSound, sfxVolume);
+                Mix_VolumeChunk(playerDeathSound, sfxVolume);
+                Mix_VolumeChunk(spawnSound, sfxVolume);
+                // Lưu cài đặt âm lượng
             }
         }
     }
+}
 
-    if (!isPaused) {
-        const Uint8* keystate = SDL_GetKeyboardState(NULL);
-        Uint32 currentTime = SDL_GetTicks();
-
-        if (player1.isAlive) {
-            float rad1 = player1.angle * M_PI / 180.0;
-            float nextX1 = player1.x;
-            float nextY1 = player1.y;
+void CampaignGame::updatePlayers() {
+    if (player1.isAlive) {
+        float rad1 = player1.angle * M_PI / 180.0;
+        float nextX1 = player1.x;
+        float nextY1 = player1.y;
 
-            if (keystate[SDL_SCANCODE_W]) {
-                nextX1 += 5 * cos(rad1);
-                nextY1 += 5 * sin(rad1);
-            }
-            if (keystate[SDL_SCANCODE_S]) {
-                nextX1 -= 5 * cos(rad1);
-                nextY1 -= 5 * sin(rad1);
-            }
+        if (player1Input.forward) {
+            nextX1 += 5 * cos(rad1);
+            nextY1 += 5 * sin(rad1);
+        }
+        if (player1Input.backward) {
+            nextX1 -= 5 * cos(rad1);
+            nextY1 -= 5 * sin(rad1);
+        }
 
-            bool inGateXRange = (nextX1 >= GATE_X_START && nextX1 <= GATE_X_END - PLAYER_WIDTH);
-            bool inHallwayXRange = (nextX1 >= HALLWAY_X_START && nextX1 <= HALLWAY_X_END - PLAYER_WIDTH);
-
-            if (nextY1 >= PLAY_AREA_MIN_Y && nextY1 <= PLAY_AREA_MAX_Y - PLAYER_HEIGHT) {
-                nextX1 = std::max(float(PLAY_AREA_MIN_X), std::min(float(PLAY_AREA_MAX_X - PLAYER_WIDTH), nextX1));
-            } else if (inGateXRange && (nextY1 < PLAY_AREA_MIN_Y || nextY1 > PLAY_AREA_MAX_Y - PLAYER_HEIGHT)) {
-                nextX1 = std::max(float(GATE_X_START), std::min(float(GATE_X_END - PLAYER_WIDTH), nextX1));
-                nextY1 = std::max(float(OUTER_TOP_Y), std::min(float(OUTER_BOTTOM_Y - PLAYER_HEIGHT), nextY1));
-            } else if (inHallwayXRange && (nextY1 < PLAY_AREA_MIN_Y || nextY1 > PLAY_AREA_MAX_Y - PLAYER_HEIGHT)) {
-                nextX1 = std::max(float(HALLWAY_X_START), std::min(float(HALLWAY_X_END - PLAYER_WIDTH), nextX1));
-                nextY1 = std::max(float(OUTER_TOP_Y), std::min(float(OUTER_BOTTOM_Y - PLAYER_HEIGHT), nextY1));
-            } else {
-                nextX1 = player1.x;
-                nextY1 = player1.y;
-            }
+        bool inGateXRange = (nextX1 >= GATE_X_START && nextX1 <= GATE_X_END - PLAYER_WIDTH);
+        bool inHallwayXRange = (nextX1 >= HALLWAY_X_START && nextX1 <= HALLWAY_X_END - PLAYER_WIDTH);
+
+        if (nextY1 >= PLAY_AREA_MIN_Y && nextY1 <= PLAY_AREA_MAX_Y - PLAYER_HEIGHT) {
+            nextX1 = std::max(float(PLAY_AREA_MIN_X), std::min(float(PLAY_AREA_MAX_X - PLAYER_WIDTH), nextX1));
+        } else if (inGateXRange && (nextY1 < PLAY_AREA_MIN_Y || nextY1 > PLAY_AREA_MAX_Y - PLAYER_HEIGHT)) {
+            nextX1 = std::max(float(GATE_X_START), std::min(float(GATE_X_END - PLAYER_WIDTH), nextX1));
+            nextY1 = std::max(float(OUTER_TOP_Y), std::min(float(OUTER_BOTTOM_Y - PLAYER_HEIGHT), nextY1));
+        } else if (inHallwayXRange && (nextY1 < PLAY_AREA_MIN_Y || nextY1 > PLAY_AREA_MAX_Y - PLAYER_HEIGHT)) {
+            nextX1 = std::max(float(HALLWAY_X_START), std::min(float(HALLWAY_X_END - PLAYER_WIDTH), nextX1));
+            nextY1 = std::max(float(OUTER_TOP_Y), std::min(float(OUTER_BOTTOM_Y - PLAYER_HEIGHT), nextY1));
+        } else {
+            nextX1 = player1.x;
+            nextY1 = player1.y;
+        }
 
-            if (!player2.isAlive || !checkCollision(nextX1, nextY1, PLAYER_WIDTH, PLAYER_HEIGHT,
-                                                    player2.x, player2.y, PLAYER_WIDTH, PLAYER_HEIGHT)) {
-                player1.x = nextX1;
-                player1.y = nextY1;
-            }
-            if (keystate[SDL_SCANCODE_A]) player1.angle -= 5;
-            if (keystate[SDL_SCANCODE_D]) player1.angle += 5;
-
-            if (diamondState == DIAMOND_ON_GROUND) checkDiamondCollision(player1.x, player1.y, PLAYER_WIDTH, PLAYER_HEIGHT);
-
-            if (keystate[SDL_SCANCODE_SPACE] && player1BulletInfo.currentBullets > 0 && currentTime - lastFireTime1 > FIRE_RATE) {
-                float bulletX = player1.x + PLAYER_WIDTH / 2 + (PLAYER_WIDTH / 2) * cos(rad1);
-                float bulletY = player1.y + PLAYER_HEIGHT / 2 + (PLAYER_WIDTH / 2) * sin(rad1);
-                bullets.emplace_back(bulletX, bulletY, rad1);
-                lastFireTime1 = currentTime;
-                player1BulletInfo.currentBullets--;
-                player1BulletInfo.bulletStates[player1BulletInfo.currentBullets] = false;
-                player1BulletInfo.reloadTimer = RELOAD_TIME;
-            }
+        if (!player2.isAlive || !checkCollision(nextX1, nextY1, PLAYER_WIDTH, PLAYER_HEIGHT,
+                                                player2.x, player2.y, PLAYER_WIDTH, PLAYER_HEIGHT)) {
+            player1.x = nextX1;
+            player1.y = nextY1;
         }
+        if (player1Input.turnLeft) player1.angle -= 5;
+        if (player1Input.turnRight) player1.angle += 5;
+
+        if (diamondState == DIAMOND_ON_GROUND) checkDiamondCollision(player1.x, player1.y, PLAYER_WIDTH, PLAYER_HEIGHT);
+
+        if (player1Input.fire && player1BulletInfo.currentBullets > 0 && simTick >= nextFireTick1) {
+            float bulletX = player1.x + PLAYER_WIDTH / 2 + (PLAYER_WIDTH / 2) * cos(rad1);
+            float bulletY = player1.y + PLAYER_HEIGHT / 2 + (PLAYER_WIDTH / 2) * sin(rad1);
+            bullets.Add(bulletX, bulletY, rad1, BULLET_SPEED);
+            nextFireTick1 = simTick + MsToTicks(FIRE_RATE);
+            player1BulletInfo.currentBullets--;
+            player1BulletInfo.bulletStates[player1BulletInfo.currentBullets] = false;
+            player1BulletInfo.reloadTimer = RELOAD_TIME;
+        }
+    }
 
-        if (player2.isAlive) {
-            float rad2 = player2.angle * M_PI / 180.0;
-            float nextX2 = player2.x;
-            float nextY2 = player2.y;
+    if (player2.isAlive) {
+        float rad2 = player2.angle * M_PI / 180.0;
+        float nextX2 = player2.x;
+        float nextY2 = player2.y;
 
-            if (keystate[SDL_SCANCODE_UP]) {
-                nextX2 += 5 * cos(rad2);
-                nextY2 += 5 * sin(rad2);
-            }
-            if (keystate[SDL_SCANCODE_DOWN]) {
-                nextX2 -= 5 * cos(rad2);
-                nextY2 -= 5 * sin(rad2);
-            }
+        if (player2Input.forward) {
+            nextX2 += 5 * cos(rad2);
+            nextY2 += 5 * sin(rad2);
+        }
+        if (player2Input.backward) {
+            nextX2 -= 5 * cos(rad2);
+            nextY2 -= 5 * sin(rad2);
+        }
 
-            bool inGateXRange = (nextX2 >= GATE_X_START && nextX2 <= GATE_X_END - PLAYER_WIDTH);
-            bool inHallwayXRange = (nextX2 >= HALLWAY_X_START && nextX2 <= HALLWAY_X_END - PLAYER_WIDTH);
-
-            if (nextY2 >= PLAY_AREA_MIN_Y && nextY2 <= PLAY_AREA_MAX_Y - PLAYER_HEIGHT) {
-                nextX2 = std::max(float(PLAY_AREA_MIN_X), std::min(float(PLAY_AREA_MAX_X - PLAYER_WIDTH), nextX2));
-            } else if (inGateXRange && (nextY2 < PLAY_AREA_MIN_Y || nextY2 > PLAY_AREA_MAX_Y - PLAYER_HEIGHT)) {
-                nextX2 = std::max(float(GATE_X_START), std::min(float(GATE_X_END - PLAYER_WIDTH), nextX2));
-                nextY2 = std::max(float(OUTER_TOP_Y), std::min(float(OUTER_BOTTOM_Y - PLAYER_HEIGHT), nextY2));
-            } else if (inHallwayXRange && (nextY2 < PLAY_AREA_MIN_Y || nextY2 > PLAY_AREA_MAX_Y - PLAYER_HEIGHT)) {
-                nextX2 = std::max(float(HALLWAY_X_START), std::min(float(HALLWAY_X_END - PLAYER_WIDTH), nextX2));
-                nextY2 = std::max(float(OUTER_TOP_Y), std::min(float(OUTER_BOTTOM_Y - PLAYER_HEIGHT), nextY2));
-            } else {
-                nextX2 = player2.x;
-                nextY2 = player2.y;
-            }
+        bool inGateXRange = (nextX2 >= GATE_X_START && nextX2 <= GATE_X_END - PLAYER_WIDTH);
+        bool inHallwayXRange = (nextX2 >= HALLWAY_X_START && nextX2 <= HALLWAY_X_END - PLAYER_WIDTH);
+
+        if (nextY2 >= PLAY_AREA_MIN_Y && nextY2 <= PLAY_AREA_MAX_Y - PLAYER_HEIGHT) {
+            nextX2 = std::max(float(PLAY_AREA_MIN_X), std::min(float(PLAY_AREA_MAX_X - PLAYER_WIDTH), nextX2));
+        } else if (inGateXRange && (nextY2 < PLAY_AREA_MIN_Y || nextY2 > PLAY_AREA_MAX_Y - PLAYER_HEIGHT)) {
+            nextX2 = std::max(float(GATE_X_START), std::min(float(GATE_X_END - PLAYER_WIDTH), nextX2));
+            nextY2 = std::max(float(OUTER_TOP_Y), std::min(float(OUTER_BOTTOM_Y - PLAYER_HEIGHT), nextY2));
+        } else if (inHallwayXRange && (nextY2 < PLAY_AREA_MIN_Y || nextY2 > PLAY_AREA_MAX_Y - PLAYER_HEIGHT)) {
+            nextX2 = std::max(float(HALLWAY_X_START), std::min(float(HALLWAY_X_END - PLAYER_WIDTH), nextX2));
+            nextY2 = std::max(float(OUTER_TOP_Y), std::min(float(OUTER_BOTTOM_Y - PLAYER_HEIGHT), nextY2));
+        } else {
+            nextX2 = player2.x;
+            nextY2 = player2.y;
+        }
 
-            if (!player1.isAlive || !checkCollision(player1.x, player1.y, PLAYER_WIDTH, PLAYER_HEIGHT,
-                                                    nextX2, nextY2, PLAYER_WIDTH, PLAYER_HEIGHT)) {
-                player2.x = nextX2;
-                player2.y = nextY2;
-            }
-            if (keystate[SDL_SCANCODE_LEFT]) player2.angle -= 5;
-            if (keystate[SDL_SCANCODE_RIGHT]) player2.angle += 5;
-
-            if (diamondState == DIAMOND_ON_GROUND) checkDiamondCollision(player2.x, player2.y, PLAYER_WIDTH, PLAYER_HEIGHT);
-
-            if (keystate[SDL_SCANCODE_RETURN] && player2BulletInfo.currentBullets > 0 && currentTime - lastFireTime2 > FIRE_RATE) {
-                float bulletX = player2.x + PLAYER_WIDTH / 2 + (PLAYER_WIDTH / 2) * cos(rad2);
-                float bulletY = player2.y + PLAYER_HEIGHT / 2 + (PLAYER_WIDTH / 2) * sin(rad2);
-                bullets.emplace_back(bulletX, bulletY, rad2);
-                lastFireTime2 = currentTime;
-                player2BulletInfo.currentBullets--;
-                player2BulletInfo.bulletStates[player2BulletInfo.currentBullets] = false;
-                player2BulletInfo.reloadTimer = RELOAD_TIME;
-            }
+        if (!player1.isAlive || !checkCollision(player1.x, player1.y, PLAYER_WIDTH, PLAYER_HEIGHT,
+                                                nextX2, nextY2, PLAYER_WIDTH, PLAYER_HEIGHT)) {
+            player2.x = nextX2;
+            player2.y = nextY2;
+        }
+        if (player2Input.turnLeft) player2.angle -= 5;
+        if (player2Input.turnRight) player2.angle += 5;
+
+        if (diamondState == DIAMOND_ON_GROUND) checkDiamondCollision(player2.x, player2.y, PLAYER_WIDTH, PLAYER_HEIGHT);
+
+        if (player2Input.fire && player2BulletInfo.currentBullets > 0 && simTick >= nextFireTick2) {
+            float bulletX = player2.x + PLAYER_WIDTH / 2 + (PLAYER_WIDTH / 2) * cos(rad2);
+            float bulletY = player2.y + PLAYER_HEIGHT / 2 + (PLAYER_WIDTH / 2) * sin(rad2);
+            bullets.Add(bulletX, bulletY, rad2, BULLET_SPEED);
+            nextFireTick2 = simTick + MsToTicks(FIRE_RATE);
+            player2BulletInfo.currentBullets--;
+            player2BulletInfo.bulletStates[player2BulletInfo.currentBullets] = false;
+            player2BulletInfo.reloadTimer = RELOAD_TIME;
         }
     }
 }
 
 void CampaignGame::updateBullets() {
-    for (auto it = bullets.begin(); it != bullets.end();) {
-        it->x += BULLET_SPEED * cos(it->angle);
-        it->y += BULLET_SPEED * sin(it->angle);
-
-        bool inGateXRange = (it->x >= GATE_X_START && it->x <= GATE_X_END);
-        bool inHallwayXRange = (it->x >= HALLWAY_X_START && it->x <= HALLWAY_X_END);
-
-        if (it->y >= PLAY_AREA_MIN_Y && it->y <= PLAY_AREA_MAX_Y) {
-            if (it->x < PLAY_AREA_MIN_X || it->x > PLAY_AREA_MAX_X) it = bullets.erase(it);
-            else ++it;
-        } else if (inGateXRange && (it->y < PLAY_AREA_MIN_Y || it->y > PLAY_AREA_MAX_Y)) {
-            if (it->y < OUTER_TOP_Y || it->y > OUTER_BOTTOM_Y) it = bullets.erase(it);
-            else ++it;
-        } else if (inHallwayXRange && (it->y < PLAY_AREA_MIN_Y || it->y > PLAY_AREA_MAX_Y)) {
-            if (it->y < OUTER_TOP_Y || it->y > OUTER_BOTTOM_Y) it = bullets.erase(it);
-            else ++it;
-        } else {
-            it = bullets.erase(it);
-        }
-    }
+    // Đạn còn bay khi ở trong sân, hoặc trong cổng/hành lang kéo dài tới mép màn hình
+    static const BulletBounds bulletBounds[] = {
+        {PLAY_AREA_MIN_X, PLAY_AREA_MIN_Y, PLAY_AREA_MAX_X, PLAY_AREA_MAX_Y},
+        {GATE_X_START, OUTER_TOP_Y, GATE_X_END, OUTER_BOTTOM_Y},
+        {HALLWAY_X_START, OUTER_TOP_Y, HALLWAY_X_END, OUTER_BOTTOM_Y},
+    };
+    bullets.IntegrateAndCull(bulletBounds, 3, jobs);
 }
 
-bool CampaignGame::isPlayerInvincible(Uint32 invincibleStart) {
-    if (invincibleStart == 0) return false;
-    return (SDL_GetTicks() - invincibleStart) < INVINCIBLE_DURATION;
+bool CampaignGame::isPlayerInvincible(Uint32 invincibleUntil) {
+    return simTick < invincibleUntil;
 }
 
-void CampaignGame::renderShieldEffect(float playerX, float playerY, Uint32 invincibleStart) {
-    if (isPlayerInvincible(invincibleStart)) {
-        SDL_Rect shieldRect = {static_cast<int>(playerX + PLAYER_WIDTH / 2 - SHIELD_SIZE / 2),
-                               static_cast<int>(playerY + PLAYER_HEIGHT / 2 - SHIELD_SIZE / 2),
+void CampaignGame::renderShieldEffect(const Snapshot& view, const Player& player, Uint32 invincibleUntil) {
+    if (view.simTick < invincibleUntil) {
+        SDL_Rect shieldRect = {static_cast<int>(player.x + PLAYER_WIDTH / 2 - SHIELD_SIZE / 2),
+                               static_cast<int>(player.y + PLAYER_HEIGHT / 2 - SHIELD_SIZE / 2),
                                SHIELD_SIZE, SHIELD_SIZE};
-        SDL_RenderCopy(renderer, shieldTexture, NULL, &shieldRect);
+        sprites.Draw(shieldSprite, shieldRect);
     }
 }
 
@@ -835,54 +1075,21 @@ bool CampaignGame::isMouseOverButton(int mouseX, int mouseY, int buttonX, int bu
     return (mouseX >= buttonX && mouseX <= buttonX + buttonW && mouseY >= buttonY && mouseY <= buttonY + buttonH);
 }
 
-void CampaignGame::handleGameOverInput() {
-    SDL_Event e;
-    int mouseX, mouseY;
-    while (SDL_PollEvent(&e)) {
-        if (e.type == SDL_QUIT) {
-            running = false;
-        }
-        if (e.type == SDL_MOUSEBUTTONDOWN) {
-            SDL_GetMouseState(&mouseX, &mouseY);
-
-            // Kiểm tra nút Restart (X: 95, Y: 680, W: 285, H: 80)
-            if (mouseX >= 95 && mouseX <= 95 + 285 &&
-                mouseY >= 680 && mouseY <= 680 + 80) {
-                // Reset game state
-                showGameOverScreen = false;
-                gameEnded = false;
-                player1 = Player(PLAY_AREA_MIN_X + PLAYER_OFFSET, SCREEN_HEIGHT / 2, 0);
-                player2 = Player(PLAY_AREA_MAX_X - PLAYER_WIDTH - PLAYER_OFFSET, SCREEN_HEIGHT / 2, 180);
-                player1Info = {MAX_LIVES, 0, player1Info.avatar, player1Info.heartTexture};
-                player2Info = {MAX_LIVES, 0, player2Info.avatar, player2Info.heartTexture};
-                player1BulletInfo = {MAX_BULLETS, 0.0f, std::vector<bool>(MAX_BULLETS, true), player1BulletInfo.bulletIcon};
-                player2BulletInfo = {MAX_BULLETS, 0.0f, std::vector<bool>(MAX_BULLETS, true), player2BulletInfo.bulletIcon};
-                bullets.clear();
-                enemies.clear();
-                explosions.clear();
-                afterBoomMarks.clear();
-                diamondState = DIAMOND_ON_GROUND;
-                diamondCarrierID = -1;
-                diamondX = SCREEN_WIDTH / 2 - DIAMOND_SIZE / 2;
-                diamondY = SCREEN_HEIGHT / 2 - DIAMOND_SIZE / 2;
-                startTime = SDL_GetTicks();
-                lastSpawnTime = 0;
-                player1IsInvincible = false;
-                player2IsInvincible = false;
-                player1InvincibleStart = 0;
-                player2InvincibleStart = 0;
-            }
-            // Kiểm tra nút Menu (X: 420, Y: 680, W: 285, H: 80)
-            else if (mouseX >= 420 && mouseX <= 420 + 285 &&
-                     mouseY >= 680 && mouseY <= 680 + 80) {
-                // Thoát về menu chính
-                running = false;
-            }
-        }
+void CampaignGame::handleGameOverClick(int mouseX, int mouseY) {
+    // Kiểm tra nút Restart (X: 95, Y: 680, W: 285, H: 80)
+    if (mouseX >= 95 && mouseX <= 95 + 285 &&
+        mouseY >= 680 && mouseY <= 680 + 80) {
+        ResetGame();
+    }
+    // Kiểm tra nút Menu (X: 420, Y: 680, W: 285, H: 80)
+    else if (mouseX >= 420 && mouseX <= 420 + 285 &&
+             mouseY >= 680 && mouseY <= 680 + 80) {
+        // Thoát về menu chính
+        running = false;
     }
 }
 
-void CampaignGame::renderGameOverScreen() {
+void CampaignGame::renderGameOverScreen(const Snapshot& view) {
     SDL_Color white = {255, 255, 255, 255};
     SDL_Color yellow = {255, 255, 0, 255};
 
@@ -891,95 +1098,74 @@ void CampaignGame::renderGameOverScreen() {
     SDL_RenderCopy(renderer, gameOverBackgroundTexture, NULL, &backgroundRect);
 
     // Tính toán thời gian chơi
-    int totalScore = player1Info.score + player2Info.score;
-    Uint32 playTime = endGameTime / 1000;
+    int totalScore = view.player1Info.score + view.player2Info.score;
+    Uint32 playTime = view.endGameTime / 1000;
     int minutes = playTime / 60;
     int seconds = playTime % 60;
 
     // Render thông tin người chơi 1
     std::string player1Text = "Player 1";
-    SDL_Surface* player1Surface = TTF_RenderText_Solid(font, player1Text.c_str(), white);
-    SDL_Texture* player1Texture = SDL_CreateTextureFromSurface(renderer, player1Surface);
-    SDL_Rect player1Rect = {SCREEN_WIDTH / 4 - player1Surface->w / 2 + 30, SCREEN_HEIGHT / 2 + 12,
-                            player1Surface->w, player1Surface->h};
-    SDL_RenderCopy(renderer, player1Texture, NULL, &player1Rect);
+    const TextRenderer::TextImage& player1Image = textRenderer.Cached("gameover.player1", player1Text, white);
+    SDL_Rect player1Rect = {SCREEN_WIDTH / 4 - player1Image.w / 2 + 30, SCREEN_HEIGHT / 2 + 12,
+                            player1Image.w, player1Image.h};
+    SDL_RenderCopy(renderer, player1Image.texture, NULL, &player1Rect);
 
-    std::string score1Text = "Score: " + std::to_string(player1Info.score);
-    SDL_Surface* score1Surface = TTF_RenderText_Solid(font, score1Text.c_str(), white);
-    SDL_Texture* score1Texture = SDL_CreateTextureFromSurface(renderer, score1Surface);
-    SDL_Rect score1Rect = {SCREEN_WIDTH / 4 - score1Surface->w / 2 + 30, player1Rect.y + player1Surface->h - 15,
-                           score1Surface->w, score1Surface->h};
-    SDL_RenderCopy(renderer, score1Texture, NULL, &score1Rect);
+    std::string score1Text = "Score: " + std::to_string(view.player1Info.score);
+    const TextRenderer::TextImage& score1Image = textRenderer.Cached("gameover.score1", score1Text, white);
+    SDL_Rect score1Rect = {SCREEN_WIDTH / 4 - score1Image.w / 2 + 30, player1Rect.y + player1Image.h - 15,
+                           score1Image.w, score1Image.h};
+    SDL_RenderCopy(renderer, score1Image.texture, NULL, &score1Rect);
 
     // Render thông tin người chơi 2
     std::string player2Text = "Player 2";
-    SDL_Surface* player2Surface = TTF_RenderText_Solid(font, player2Text.c_str(), white);
-    SDL_Texture* player2Texture = SDL_CreateTextureFromSurface(renderer, player2Surface);
-    SDL_Rect player2Rect = {3 * SCREEN_WIDTH / 4 - player2Surface->w / 2 - 30, SCREEN_HEIGHT / 2 + 12,
-                            player2Surface->w, player2Surface->h};
-    SDL_RenderCopy(renderer, player2Texture, NULL, &player2Rect);
+    const TextRenderer::TextImage& player2Image = textRenderer.Cached("gameover.player2", player2Text, white);
+    SDL_Rect player2Rect = {3 * SCREEN_WIDTH / 4 - player2Image.w / 2 - 30, SCREEN_HEIGHT / 2 + 12,
+                            player2Image.w, player2Image.h};
+    SDL_RenderCopy(renderer, player2Image.texture, NULL, &player2Rect);
 
-    std::string score2Text = "Score: " + std::to_string(player2Info.score);
-    SDL_Surface* score2Surface = TTF_RenderText_Solid(font, score2Text.c_str(), white);
-    SDL_Texture* score2Texture = SDL_CreateTextureFromSurface(renderer, score2Surface);
-    SDL_Rect score2Rect = {3 * SCREEN_WIDTH / 4 - score2Surface->w / 2 - 30, player2Rect.y + player2Surface->h - 15,
-                           score2Surface->w, score2Surface->h};
-    SDL_RenderCopy(renderer, score2Texture, NULL, &score2Rect);
+    std::string score2Text = "Score: " + std::to_string(view.player2Info.score);
+    const TextRenderer::TextImage& score2Image = textRenderer.Cached("gameover.score2", score2Text, white);
+    SDL_Rect score2Rect = {3 * SCREEN_WIDTH / 4 - score2Image.w / 2 - 30, player2Rect.y + player2Image.h - 15,
+                           score2Image.w, score2Image.h};
+    SDL_RenderCopy(renderer, score2Image.texture, NULL, &score2Rect);
 
     // Render tổng điểm
     std::string totalScoreText = "Total Score: " + std::to_string(totalScore);
-    SDL_Surface* totalScoreSurface = TTF_RenderText_Solid(font, totalScoreText.c_str(), white);
-    SDL_Texture* totalScoreTexture = SDL_CreateTextureFromSurface(renderer, totalScoreSurface);
-    SDL_Rect totalScoreRect = {SCREEN_WIDTH / 2 - totalScoreSurface->w / 2, SCREEN_HEIGHT / 2 + 100,
-                               totalScoreSurface->w, totalScoreSurface->h};
-    SDL_RenderCopy(renderer, totalScoreTexture, NULL, &totalScoreRect);
+    const TextRenderer::TextImage& totalScoreImage = textRenderer.Cached("gameover.totalScore", totalScoreText, white);
+    SDL_Rect totalScoreRect = {SCREEN_WIDTH / 2 - totalScoreImage.w / 2, SCREEN_HEIGHT / 2 + 100,
+                               totalScoreImage.w, totalScoreImage.h};
+    SDL_RenderCopy(renderer, totalScoreImage.texture, NULL, &totalScoreRect);
 
     // Render thời gian chơi
     std::string timeText = "Play Time: " + std::to_string(minutes) + ":" + (seconds < 10 ? "0" : "") + std::to_string(seconds);
-    SDL_Surface* timeSurface = TTF_RenderText_Solid(font, timeText.c_str(), white);
-    SDL_Texture* timeTexture = SDL_CreateTextureFromSurface(renderer, timeSurface);
-    SDL_Rect timeRect = {SCREEN_WIDTH / 2 - timeSurface->w / 2, SCREEN_HEIGHT / 2 + 150,
-                         timeSurface->w, timeSurface->h};
-    SDL_RenderCopy(renderer, timeTexture, NULL, &timeRect);
+    const TextRenderer::TextImage& timeImage = textRenderer.Cached("gameover.time", timeText, white);
+    SDL_Rect timeRect = {SCREEN_WIDTH / 2 - timeImage.w / 2, SCREEN_HEIGHT / 2 + 150,
+                         timeImage.w, timeImage.h};
+    SDL_RenderCopy(renderer, timeImage.texture, NULL, &timeRect);
 
     // Render high score
-    std::string highScoreText = "High Score: " + std::to_string(highScore);
-    SDL_Surface* highScoreSurface = TTF_RenderText_Solid(font, highScoreText.c_str(), yellow);
-    SDL_Texture* highScoreTexture = SDL_CreateTextureFromSurface(renderer, highScoreSurface);
-    SDL_Rect highScoreRect = {SCREEN_WIDTH / 2 - highScoreSurface->w / 2, SCREEN_HEIGHT / 2 + 200,
-                              highScoreSurface->w, highScoreSurface->h};
-    SDL_RenderCopy(renderer, highScoreTexture, NULL, &highScoreRect);
+    std::string highScoreText = "High Score: " + std::to_string(view.highScore);
+    const TextRenderer::TextImage& highScoreImage = textRenderer.Cached("gameover.highScore", highScoreText, yellow);
+    SDL_Rect highScoreRect = {SCREEN_WIDTH / 2 - highScoreImage.w / 2, SCREEN_HEIGHT / 2 + 200,
+                              highScoreImage.w, highScoreImage.h};
+    SDL_RenderCopy(renderer, highScoreImage.texture, NULL, &highScoreRect);
 
     // Render nút Restart
-    restartButtonRect = {SCREEN_WIDTH / 2 - BUTTON_WIDTH - 50, SCREEN_HEIGHT / 2 + 280, BUTTON_WIDTH, BUTTON_HEIGHT};
+    SDL_Rect restartButtonRect = {SCREEN_WIDTH / 2 - BUTTON_WIDTH - 50, SCREEN_HEIGHT / 2 + 280, BUTTON_WIDTH, BUTTON_HEIGHT};
     SDL_RenderCopy(renderer, restartButtonTexture, NULL, &restartButtonRect);
 
     // Render nút Menu
-    menuButtonRect = {SCREEN_WIDTH / 2 + 50, SCREEN_HEIGHT / 2 + 280, BUTTON_WIDTH, BUTTON_HEIGHT};
-    SDL_RenderCopy(renderer, menuButtonTexture, NULL, &menuButtonRect);
+    SDL_Rect gameOverMenuRect = {SCREEN_WIDTH / 2 + 50, SCREEN_HEIGHT / 2 + 280, BUTTON_WIDTH, BUTTON_HEIGHT};
+    SDL_RenderCopy(renderer, menuButtonTexture, NULL, &gameOverMenuRect);
 
     // Giải phóng bộ nhớ
-    SDL_FreeSurface(player1Surface);
-    SDL_DestroyTexture(player1Texture);
-    SDL_FreeSurface(score1Surface);
-    SDL_DestroyTexture(score1Texture);
-    SDL_FreeSurface(player2Surface);
-    SDL_DestroyTexture(player2Texture);
-    SDL_FreeSurface(score2Surface);
-    SDL_DestroyTexture(score2Texture);
-    SDL_FreeSurface(totalScoreSurface);
-    SDL_DestroyTexture(totalScoreTexture);
-    SDL_FreeSurface(timeSurface);
-    SDL_DestroyTexture(timeTexture);
-    SDL_FreeSurface(highScoreSurface);
-    SDL_DestroyTexture(highScoreTexture);
 }
 
 bool CampaignGame::isGameOver() {
     bool gameIsOver = gameEnded || (!player1.isAlive && !player2.isAlive);
     if (gameIsOver && !showGameOverScreen) {
         showGameOverScreen = true;
-        endGameTime = SDL_GetTicks() - startTime;
+        endGameTime = TicksToMs(simTick);
         int totalScore = player1Info.score + player2Info.score;
         if (totalScore > highScore) highScore = totalScore;
     }
@@ -987,112 +1173,179 @@ bool CampaignGame::isGameOver() {
 }
 
 void CampaignGame::Update() {
-    if (gameEnded || isPaused) return;
-
-    if (player1IsInvincible && !isPlayerInvincible(player1InvincibleStart)) player1IsInvincible = false;
-    if (player2IsInvincible && !isPlayerInvincible(player2InvincibleStart)) player2IsInvincible = false;
-
-    static Uint32 lastTime = SDL_GetTicks();
-    Uint32 currentTime = SDL_GetTicks();
-    float deltaTime = (currentTime - lastTime);
-    lastTime = currentTime;
-
-    updateBulletSystem(deltaTime);
-    updateEnemies();
-    updateDiamond();
-    checkBulletCollisions();
-    checkEnemyPlayerCollision();
-    updateExplosions();
-    spawnEnemy();
-    updateBullets();
-    isGameOver();
+    if (gameEnded || showGameOverScreen || isPaused) {
+        // Không tích lũy thời gian khi đứng yên, tránh chạy dồn tick lúc tiếp tục
+        clock.Reset();
+        return;
+    }
+
+    // Dừng ngay tick hết ván: điểm và high score đã chốt, đạn còn bay không được cộng thêm
+    int ticks = clock.Advance();
+    for (int i = 0; i < ticks && !gameEnded && !showGameOverScreen; i++) {
+        Step();
+    }
+    playPendingSounds();
+}
+
+void CampaignGame::SetPlayerInput(const PlayerInput& input1, const PlayerInput& input2) {
+    player1Input = input1;
+    player2Input = input2;
+}
+
+MatchResult CampaignGame::GetMatchResult() const {
+    return {simTick, player1Info.score, player2Info.score, gameEnded || showGameOverScreen};
+}
+
+void CampaignGame::ReportPoolUsage(std::ostream& out) const {
+    out << "pools: bullets " << bullets.HighWater() << "/" << bullets.Capacity()
+        << " enemies " << enemies.HighWater() << "/" << enemies.Capacity()
+        << " explosions " << explosions.HighWater() << "/" << explosions.Capacity() << std::endl;
+}
+
+void CampaignGame::queueSound(GameSound sound) {
+    if (!headless) pendingSounds.push_back(sound);
+}
+
+void CampaignGame::addAfterBoomMark(float x, float y) {
+    if (!headless) newMarks.Push(QueuedMark{x, y, generation});  // Hàng đợi đầy thì bỏ vết, chỉ là trang trí
+}
+
+void CampaignGame::renderAfterBoomMarks() {
+    // Vết mới được in một lần vào lớp decal, sau đó nằm sẵn trong nền. Vết của ván trước bị bỏ;
+    // vết của ván mới mà snapshot chưa tới thì để lại trong hàng đợi cho tới khi vẽ ván đó.
+    QueuedMark mark;
+    while (newMarks.Peek(mark) && mark.generation <= renderedGeneration) {
+        newMarks.Pop(mark);
+        if (mark.generation != renderedGeneration) continue;
+        SDL_Rect markRect = {static_cast<int>(mark.x - 30), static_cast<int>(mark.y - 30), 60, 60};
+        decals.Stamp(afterBoomSprite, markRect);
+    }
+    decals.Render();
+}
+
+void CampaignGame::playPendingSounds() {
+    for (GameSound sound : pendingSounds) {
+        switch (sound) {
+            case SOUND_SPAWN: Mix_PlayChannel(-1, spawnSound, 0); break;
+            case SOUND_ENEMY_DEATH: Mix_PlayChannel(-1, enemyDeathSound, 0); break;
+            case SOUND_PLAYER_DEATH: Mix_PlayChannel(-1, playerDeathSound, 0); break;
+        }
+    }
+    pendingSounds.clear();
+}
+
+void CampaignGame::Step() {
+    if (player1IsInvincible && !isPlayerInvincible(player1InvincibleUntil)) player1IsInvincible = false;
+    if (player2IsInvincible && !isPlayerInvincible(player2InvincibleUntil)) player2IsInvincible = false;
+
+    savePreviousState();
+    stepGraph.Run(jobs);
+    simTick++;
 }
 
 void CampaignGame::Render() {
+    if (headless) return;
+
+    const Snapshot& view = snapshots.Read();
+    if (view.generation != renderedGeneration) {
+        // Ván mới: bỏ decal của ván trước; vết còn trong hàng đợi được lọc theo generation khi in
+        decals.Clear();
+        renderedGeneration = view.generation;
+    }
+    renderedIdle = view.isPaused || view.showGameOverScreen;
+
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
     SDL_RenderClear(renderer);
 
-    if (showGameOverScreen) {
-        renderGameOverScreen();
+    if (view.showGameOverScreen) {
+        renderGameOverScreen(view);
     } else {
-        SDL_Rect backgroundRect = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
-        SDL_RenderCopy(renderer, backgroundTexture, NULL, &backgroundRect);
+        renderAfterBoomMarks();  // Nền cùng mọi vết cháy, một lần copy
 
         SDL_Rect portalStartRect = {static_cast<int>(PORTAL_START_X), static_cast<int>(PORTAL_START_Y), PORTAL_SIZE, PORTAL_SIZE};
-        SDL_RenderCopy(renderer, portalStartTexture, NULL, &portalStartRect);
+        SDL_RenderCopy(renderer, portalStartSprite.texture, &portalStartSprite.source, &portalStartRect);
 
         SDL_Rect portalEndRect = {static_cast<int>(PORTAL_END_X), static_cast<int>(PORTAL_END_Y), PORTAL_SIZE, PORTAL_SIZE};
-        SDL_RenderCopy(renderer, portalEndTexture, NULL, &portalEndRect);
-
-        for (const auto& mark : afterBoomMarks) {
-            SDL_Rect markRect = {static_cast<int>(mark.x - 30), static_cast<int>(mark.y - 30), 60, 60};
-            SDL_RenderCopy(renderer, afterBoomTexture, NULL, &markRect);
-        }
-
-        for (const auto& bullet : bullets) {
-            SDL_Rect bulletRect = {static_cast<int>(bullet.x - BULLET_SIZE / 2), static_cast<int>(bullet.y - BULLET_SIZE / 2),
+        SDL_RenderCopy(renderer, portalEndSprite.texture, &portalEndSprite.source, &portalEndRect);
+
+        // Vẽ giữa tick trước và tick hiện tại theo thời gian thực, màn hình > 60 Hz vẫn chuyển động mượt
+        float alpha = RenderAlpha(view.alpha, view.publishedAt);
+
+        // Mỗi texture một batch; thứ tự lớp giữ nguyên vì mỗi nhóm dưới đây dùng texture riêng
+        const BulletStore& bullets = view.bullets;
+        for (size_t i = 0; i < bullets.Size(); i++) {
+            // Đạn bay thẳng: vị trí tick trước là vị trí hiện tại trừ một bước vận tốc
+            float bulletX = bullets.x[i] - bullets.vx[i] * (1.0f - alpha);
+            float bulletY = bullets.y[i] - bullets.vy[i] * (1.0f - alpha);
+            SDL_Rect bulletRect = {static_cast<int>(bulletX - BULLET_SIZE / 2), static_cast<int>(bulletY - BULLET_SIZE / 2),
                                    BULLET_SIZE, BULLET_SIZE};
-            SDL_RenderCopyEx(renderer, bulletTexture, NULL, &bulletRect, bullet.angle * 180.0f / M_PI + 90, NULL, SDL_FLIP_NONE);
+            sprites.DrawRotated(bulletSprite, bulletRect, bullets.angle[i] * 180.0f / M_PI + 90);
         }
 
-        for (const auto& explosion : explosions) {
+        for (const Explosion& explosion : view.explosions) {
             SDL_Rect explosionRect = {static_cast<int>(explosion.x - 50), static_cast<int>(explosion.y - 50), 100, 100};
-            SDL_RenderCopy(renderer, boomTexture, NULL, &explosionRect);
+            sprites.Draw(boomSprite, explosionRect);
         }
 
+        Player player1 = LerpPose(view.previousPlayer1, view.player1, alpha);
+        Player player2 = LerpPose(view.previousPlayer2, view.player2, alpha);
         if (player1.isAlive) {
             SDL_Rect player1Rect = {static_cast<int>(player1.x), static_cast<int>(player1.y), PLAYER_WIDTH, PLAYER_HEIGHT};
-            SDL_RenderCopyEx(renderer, playerTexture, NULL, &player1Rect, player1.angle, NULL, SDL_FLIP_NONE);
-            renderShieldEffect(player1.x, player1.y, player1InvincibleStart);
+            sprites.DrawRotated(playerSprite, player1Rect, player1.angle);
         }
-
         if (player2.isAlive) {
             SDL_Rect player2Rect = {static_cast<int>(player2.x), static_cast<int>(player2.y), PLAYER_WIDTH, PLAYER_HEIGHT};
-            SDL_RenderCopyEx(renderer, player2Texture, NULL, &player2Rect, player2.angle, NULL, SDL_FLIP_NONE);
-            renderShieldEffect(player2.x, player2.y, player2InvincibleStart);
+            sprites.DrawRotated(player2Sprite, player2Rect, player2.angle);
         }
-
-        for (const auto& enemy : enemies) {
-            float size = (dynamic_cast<Boss*>(enemy.get()) ? BOSS_SIZE : ENEMY_SIZE);
-            SDL_Rect enemyRect = {static_cast<int>(enemy->x), static_cast<int>(enemy->y), static_cast<int>(size), static_cast<int>(size)};
-            SDL_RenderCopy(renderer, enemy->getTexture(), NULL, &enemyRect);
-
-            if (dynamic_cast<Boss*>(enemy.get())) {
-                SDL_Rect healthBarBg = {enemyRect.x, enemyRect.y - 15, BOSS_SIZE, 10};
-                SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-                SDL_RenderFillRect(renderer, &healthBarBg);
-                SDL_Rect healthBar = {enemyRect.x, enemyRect.y - 15,
-                                      static_cast<int>(BOSS_SIZE * (enemy->health / static_cast<float>(BOSS_HEALTH))), 10};
-                SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-                SDL_RenderFillRect(renderer, &healthBar);
-            } else if (dynamic_cast<Enemy2*>(enemy.get())) {
-                SDL_Rect healthBarBg = {enemyRect.x, enemyRect.y - 10, ENEMY_SIZE, 5};
-                SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-                SDL_RenderFillRect(renderer, &healthBarBg);
-                SDL_Rect healthBar = {enemyRect.x, enemyRect.y - 10,
-                                      static_cast<int>(ENEMY_SIZE * (enemy->health / static_cast<float>(ENEMY2_HEALTH))), 5};
-                SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-                SDL_RenderFillRect(renderer, &healthBar);
-            }
+        // Khiên vẽ sau cả hai xe để batch khiên nằm trên
+        if (player1.isAlive) renderShieldEffect(view, player1, view.player1InvincibleUntil);
+        if (player2.isAlive) renderShieldEffect(view, player2, view.player2InvincibleUntil);
+
+        const EnemyStore& enemies = view.enemies;
+        for (size_t i = 0; i < enemies.Size(); i++) {
+            int size = static_cast<int>(ENEMY_ARCHETYPES[enemies.type[i]].size);
+            SDL_Rect enemyRect = {static_cast<int>(Lerp(enemies.prevX[i], enemies.x[i], alpha)),
+                                  static_cast<int>(Lerp(enemies.prevY[i], enemies.y[i], alpha)), size, size};
+            sprites.Draw(enemySprites[enemies.texture[i]], enemyRect);
+        }
+        sprites.Flush();
+
+        // Thanh máu là một batch màu, flush riêng để luôn nằm trên mọi loại enemy
+        const SDL_Color healthBackColor = {255, 0, 0, 255};
+        const SDL_Color healthFillColor = {0, 255, 0, 255};
+        for (size_t i = 0; i < enemies.Size(); i++) {
+            const EnemyArchetype& archetype = ENEMY_ARCHETYPES[enemies.type[i]];
+            if (archetype.healthBar.height <= 0) continue;
+            int size = static_cast<int>(archetype.size);
+            int barX = static_cast<int>(Lerp(enemies.prevX[i], enemies.x[i], alpha));
+            int barY = static_cast<int>(Lerp(enemies.prevY[i], enemies.y[i], alpha)) - archetype.healthBar.offsetY;
+            SDL_Rect healthBarBg = {barX, barY, size, archetype.healthBar.height};
+            sprites.FillRect(healthBarBg, healthBackColor);
+            SDL_Rect healthBar = {barX, barY, static_cast<int>(size * (enemies.health[i] / static_cast<float>(archetype.health))),
+                                  archetype.healthBar.height};
+            sprites.FillRect(healthBar, healthFillColor);
         }
 
-        if (diamondState != DIAMOND_WITH_ENEMY) {
-            SDL_Rect diamondRect = {static_cast<int>(diamondX), static_cast<int>(diamondY), DIAMOND_SIZE, DIAMOND_SIZE};
-            SDL_RenderCopy(renderer, diamondTexture, NULL, &diamondRect);
+        if (view.diamondState != DIAMOND_WITH_ENEMY) {
+            SDL_Rect diamondRect = {static_cast<int>(Lerp(view.previousDiamondX, view.diamondX, alpha)),
+                                    static_cast<int>(Lerp(view.previousDiamondY, view.diamondY, alpha)), DIAMOND_SIZE, DIAMOND_SIZE};
+            sprites.Draw(diamondSprite, diamondRect);
         } else {
-            auto carrier = std::find_if(enemies.begin(), enemies.end(),
-                                        [this](const auto& e) { return e->id == diamondCarrierID; });
-            if (carrier != enemies.end()) {
-                float carrierSize = (dynamic_cast<Boss*>(carrier->get()) ? BOSS_SIZE : ENEMY_SIZE);
-                SDL_Rect diamondRect = {static_cast<int>((*carrier)->x + carrierSize / 2 - DIAMOND_SIZE / 2),
-                                        static_cast<int>((*carrier)->y - DIAMOND_SIZE / 2), DIAMOND_SIZE, DIAMOND_SIZE};
-                SDL_RenderCopy(renderer, diamondTexture, NULL, &diamondRect);
+            int carrier = view.diamondCarrier;
+            if (carrier != -1) {
+                float carrierSize = ENEMY_ARCHETYPES[enemies.type[carrier]].size;
+                float carrierX = Lerp(enemies.prevX[carrier], enemies.x[carrier], alpha);
+                float carrierY = Lerp(enemies.prevY[carrier], enemies.y[carrier], alpha);
+                SDL_Rect diamondRect = {static_cast<int>(carrierX + carrierSize / 2 - DIAMOND_SIZE / 2),
+                                        static_cast<int>(carrierY - DIAMOND_SIZE / 2), DIAMOND_SIZE, DIAMOND_SIZE};
+                sprites.Draw(diamondSprite, diamondRect);
             }
         }
+        sprites.Flush();
 
-        renderUI();
+        renderUI(view);
 
-        if (isPaused) {
+        if (view.isPaused) {
             SDL_Rect pauseRect = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
             SDL_RenderCopy(renderer, pauseTexture, NULL, &pauseRect);
 
@@ -1103,40 +1356,30 @@ SDL_RenderDrawRect(renderer, &sfxSlider);
 
             SDL_Color white = {255, 255, 255, 255};
             std::string musicText = "Music Volume";
-            SDL_Surface* musicSurface = TTF_RenderText_Solid(font, musicText.c_str(), white);
-            SDL_Texture* musicTexture = SDL_CreateTextureFromSurface(renderer, musicSurface);
-            SDL_Rect musicTextRect = {SCREEN_WIDTH / 2 - musicSurface->w / 2, musicSlider.y - musicSurface->h - 5,
-                                      musicSurface->w, musicSurface->h};
-            SDL_RenderCopy(renderer, musicTexture, NULL, &musicTextRect);
+            const TextRenderer::TextImage& musicImage = textRenderer.Cached("pause.music", musicText, white);
+            SDL_Rect musicTextRect = {SCREEN_WIDTH / 2 - musicImage.w / 2, musicSlider.y - musicImage.h - 5,
+                                      musicImage.w, musicImage.h};
+            SDL_RenderCopy(renderer, musicImage.texture, NULL, &musicTextRect);
 
             SDL_SetRenderDrawColor(renderer, 100, 100, 100, 255);
             SDL_RenderFillRect(renderer, &musicSlider);
-            SDL_Rect musicFill = {musicSlider.x, musicSlider.y, (musicVolume * musicSlider.w) / 128, musicSlider.h};
+            SDL_Rect musicFill = {musicSlider.x, musicSlider.y, (view.musicVolume * musicSlider.w) / 128, musicSlider.h};
             SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
             SDL_RenderFillRect(renderer, &musicFill);
 
             std::string sfxText = "SFX Volume";
-            SDL_Surface* sfxSurface = TTF_RenderText_Solid(font, sfxText.c_str(), white);
-            SDL_Texture* sfxTexture = SDL_CreateTextureFromSurface(renderer, sfxSurface);
-            SDL_Rect sfxTextRect = {SCREEN_WIDTH / 2 - sfxSurface->w / 2, sfxSlider.y - sfxSurface->h - 5,
-                                    sfxSurface->w, sfxSurface->h};
-            SDL_RenderCopy(renderer, sfxTexture, NULL, &sfxTextRect);
+            const TextRenderer::TextImage& sfxImage = textRenderer.Cached("pause.sfx", sfxText, white);
+            SDL_Rect sfxTextRect = {SCREEN_WIDTH / 2 - sfxImage.w / 2, sfxSlider.y - sfxImage.h - 5,
+                                    sfxImage.w, sfxImage.h};
+            SDL_RenderCopy(renderer, sfxImage.texture, NULL, &sfxTextRect);
 
             SDL_SetRenderDrawColor(renderer, 100, 100, 100, 255);
             SDL_RenderFillRect(renderer, &sfxSlider);
-            SDL_Rect sfxFill = {sfxSlider.x, sfxSlider.y, (sfxVolume * sfxSlider.w) / 128, sfxSlider.h};
+            SDL_Rect sfxFill = {sfxSlider.x, sfxSlider.y, (view.sfxVolume * sfxSlider.w) / 128, sfxSlider.h};
             SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
             SDL_RenderFillRect(renderer, &sfxFill);
 
-            menuButtonRect = {SCREEN_WIDTH / 2 - BUTTON_WIDTH / 2, sfxSlider.y + sfxSlider.h + 50, BUTTON_WIDTH, BUTTON_HEIGHT};
             SDL_RenderCopy(renderer, menuButtonTexture, NULL, &menuButtonRect);
-
-            SDL_FreeSurface(musicSurface);
-            SDL_DestroyTexture(musicTexture);
-            SDL_FreeSurface(sfxSurface);
-            SDL_DestroyTexture(sfxTexture);
         }
     }
-
-    SDL_RenderPresent(renderer);
 }
@@ -6,10 +6,26 @@
 #include <SDL_mixer.h>
 #include <SDL_ttf.h>
 #include <vector>
-#include <memory>
 #include <algorithm>
 #include <cmath>
+#include <ctime>
 #include <iostream>
+#include <random>
+#include "simulation.h"
+#include "spatial_grid.h"
+#include "enemy_store.h"
+#include "bullet_store.h"
+#include "flow_field.h"
+#include "job_system.h"
+#include "object_pool.h"
+#include "decal_layer.h"
+#include "text_renderer.h"
+#include "sprite_batch.h"
+#include "texture_atlas.h"
+#include "asset_loader.h"
+#include "sim_thread.h"
+#include "spsc_queue.h"
+#include "triple_buffer.h"
 
 // Các hằng số game
 const int SCREEN_WIDTH = 800;
@@ -63,6 +79,16 @@ const float PORTAL_START_X = SCREEN_WIDTH / 2 - PORTAL_SIZE / 2;
 const float PORTAL_START_Y = 0;
 const float PORTAL_END_X = SCREEN_WIDTH / 2 - PORTAL_SIZE / 2;
 const float PORTAL_END_Y = SCREEN_HEIGHT - PORTAL_SIZE;
+const int COLLISION_CELL_SIZE = 64;
+const float ENEMY_SEPARATION_RANGE = 1.5f;  // Hai enemy đẩy nhau khi tâm gần hơn (tổng nửa kích thước) * hệ số này
+const int MAX_SEPARATION_NEIGHBOURS = 8;
+const int FLOW_CELL_SIZE = 20;
+// Dung lượng các pool, cấp phát một lần khi tạo game; đạn/enemy là mặc định, truyền số khác qua constructor
+const int MAX_LIVE_BULLETS = 64;
+const int MAX_LIVE_ENEMIES = 256;
+const int MAX_EXPLOSIONS = 64;
+const int MAX_AFTER_BOOM_MARKS = 512;  // Vết chờ in vào lớp decal; đầy thì không thêm vết mới
+const int JOB_GRAIN_SIZE = 64;  // Số enemy/đạn mỗi job khi chia việc cho worker
 
 enum DiamondState {
     DIAMOND_ON_GROUND,
@@ -81,112 +107,193 @@ struct Player {
 struct PlayerInfo {
     int lives;
     int score;
-    SDL_Texture* avatar;
-    SDL_Texture* heartTexture;
+    Sprite avatar;
+    Sprite heartSprite;
 };
 
-struct Bullet {
-    float x, y;
-    float angle;
-    Bullet(float x, float y, float angle);
+// Các đích dẫn đường của enemy, mỗi đích có một lớp trong flow field
+enum FlowGoal {
+    FLOW_GOAL_DIAMOND,
+    FLOW_GOAL_PLAYER1,
+    FLOW_GOAL_PLAYER2,
+    FLOW_GOAL_EXIT,
+    FLOW_GOAL_COUNT
 };
 
-struct Enemy {
-    float x, y;
-    int id;
-    int health;
-    SDL_Texture* texture; // Thành viên texture để lưu trữ texture của từng enemy
-    static int nextID;
-    Enemy(float startX, float startY, SDL_Texture* tex, int hp = 1);
-    virtual ~Enemy() = default;
-    virtual float getSpeed() const { return ENEMY_BASE_SPEED; }
-    virtual SDL_Texture* getTexture() const { return texture; } // Trả về texture của enemy
-    virtual int getScoreValue() const { return 10; }
+// Loại enemy, lưu trong EnemyStore::type và dùng làm chỉ số vào ENEMY_ARCHETYPES
+enum EnemyType {
+    ENEMY_BASIC,
+    ENEMY_TYPE2,
+    ENEMY_BOSS,
+    ENEMY_TYPE_COUNT
 };
 
-struct Enemy2 : public Enemy {
-    Enemy2(float startX, float startY, SDL_Texture* tex, Mix_Chunk* sound); // Thêm tham số sound
-    SDL_Texture* getTexture() const override { return texture; }
-    int getScoreValue() const override { return 20; }
-    float getSpeed() const override { return ENEMY2_SPEED; }
+// Thanh máu vẽ phía trên enemy, rộng bằng enemy; height == 0 là không vẽ
+struct HealthBarStyle {
+    int offsetY;
+    int height;
 };
 
-struct Boss : public Enemy {
-    Boss(float startX, float startY, SDL_Texture* tex, Mix_Chunk* sound); // Thêm tham số sound
-    SDL_Texture* getTexture() const override { return texture; }
-    int getScoreValue() const override { return 150; }
-    float getSpeed() const override { return BOSS_SPEED; }
+// Thông số của từng loại enemy. Thêm loại mới chỉ cần thêm một dòng vào bảng
+struct EnemyArchetype {
+    float size;
+    float speed;
+    int health;
+    int scoreValue;
+    int damagePerHit;        // Máu mất đi mỗi lần trúng đạn
+    int diamondHealthBonus;  // Máu được cộng khi cướp được kim cương
+    float separationStrength;  // Tỉ lệ khoảng cách mà enemy này đẩy enemy lân cận ra xa mỗi tick
+    int textureSlot;         // Chỉ số trong CampaignGame::enemySprites
+    HealthBarStyle healthBar;
 };
 
-struct Explosion {
-    float x, y;
-    Uint32 startTime;
-    bool active;
-    Explosion(float x, float y);
+constexpr EnemyArchetype ENEMY_ARCHETYPES[ENEMY_TYPE_COUNT] = {
+    // size        speed             health         score  damage  bonus  push   texture      health bar
+    {ENEMY_SIZE, ENEMY_BASE_SPEED, 1,             10,    1,      0,     0.02f, ENEMY_BASIC, {0, 0}},
+    {ENEMY_SIZE, ENEMY2_SPEED,     ENEMY2_HEALTH, 20,    1,      0,     0.05f, ENEMY_TYPE2, {10, 5}},
+    {BOSS_SIZE,  BOSS_SPEED,       BOSS_HEALTH,   150,   5,      20,    0.05f, ENEMY_BOSS,  {15, 10}},
 };
 
-struct AfterBoomMark {
+// Kích thước lớn nhất trong bảng, dùng làm bán kính truy vấn broadphase
+constexpr float MaxEnemyArchetypeSize() {
+    float maxSize = 0;
+    for (const EnemyArchetype& archetype : ENEMY_ARCHETYPES) {
+        if (archetype.size > maxSize) maxSize = archetype.size;
+    }
+    return maxSize;
+}
+
+struct Explosion {
     float x, y;
-    AfterBoomMark(float x, float y);
+    Uint32 startTick;
+    bool active;
+    Explosion(float x, float y, Uint32 startTick);
 };
 
 struct BulletInfo {
     int currentBullets;
     float reloadTimer;
     std::vector<bool> bulletStates;
-    SDL_Texture* bulletIcon;
+    Sprite bulletIcon;
+
+    // Nạp đầy băng đạn khi chơi lại, dùng lại vector bulletStates thay vì tạo mới
+    void Refill() {
+        currentBullets = static_cast<int>(bulletStates.size());
+        reloadTimer = 0.0f;
+        std::fill(bulletStates.begin(), bulletStates.end(), true);
+    }
 };
 
 class CampaignGame {
 public:
-    CampaignGame(SDL_Renderer* renderer, TTF_Font* font);
+    // renderer == nullptr: chạy headless, không tải texture/âm thanh và không vẽ
+    CampaignGame(SDL_Renderer* renderer, TTF_Font* font, int maxEnemies = MAX_LIVE_ENEMIES,
+                 int maxBullets = MAX_LIVE_BULLETS);
     ~CampaignGame();
 
-    bool Initialize();
-    void Run();
+    bool Initialize();  // Gọi lại được: lần sau dùng tiếp tài nguyên đã nạp, chỉ đặt lại ván chơi
+    void ResetGame();   // Về trạng thái đầu ván, giữ texture/âm thanh và bộ nhớ của các pool
     void Cleanup();
-    void HandleInput();
+    void StopSimulation();  // Chờ thread mô phỏng (do Initialize() chạy) kết thúc
+    // Main thread chuyển input sang thread mô phỏng; QueueKeys() gửi phím điều khiển sau mỗi lượt poll
+    void QueueEvent(const SDL_Event& event);
+    void QueueKeys();
     void Update();
-    bool isRunning() const { return running; }
-    void Render();
+    void Step();  // Chạy đúng một tick mô phỏng
+    void SetTimeScale(double scale) { clock.SetTimeScale(scale); }
+    void Seed(unsigned int seed) { rng.seed(seed); }
+    void SetPlayerInput(const PlayerInput& input1, const PlayerInput& input2);
+    void SetJobSystem(JobSystem* jobSystem) { jobs = jobSystem; }  // nullptr: chạy tuần tự
+    void SetAssetCache(AssetCache* cache) { assets = cache; }  // Gọi trước Initialize(); nullptr: tự tạo cache riêng
+    static void QueueAssets(AssetLoader& loader);  // Xếp hàng đúng các tài nguyên loadResources() nạp, giữ hai nơi khớp nhau
+    MatchResult GetMatchResult() const;
+    void ReportPoolUsage(std::ostream& out) const;  // In số đối tượng sống nhiều nhất / dung lượng của từng pool
+    bool isRunning() const { return headless ? running : simulation.IsRunning(); }
+    void Render();  // Vẽ snapshot mới nhất, không đọc trạng thái thread mô phỏng đang ghi; người gọi present
+    bool IsIdle() { return renderedIdle && !snapshots.HasFresh(); }  // Khung đã vẽ là pause/hết ván và chưa có gì mới
 
 private:
+    // Những gì Render() cần, thread mô phỏng chép ra sau mỗi lượt tick. Pool có dung lượng cố định
+    // nên chép bằng phép gán không cấp phát.
+    struct Snapshot {
+        Uint32 simTick;
+        Uint32 generation;  // Tăng mỗi lần ResetGame(): Render() xóa decal của ván trước
+        float alpha;        // clock.Alpha() lúc công bố; 1 khi đứng yên (pause, hết ván)
+        Uint64 publishedAt;
+        Player player1;
+        Player player2;
+        Player previousPlayer1;  // Trạng thái tick trước, Render() nội suy tới player1/player2
+        Player previousPlayer2;
+        Uint32 player1InvincibleUntil;
+        Uint32 player2InvincibleUntil;
+        PlayerInfo player1Info;
+        PlayerInfo player2Info;
+        BulletInfo player1BulletInfo;
+        BulletInfo player2BulletInfo;
+        BulletStore bullets;
+        EnemyStore enemies;
+        std::vector<Explosion> explosions;
+        DiamondState diamondState;
+        int diamondCarrier;  // Index trong enemies, -1 nếu không có
+        float diamondX;
+        float diamondY;
+        float previousDiamondX;  // Bằng diamondX/Y nếu kim cương vừa đổi người giữ (không nội suy)
+        float previousDiamondY;
+        bool isPaused;
+        bool showGameOverScreen;
+        Uint32 endGameTime;
+        int highScore;
+        int musicVolume;
+        int sfxVolume;
+
+        Snapshot();
+    };
+
     bool running;
+    bool headless;
+    bool resourcesLoaded;
+    std::mt19937 rng;
+    std::vector<GameSound> pendingSounds;
 
     SDL_Renderer* renderer;
     TTF_Font* font;
 
     SDL_Window* window;
-    SDL_Texture* playerTexture;
-    SDL_Texture* player2Texture;
-    SDL_Texture* bulletTexture;
+    Sprite playerSprite;
+    Sprite player2Sprite;
+    Sprite bulletSprite;
     SDL_Texture* backgroundTexture;
-    SDL_Texture* enemyTexture;
-    SDL_Texture* boomTexture;
-    SDL_Texture* afterBoomTexture;
+    Sprite enemySprites[ENEMY_TYPE_COUNT];
+    Sprite boomSprite;
+    Sprite afterBoomSprite;
     Mix_Chunk* enemyDeathSound;
     Mix_Chunk* playerDeathSound;
     Mix_Chunk* spawnSound;
-    Uint32 startTime;
-    Uint32 lastFireTime1;
-    Uint32 lastFireTime2;
-    Uint32 lastSpawnTime;
+    FixedTimestep clock;
+    Uint32 simTick;
+    Uint32 nextFireTick1;
+    Uint32 nextFireTick2;
+    Uint32 nextSpawnTick;
     int spawnRate;
-    SDL_Texture* diamondTexture;
+    Sprite diamondSprite;
     DiamondState diamondState;
     int diamondCarrierID;
     float diamondX;
     float diamondY;
+    // Trạng thái đầu tick vừa chạy, chỉ để Render() nội suy giữa hai tick
+    Player previousPlayer1;
+    Player previousPlayer2;
+    DiamondState previousDiamondState;
+    float previousDiamondX;
+    float previousDiamondY;
     bool gameEnded;
-    SDL_Texture* shieldTexture;
-    Uint32 player1InvincibleStart;
-    Uint32 player2InvincibleStart;
+    Sprite shieldSprite;
+    Uint32 player1InvincibleUntil;
+    Uint32 player2InvincibleUntil;
     bool player1IsInvincible;
     bool player2IsInvincible;
-    SDL_Texture* enemy2Texture;
-    SDL_Texture* portalStartTexture;
-    SDL_Texture* portalEndTexture;
-    SDL_Texture* bossTexture;
+    Sprite portalStartSprite;
+    Sprite portalEndSprite;
     bool isPaused;
     int highScore;
     bool showGameOverScreen;
@@ -197,7 +304,6 @@ private:
     SDL_Rect menuButtonRect;
     SDL_Texture* menuButtonTexture;
     SDL_Texture* restartButtonTexture;
-    SDL_Rect restartButtonRect;
 
     int musicVolume;
     int sfxVolume;
@@ -208,44 +314,98 @@ private:
 
     Player player1;
     Player player2;
+    PlayerInput player1Input;
+    PlayerInput player2Input;
     PlayerInfo player1Info;
     PlayerInfo player2Info;
-    std::vector<Bullet> bullets;
-    std::vector<std::unique_ptr<Enemy>> enemies;
-    std::vector<Explosion> explosions;
-    std::vector<AfterBoomMark> afterBoomMarks;
+    BulletStore bullets;
+    EnemyStore enemies;
+    ObjectPool<Explosion> explosions;
+    DecalLayer decals;  // Nền và mọi vết cháy của ván, của main thread
+    TextRenderer textRenderer;  // Atlas cho HUD, cache cho chữ tĩnh
+    AssetCache* assets;       // Texture, âm thanh, nhạc; dùng chung với Game nếu được truyền vào
+    AssetCache* ownedAssets;  // Cache tự tạo khi không có cache dùng chung
+    TextureAtlas atlas;
+    SpriteBatch sprites;  // Sprite và thanh máu gom theo texture, vẽ bằng SDL_RenderGeometry
     BulletInfo player1BulletInfo;
     BulletInfo player2BulletInfo;
 
+    // Broadphase va chạm đạn - enemy, dựng lại mỗi tick
+    SpatialGrid enemyGrid;
+    std::vector<bool> enemyDead;
+    std::vector<bool> bulletDead;
+    std::vector<float> separationX;
+    std::vector<float> separationY;
+    std::vector<int> bulletHitCandidate;  // Enemy trúng đạn tìm được song song, chưa xét enemy đã chết
+
+    // Dẫn đường cho enemy theo tâm của enemy
+    FlowField flowField;
+
+    // Các pha của Step(); pha độc lập và vòng lặp theo từng entity chạy trên jobs nếu có
+    JobSystem* jobs;
+    PhaseGraph stepGraph;
+
+    // Mô phỏng chạy trên thread riêng khi có renderer; chỉ trao đổi với main thread qua ba thứ dưới đây
+    SimulationThread simulation;
+    SpscQueue<InputMessage, 256> input;
+    struct QueuedMark {
+        float x, y;
+        Uint32 generation;  // Ván đã tạo vết; Render() chỉ in vết của ván đang vẽ
+    };
+    SpscQueue<QueuedMark, MAX_AFTER_BOOM_MARKS> newMarks;  // Vết cháy mới, main thread in vào decals
+    TripleBuffer<Snapshot> snapshots;
+    Uint32 generation;
+    Uint32 renderedGeneration;
+    bool renderedIdle;  // Snapshot vẽ gần nhất đang pause hoặc hết ván: không còn gì chuyển động
 
     // Các hàm hỗ trợ
     bool initSDL();
     SDL_Texture* loadTexture(const char* path);
+    Sprite loadSprite(const char* id);  // Tìm trong atlas trước, không có thì nạp images/CampaignMode/<id>.png
+    void destroySprite(Sprite& sprite);
+    template <typename T>
+    void releaseAsset(T*& asset) {  // Trả tài nguyên về cache và xóa con trỏ, gọi lại lần nữa không sao
+        if (asset && assets) assets->Release(asset);
+        asset = nullptr;
+    }
     void loadResources();
     void closeSDL();
     bool isAtPortalCenter(float x, float y);
-    bool isPathClear(float x1, float y1, float x2, float y2);
+    void initFlowField();
+    void buildStepGraph();
+    FlowGoal selectEnemyGoal(float& goalX, float& goalY);
+    void steerEnemy(size_t index, FlowGoal goal, float goalX, float goalY, float speed);
     bool isSpawnPointClear();
     void spawnEnemy();
     void updateEnemies();
+    void separateEnemies();
     void checkDiamondCollision(float x, float y, int width, int height);
     void updateDiamond();
     void checkBulletCollisions();
     void updateBulletSystem(float deltaTime);
-    void renderUI();
+    void renderUI(const Snapshot& view);
     void checkEnemyPlayerCollision();
     bool checkCollision(float x1, float y1, float w1, float h1, float x2, float y2, float w2, float h2);
     void updateExplosions();
     void updateBullets();
-    bool isPlayerInvincible(Uint32 invincibleStart);
-    void renderShieldEffect(float playerX, float playerY, Uint32 invincibleStart);
+    void updatePlayers();
+    bool isPlayerInvincible(Uint32 invincibleUntil);
+    void renderShieldEffect(const Snapshot& view, const Player& player, Uint32 invincibleUntil);
     bool isMouseOverButton(int mouseX, int mouseY, int buttonX, int buttonY, int buttonW, int buttonH);
-    void handleGameOverInput();
+    void handleEvent(const SDL_Event& e);
+    void handleGameOverClick(int mouseX, int mouseY);
     bool isGameOver();
-    void renderGameOverScreen();
-    void checkEnemyDiamondCollision(Enemy* enemy);
-    void handleEnemyDiamondPickup(Enemy* enemy);
+    void renderGameOverScreen(const Snapshot& view);
+    bool checkEnemyDiamondCollision(size_t index);
+    int findBulletHit(size_t bullet, bool skipDead);
     void dropDiamond(float x, float y);
+    void queueSound(GameSound sound);
+    void addAfterBoomMark(float x, float y);
+    void renderAfterBoomMarks();  // Main thread: in vết mới từ newMarks vào decals rồi vẽ nền kèm vết
+    void playPendingSounds();
+    bool simulateFrame();  // Một vòng của thread mô phỏng; false khi thoát về menu
+    void publishSnapshot();
+    void savePreviousState();  // Đầu mỗi tick và khi ResetGame(): lưu vị trí để nội suy
 };
 
 #endif // CAMPAIGN_GAME_H
@@ -0,0 +1,85 @@
+#include "decal_layer.h"
+#include <iostream>
+
+DecalLayer::DecalLayer() : renderer(nullptr), background(nullptr), target(nullptr) {}
+
+DecalLayer::~DecalLayer() {
+    Destroy();
+}
+
+bool DecalLayer::Create(SDL_Renderer* rend, SDL_Texture* backgroundTexture, int width, int height) {
+    Destroy();
+    renderer = rend;
+    background = backgroundTexture;
+    stamped.reserve(512);  // Đủ cho một ván thường; ván dài hơn thì vector tự nới
+    if (!renderer || !SDL_RenderTargetSupported(renderer)) return false;
+
+    target = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
+    if (!target) {
+        std::cerr << "Unable to create decal target! SDL_Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    // Target đục (đã có nền) nên chép ra không cần blend, không phụ thuộc blend mode tùy chỉnh
+    SDL_SetTextureBlendMode(target, SDL_BLENDMODE_NONE);
+    redraw();
+    return true;
+}
+
+void DecalLayer::Destroy() {
+    if (target) {
+        SDL_DestroyTexture(target);
+        target = nullptr;
+    }
+    background = nullptr;  // Nền và sprite của vết thuộc người gọi, có thể được giải phóng ngay sau đây
+    stamped.clear();
+}
+
+void DecalLayer::Stamp(const Sprite& sprite, const SDL_Rect& destRect) {
+    if (!renderer || !sprite.texture) return;
+    stamped.push_back(StampedDecal{sprite, destRect});
+    if (!target) return;
+
+    SDL_Texture* previous = SDL_GetRenderTarget(renderer);
+    SDL_SetRenderTarget(renderer, target);
+    SDL_RenderCopy(renderer, sprite.texture, &sprite.source, &destRect);
+    SDL_SetRenderTarget(renderer, previous);
+}
+
+void DecalLayer::Clear() {
+    stamped.clear();
+    redraw();
+}
+
+void DecalLayer::Restore() {
+    redraw();
+}
+
+void DecalLayer::redraw() {
+    if (!target) return;
+    SDL_Texture* previous = SDL_GetRenderTarget(renderer);
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+    SDL_SetRenderTarget(renderer, target);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    if (background) SDL_RenderCopy(renderer, background, nullptr, nullptr);
+    for (const StampedDecal& decal : stamped) {
+        SDL_RenderCopy(renderer, decal.sprite.texture, &decal.sprite.source, &decal.destRect);
+    }
+    SDL_SetRenderTarget(renderer, previous);
+    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+}
+
+void DecalLayer::Render(const SDL_Rect* destRect) {
+    if (target) {
+        SDL_RenderCopy(renderer, target, nullptr, destRect);
+        return;
+    }
+
+    // Không có render target: vẽ nền rồi từng vết như trước khi có lớp decal
+    if (background) SDL_RenderCopy(renderer, background, nullptr, destRect);
+    for (const StampedDecal& decal : stamped) {
+        SDL_RenderCopy(renderer, decal.sprite.texture, &decal.sprite.source, &decal.destRect);
+    }
+}
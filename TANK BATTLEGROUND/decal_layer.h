@@ -0,0 +1,41 @@
+#ifndef DECAL_LAYER_H
+#define DECAL_LAYER_H
+
+#include <SDL.h>
+#include <vector>
+#include "texture_atlas.h"
+
+// Lớp nền có vết (decal): một render target đục chứa ảnh nền, mỗi vết chỉ được in một lần vào đó
+// bằng alpha blend thường. Render() chép target ra màn hình thay cho ảnh nền, nên mỗi frame chỉ tốn
+// một lần copy dù đã có bao nhiêu vết, trên mọi renderer kể cả renderer software.
+// Vết đã in được nhớ lại để in lại khi nội dung target mất (SDL_RENDER_TARGETS_RESET).
+// Renderer không hỗ trợ render target thì IsReady() = false và Render() vẽ nền rồi từng vết mỗi frame.
+class DecalLayer {
+public:
+    DecalLayer();
+    ~DecalLayer();
+
+    bool Create(SDL_Renderer* renderer, SDL_Texture* background, int width, int height);
+    void Destroy();
+    bool IsReady() const { return target != nullptr; }
+
+    void Stamp(const Sprite& sprite, const SDL_Rect& destRect);  // In vết vào target
+    void Clear();    // Ván mới: bỏ mọi vết, target chỉ còn ảnh nền
+    void Restore();  // Sau SDL_RENDER_TARGETS_RESET: vẽ lại nền và in lại mọi vết đã in
+    void Render(const SDL_Rect* destRect = nullptr);  // Vẽ thay cho ảnh nền
+
+private:
+    struct StampedDecal {
+        Sprite sprite;
+        SDL_Rect destRect;
+    };
+
+    void redraw();  // Nền rồi mọi vết trong stamped, vào target
+
+    SDL_Renderer* renderer;
+    SDL_Texture* background;
+    SDL_Texture* target;
+    std::vector<StampedDecal> stamped;
+};
+
+#endif // DECAL_LAYER_H
@@ -0,0 +1,74 @@
+#include "enemy_store.h"
+#include <algorithm>
+
+EnemyStore::EnemyStore(size_t capacity) : capacity(capacity), highWater(0), nextID(0) {
+    x.reserve(capacity);
+    y.reserve(capacity);
+    prevX.reserve(capacity);
+    prevY.reserve(capacity);
+    health.reserve(capacity);
+    type.reserve(capacity);
+    texture.reserve(capacity);
+    id.reserve(capacity);
+}
+
+int EnemyStore::Add(float startX, float startY, Uint8 enemyType, Uint8 textureIndex, int hp) {
+    if (Full()) return -1;
+    x.push_back(startX);
+    y.push_back(startY);
+    prevX.push_back(startX);  // Enemy mới không nội suy từ đâu cả
+    prevY.push_back(startY);
+    health.push_back(hp);
+    type.push_back(enemyType);
+    texture.push_back(textureIndex);
+    id.push_back(nextID);
+    highWater = std::max(highWater, x.size());
+    return nextID++;
+}
+
+int EnemyStore::IndexOf(int enemyID) const {
+    for (size_t i = 0; i < id.size(); i++) {
+        if (id[i] == enemyID) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+void EnemyStore::Compact(const std::vector<bool>& dead) {
+    size_t kept = 0;
+    for (size_t i = 0; i < x.size(); i++) {
+        if (dead[i]) continue;
+        x[kept] = x[i];
+        y[kept] = y[i];
+        prevX[kept] = prevX[i];
+        prevY[kept] = prevY[i];
+        health[kept] = health[i];
+        type[kept] = type[i];
+        texture[kept] = texture[i];
+        id[kept] = id[i];
+        kept++;
+    }
+    x.resize(kept);
+    y.resize(kept);
+    prevX.resize(kept);
+    prevY.resize(kept);
+    health.resize(kept);
+    type.resize(kept);
+    texture.resize(kept);
+    id.resize(kept);
+}
+
+void EnemyStore::SavePrevious() {
+    std::copy(x.begin(), x.end(), prevX.begin());
+    std::copy(y.begin(), y.end(), prevY.begin());
+}
+
+void EnemyStore::Clear() {
+    x.clear();
+    y.clear();
+    prevX.clear();
+    prevY.clear();
+    health.clear();
+    type.clear();
+    texture.clear();
+    id.clear();
+}
@@ -0,0 +1,42 @@
+#ifndef ENEMY_STORE_H
+#define ENEMY_STORE_H
+
+#include <SDL.h>
+#include <vector>
+
+// Lưu enemy theo dạng structure-of-arrays: mỗi thuộc tính là một mảng liên tục,
+// enemy thứ i là phần tử thứ i của mọi mảng. Vòng lặp update/render duyệt tuần tự,
+// không phải đuổi theo con trỏ và vtable như vector<unique_ptr<Enemy>>.
+// id ổn định suốt đời enemy (dùng để theo dõi enemy đang cầm kim cương), index thì không.
+// Dung lượng cố định, cấp phát một lần lúc tạo: thêm/xóa enemy trong lúc chơi không cấp phát.
+struct EnemyStore {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> prevX;  // Vị trí ở tick trước, để Render() nội suy giữa hai tick
+    std::vector<float> prevY;
+    std::vector<int> health;
+    std::vector<Uint8> type;     // Loại enemy, ý nghĩa do từng chế độ chơi quy định
+    std::vector<Uint8> texture;  // Chỉ số texture trong bảng texture của chế độ chơi
+    std::vector<int> id;
+
+    explicit EnemyStore(size_t capacity);
+
+    size_t Size() const { return x.size(); }
+    bool Empty() const { return x.empty(); }
+    bool Full() const { return x.size() >= capacity; }
+    size_t Capacity() const { return capacity; }
+    size_t HighWater() const { return highWater; }  // Số enemy sống nhiều nhất từng có
+
+    int Add(float startX, float startY, Uint8 enemyType, Uint8 textureIndex, int hp);  // Trả về id, -1 nếu đầy
+    int IndexOf(int enemyID) const;  // -1 nếu không còn
+    void Compact(const std::vector<bool>& dead);  // Xóa mọi enemy có dead[i], giữ thứ tự
+    void SavePrevious();  // Gọi đầu mỗi tick: prevX/prevY = x/y
+    void Clear();
+
+private:
+    size_t capacity;
+    size_t highWater;
+    int nextID;
+};
+
+#endif // ENEMY_STORE_H
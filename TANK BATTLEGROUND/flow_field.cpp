@@ -0,0 +1,117 @@
+#include "flow_field.h"
+#include <cmath>
+#include <functional>
+#include <limits>
+
+static const float UNREACHABLE = std::numeric_limits<float>::max();
+
+FlowField::FlowField(float minX, float minY, float maxX, float maxY, float cellSize, int goalCount)
+    : minX(minX), minY(minY), cellSize(cellSize),
+      cols(std::max(1, static_cast<int>(std::ceil((maxX - minX) / cellSize)))),
+      rows(std::max(1, static_cast<int>(std::ceil((maxY - minY) / cellSize)))),
+      walkable(cols * rows, true),
+      layers(goalCount, Layer{-1, {}, {}, {}}) {}
+
+void FlowField::SetWalkable(int col, int row, bool canWalk) {
+    walkable[row * cols + col] = canWalk;
+    for (Layer& layer : layers) layer.goalCell = -1;
+}
+
+bool FlowField::SetGoal(int goal, float x, float y) {
+    Layer& layer = layers[goal];
+    int cell = cellAt(x, y);
+    if (cell == layer.goalCell) return false;
+    layer.goalCell = cell;
+    rebuild(layer);
+    return true;
+}
+
+bool FlowField::GetDirection(int goal, float x, float y, float& dirX, float& dirY) const {
+    const Layer& layer = layers[goal];
+    int cell = cellAt(x, y);
+    if (layer.goalCell == -1 || cell == layer.goalCell || layer.distance[cell] == UNREACHABLE) return false;
+    dirX = layer.dirX[cell];
+    dirY = layer.dirY[cell];
+    return dirX != 0.0f || dirY != 0.0f;
+}
+
+void FlowField::rebuild(Layer& layer) {
+    const int cellCount = cols * rows;
+    layer.distance.assign(cellCount, UNREACHABLE);
+    layer.dirX.assign(cellCount, 0.0f);
+    layer.dirY.assign(cellCount, 0.0f);
+
+    // Dijkstra 8 hướng từ ô đích; đi chéo chỉ khi cả hai ô cạnh đều đi được (không cắt góc tường)
+    typedef std::pair<float, int> Node;
+    std::greater<Node> heapOrder;
+    openHeap.clear();
+    layer.distance[layer.goalCell] = 0.0f;
+    openHeap.push_back(Node(0.0f, layer.goalCell));
+
+    const int dCol[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+    const int dRow[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+    const float stepCost[8] = {1, 1, 1, 1, 1.41421356f, 1.41421356f, 1.41421356f, 1.41421356f};
+
+    while (!openHeap.empty()) {
+        std::pop_heap(openHeap.begin(), openHeap.end(), heapOrder);
+        Node node = openHeap.back();
+        openHeap.pop_back();
+        int cell = node.second;
+        if (node.first > layer.distance[cell]) continue;
+
+        int col = cell % cols;
+        int row = cell / cols;
+        for (int k = 0; k < 8; k++) {
+            int nCol = col + dCol[k];
+            int nRow = row + dRow[k];
+            if (nCol < 0 || nCol >= cols || nRow < 0 || nRow >= rows) continue;
+            int next = nRow * cols + nCol;
+            if (!walkable[next]) continue;
+            if (k >= 4 && (!walkable[row * cols + nCol] || !walkable[nRow * cols + col])) continue;
+
+            float nextDistance = node.first + stepCost[k];
+            if (nextDistance < layer.distance[next]) {
+                layer.distance[next] = nextDistance;
+                openHeap.push_back(Node(nextDistance, next));
+                std::push_heap(openHeap.begin(), openHeap.end(), heapOrder);
+            }
+        }
+    }
+
+    // Hướng đi = ngược gradient của trường khoảng cách, cho hướng mượt thay vì chỉ 8 hướng.
+    // Ô cạnh không tới được lấy khoảng cách của chính ô đang xét.
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++) {
+            int cell = row * cols + col;
+            float own = layer.distance[cell];
+            if (own == UNREACHABLE || cell == layer.goalCell) continue;
+
+            auto neighbour = [&](int nCol, int nRow) {
+                if (nCol < 0 || nCol >= cols || nRow < 0 || nRow >= rows) return own;
+                float d = layer.distance[nRow * cols + nCol];
+                return d == UNREACHABLE ? own : d;
+            };
+            float gx = neighbour(col - 1, row) - neighbour(col + 1, row);
+            float gy = neighbour(col, row - 1) - neighbour(col, row + 1);
+
+            if (std::fabs(gx) + std::fabs(gy) < 1e-4f) {
+                // Gradient triệt tiêu (điểm yên ngựa): đi về ô lân cận gần đích nhất
+                float best = own;
+                for (int k = 0; k < 8; k++) {
+                    float d = neighbour(col + dCol[k], row + dRow[k]);
+                    if (d < best) {
+                        best = d;
+                        gx = static_cast<float>(dCol[k]);
+                        gy = static_cast<float>(dRow[k]);
+                    }
+                }
+            }
+
+            float length = std::sqrt(gx * gx + gy * gy);
+            if (length > 0) {
+                layer.dirX[cell] = gx / length;
+                layer.dirY[cell] = gy / length;
+            }
+        }
+    }
+}
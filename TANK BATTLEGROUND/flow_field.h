@@ -0,0 +1,52 @@
+#ifndef FLOW_FIELD_H
+#define FLOW_FIELD_H
+
+#include <vector>
+#include <algorithm>
+
+// Trường hướng (flow field) trên lưới đồng nhất. Mỗi goal có một trường khoảng cách riêng,
+// chỉ tính lại khi goal chuyển sang ô khác; agent tra hướng đi của ô mình đang đứng trong O(1).
+// Chi phí tính lại tỉ lệ với số ô của bản đồ, không phụ thuộc số agent.
+class FlowField {
+public:
+    FlowField(float minX, float minY, float maxX, float maxY, float cellSize, int goalCount);
+
+    int Cols() const { return cols; }
+    int Rows() const { return rows; }
+    float CellCenterX(int col) const { return minX + (col + 0.5f) * cellSize; }
+    float CellCenterY(int row) const { return minY + (row + 0.5f) * cellSize; }
+
+    // Đổi ô đi được sẽ buộc mọi goal tính lại ở lần SetGoal tiếp theo
+    void SetWalkable(int col, int row, bool canWalk);
+
+    // Đặt vị trí goal; trả về true nếu trường của goal vừa được tính lại
+    bool SetGoal(int goal, float x, float y);
+
+    // Hướng đi (đã chuẩn hóa) tại (x, y). Trả về false khi đang ở ngay ô đích
+    // hoặc ô không tới được goal: khi đó agent tự đi thẳng tới goal.
+    bool GetDirection(int goal, float x, float y, float& dirX, float& dirY) const;
+
+private:
+    struct Layer {
+        int goalCell;
+        std::vector<float> distance;
+        std::vector<float> dirX;
+        std::vector<float> dirY;
+    };
+
+    int cellAt(float x, float y) const {
+        int col = std::max(0, std::min(cols - 1, static_cast<int>((x - minX) / cellSize)));
+        int row = std::max(0, std::min(rows - 1, static_cast<int>((y - minY) / cellSize)));
+        return row * cols + col;
+    }
+    void rebuild(Layer& layer);
+
+    float minX, minY;
+    float cellSize;
+    int cols, rows;
+    std::vector<bool> walkable;
+    std::vector<Layer> layers;
+    std::vector<std::pair<float, int>> openHeap;  // Dùng lại giữa các lần rebuild, tránh cấp phát
+};
+
+#endif // FLOW_FIELD_H
@@ -0,0 +1,106 @@
+#include "frame_pacer.h"
+#include <cstdlib>
+#include <cstring>
+
+FramePacer::FramePacer()
+    : pacing(FRAME_PACING_VSYNC), sleeps(false), frequency(SDL_GetPerformanceFrequency()), period(0),
+      deadline(0), lastFrameEnd(0), frames(0), missed(0), worstFrameMs(0.0) {}
+
+void FramePacer::Configure(SDL_Renderer* renderer, FramePacing newPacing, int targetFps) {
+    pacing = newPacing;
+
+    // Tần số màn hình đang chứa cửa sổ; driver không báo thì coi như 60 Hz
+    int refreshRate = 0;
+    SDL_Window* window = renderer ? SDL_RenderGetWindow(renderer) : nullptr;
+    int display = window ? SDL_GetWindowDisplayIndex(window) : 0;
+    SDL_DisplayMode displayMode;
+    if (SDL_GetCurrentDisplayMode(display < 0 ? 0 : display, &displayMode) == 0) refreshRate = displayMode.refresh_rate;
+    if (refreshRate <= 0) refreshRate = 60;
+
+    bool vsync = false;
+    if (renderer) {
+        // Chỉ chế độ vsync mới để present chờ refresh, hai chế độ kia tự giữ nhịp
+        SDL_RenderSetVSync(renderer, pacing == FRAME_PACING_VSYNC ? 1 : 0);
+        SDL_RendererInfo info;
+        vsync = SDL_GetRendererInfo(renderer, &info) == 0 && (info.flags & SDL_RENDERER_PRESENTVSYNC) != 0;
+    }
+
+    int fps = 0;
+    switch (pacing) {
+        case FRAME_PACING_VSYNC: fps = refreshRate; break;
+        case FRAME_PACING_UNCAPPED: fps = 0; break;
+        case FRAME_PACING_TARGET: fps = targetFps > 0 ? targetFps : refreshRate; break;
+    }
+    period = fps > 0 ? frequency / fps : 0;
+    sleeps = period > 0 && !(pacing == FRAME_PACING_VSYNC && vsync);
+    Reset();
+}
+
+void FramePacer::Reset() {
+    lastFrameEnd = 0;
+    deadline = 0;
+}
+
+void FramePacer::EndFrame() {
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (lastFrameEnd == 0) {
+        lastFrameEnd = now;
+        deadline = now + period;
+        return;
+    }
+
+    if (sleeps) {
+        if (now > deadline) {
+            missed++;
+            deadline = now;  // Trễ rồi thì tính lại từ bây giờ, không rút ngắn các khung sau để đuổi kịp
+        } else {
+            sleepUntil(deadline);
+        }
+        deadline += period;
+    } else if (period > 0 && now - lastFrameEnd > period + period / 2) {
+        missed++;  // Vsync: khung dài hơn 1.5 chu kỳ là đã lỡ ít nhất một lần refresh
+    }
+
+    now = SDL_GetPerformanceCounter();
+    double frameMs = (now - lastFrameEnd) * 1000.0 / frequency;
+    if (frameMs > worstFrameMs) worstFrameMs = frameMs;
+    lastFrameEnd = now;
+    frames++;
+}
+
+void FramePacer::sleepUntil(Uint64 target) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    Uint64 spin = frequency * SPIN_MS / 1000;
+    if (target > now + spin) {
+        SDL_Delay(static_cast<Uint32>((target - now - spin) * 1000 / frequency));
+    }
+    while (SDL_GetPerformanceCounter() < target) {}
+}
+
+void FramePacer::Report(const char* what, std::ostream& out) const {
+    static const char* const NAMES[] = {"vsync", "uncapped", "target"};
+    out << what << " frames: " << frames << " (" << NAMES[pacing] << ")"
+        << ", missed deadlines " << missed << ", worst frame " << worstFrameMs << " ms" << std::endl;
+}
+
+bool ParseFramePacingArgs(int argc, char* argv[], FramePacing& pacing, int& targetFps) {
+    bool found = false;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if (strcmp(arg, "--vsync") == 0) {
+            pacing = FRAME_PACING_VSYNC;
+            found = true;
+        } else if (strcmp(arg, "--uncapped") == 0) {
+            pacing = FRAME_PACING_UNCAPPED;
+            found = true;
+        } else if (strcmp(arg, "--fps") == 0 && value) {
+            pacing = FRAME_PACING_TARGET;
+            targetFps = atoi(value);
+            found = true;
+            i++;
+        }
+    }
+    return found;
+}
@@ -0,0 +1,50 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <SDL.h>
+#include <iostream>
+
+// Cách giữ nhịp khung hình của vòng lặp vẽ
+enum FramePacing {
+    FRAME_PACING_VSYNC,     // SDL_RenderPresent() chờ refresh; renderer không có vsync thì ngủ theo tần số màn hình
+    FRAME_PACING_UNCAPPED,  // Không chờ gì, vẽ nhanh nhất có thể
+    FRAME_PACING_TARGET     // Ngủ cho đủ 1000 / targetFps ms mỗi khung
+};
+
+// Thay cho SDL_Delay(16) sau mỗi khung: chỉ ngủ phần còn lại của ngân sách khung hình, đo bằng
+// SDL_GetPerformanceCounter(). Mốc khung sau = mốc khung trước + một chu kỳ, nên ngủ quá vài phần
+// mười ms ở khung này được bù ở khung sau. Khung làm việc quá ngân sách được tính là trễ và mốc
+// bắt đầu lại từ lúc đó thay vì chạy dồn.
+class FramePacer {
+public:
+    FramePacer();
+
+    // Bật/tắt vsync của renderer theo pacing và tính ngân sách khung; gọi lại được bất cứ lúc nào
+    void Configure(SDL_Renderer* renderer, FramePacing pacing, int targetFps);
+    void Reset();     // Bỏ mốc cũ, vd. khi vòng lặp khác vừa chiếm quyền một lúc
+    void EndFrame();  // Gọi ngay sau SDL_RenderPresent()
+
+    Uint32 FrameCount() const { return frames; }
+    Uint32 MissedFrames() const { return missed; }
+    void Report(const char* what, std::ostream& out) const;  // Số khung, số khung trễ, khung lâu nhất
+
+private:
+    void sleepUntil(Uint64 deadline);
+
+    static const int SPIN_MS = 2;  // SDL_Delay() có thể ngủ quá chừng này; phần cuối chờ bận cho chính xác
+
+    FramePacing pacing;
+    bool sleeps;      // false khi present đã tự chờ vsync hoặc không giới hạn
+    Uint64 frequency;
+    Uint64 period;    // Số đếm performance counter mỗi khung; 0 khi không giới hạn
+    Uint64 deadline;
+    Uint64 lastFrameEnd;  // 0: chưa có khung nào kể từ Reset()
+    Uint32 frames;
+    Uint32 missed;
+    double worstFrameMs;
+};
+
+// Đọc --vsync, --uncapped, --fps <n> từ dòng lệnh; trả về true nếu có một trong số đó
+bool ParseFramePacingArgs(int argc, char* argv[], FramePacing& pacing, int& targetFps);
+
+#endif // FRAME_PACER_H
@@ -1,17 +1,25 @@
 #include "game.h"
 #include <iostream>
 
-Game::Game() : window(nullptr), renderer(nullptr), font(nullptr),
+Game::Game() : window(nullptr), renderer(nullptr), framePacing(FRAME_PACING_VSYNC), targetFps(0), font(nullptr),
                menuBackground(nullptr), optionsBackground(nullptr),
                chooseModeBackground(nullptr), modeBackground(nullptr),
                helpBackground(nullptr),
                backgroundMusic(nullptr), clickSound(nullptr),
-               isRunning(false), currentState(MAIN_MENU),
+               isRunning(false),
+               mainMenuScene(*this), optionsScene(*this), modeSelectionScene(*this),
+               helpScene(*this), loadingScene(*this), campaignScene(*this), survivalScene(*this),
+               renderedScene(nullptr), dirty(true), lastInputTicks(0),
                volumeLevel(0.8f), sfxVolumeLevel(0.7f), // Đổi từ brightnessLevel
                draggingVolume(false), draggingSFXVolume(false), // Đổi từ draggingBrightness
-               campaignGame(nullptr), currentHelpPage(1),
+               helpPage1(nullptr), helpPage2(nullptr), helpPage3(nullptr),
+               currentHelpPage(1),
 nextPageButton{665, 685, 101, 78},
-prevPageButton{667, 580, 101, 83} {
+prevPageButton{667, 580, 101, 83},
+campaignGame(nullptr), survivalGame(nullptr), jobSystem(nullptr), assets(nullptr),
+               loader(nullptr), loadingTarget(MAIN_MENU), loadProgress(0.0f), loadStartTicks(0),
+               prefetch(nullptr), prefetchTarget(CAMPAIGN_GAME), preferredMode(CAMPAIGN_GAME),
+               pendingReport(nullptr) {
 
     // Nút menu chính
     playButton = {250, 350, 300, 80};
@@ -49,9 +57,15 @@ void Game::UpdateSlider(int mouseX, SDL_Rect& slider, SDL_Rect& track, float& va
 }
 
 Game::~Game() {
-    if (campaignGame) {
-        delete campaignGame;
-    }
+    // Hai mode giữ tham chiếu vào cache nên phải hủy trước Cleanup()
+    delete campaignGame;
+    campaignGame = nullptr;
+    delete survivalGame;
+    survivalGame = nullptr;
+    CancelPrefetch();
+    delete loader;  // Chờ job giải mã trước khi dừng worker
+    loader = nullptr;
+    delete jobSystem;
     Cleanup();
 }
 
@@ -61,6 +75,8 @@ bool Game::Initialize(const char* title, int width, int height) {
         return false;
     }
 
+    jobSystem = new JobSystem(JobSystem::DefaultWorkerCount());
+
     if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) {
         std::cerr << "SDL_mixer could not initialize! Error: " << Mix_GetError() << std::endl;
         return false;
@@ -77,15 +93,11 @@ bool Game::Initialize(const char* title, int width, int height) {
         std::cerr << "Renderer could not be created! Error: " << SDL_GetError() << std::endl;
         return false;
     }
-
-    helpPage1 = LoadTexture("images/page1.png");
-helpPage2 = LoadTexture("images/page2.png");
-helpPage3 = LoadTexture("images/page3.png");
-
-if (!helpPage1 || !helpPage2 || !helpPage3) {
-    std::cerr << "Failed to load help pages! Error: " << IMG_GetError() << std::endl;
-    return false;
-}
+    pacer.Configure(renderer, framePacing, targetFps);
+    assets = new AssetCache(renderer);
+    if (pack.Open(AssetPack::FILE_NAME)) {
+        assets->SetPack(&pack);
+    }
 
     int imgFlags = IMG_INIT_PNG;
     if (!(IMG_Init(imgFlags) & imgFlags)) {
@@ -98,11 +110,41 @@ if (!helpPage1 || !helpPage2 || !helpPage3) {
         return false;
     }
 
-    font = TTF_OpenFont("fonts/VCOOPERB.ttf", 28);
+    font = TTF_OpenFontRW(assets->OpenFile("fonts/VCOOPERB.ttf"), 1, 28);
     if (!font) {
         std::cerr << "Failed to load VCOOPERB font! Error: " << TTF_GetError() << std::endl;
         return false;
     }
+    textRenderer.Create(renderer, font);
+
+    // Ảnh và âm thanh của menu được giải mã trên worker; Run() vẽ thanh tiến độ tới khi nạp xong
+    AssetLoader& menuAssets = BeginLoading(MAIN_MENU);
+    loadStartTicks = 0;  // Lúc khởi động tính từ SDL_Init()
+    menuAssets.QueueTexture("images/page1.png");
+    menuAssets.QueueTexture("images/page2.png");
+    menuAssets.QueueTexture("images/page3.png");
+    menuAssets.QueueTexture("images/menu_game.png");
+    menuAssets.QueueTexture("images/options_bg.png");
+    menuAssets.QueueTexture("images/mode_selection_bg.png");
+    menuAssets.QueueTexture("images/help.png");
+    menuAssets.QueueMusic("audio/waiting_hall.mp3");
+    menuAssets.QueueChunk("audio/click_sound.mp3");
+
+    //Mix_PlayMusic(backgroundMusic, -1);
+    Mix_VolumeMusic(static_cast<int>(volumeLevel * MIX_MAX_VOLUME));
+
+    isRunning = true;
+    return true;
+}
+
+bool Game::AcquireMenuAssets() {
+    helpPage1 = LoadTexture("images/page1.png");
+    helpPage2 = LoadTexture("images/page2.png");
+    helpPage3 = LoadTexture("images/page3.png");
+    if (!helpPage1 || !helpPage2 || !helpPage3) {
+        std::cerr << "Failed to load help pages!" << std::endl;
+        return false;
+    }
 
     menuBackground = LoadTexture("images/menu_game.png");
     if (!menuBackground) {
@@ -117,34 +159,144 @@ if (!helpPage1 || !helpPage2 || !helpPage3) {
     modeBackground = LoadTexture("images/mode_selection_bg.png");
     helpBackground = LoadTexture("images/help.png");
     if (!helpBackground) {
-        std::cerr << "Failed to load help background! Error: " << IMG_GetError() << std::endl;
+        std::cerr << "Failed to load help background!" << std::endl;
         return false;
     }
 
-    backgroundMusic = Mix_LoadMUS("audio/waiting_hall.mp3");
+    backgroundMusic = assets->AcquireMusic("audio/waiting_hall.mp3");
     if (!backgroundMusic) {
-        std::cerr << "Failed to load background music! Error: " << Mix_GetError() << std::endl;
         return false;
     }
 
     clickSound = LoadSound("audio/click_sound.mp3");
-    if (!clickSound) {
-        return false;
+    return clickSound != nullptr;
+}
+
+AssetLoader& Game::BeginLoading(GameState target) {
+    delete loader;
+    if (prefetch && prefetchTarget == target) {
+        // Đã nạp trước đúng mode này: dùng tiếp loader đó, phần đã xong không phải làm lại
+        loader = prefetch;
+        prefetch = nullptr;
+    } else {
+        CancelPrefetch();
+        loader = new AssetLoader(*assets, jobSystem);
+    }
+    loader->SetProgressCallback([this](int done, int total) {
+        loadProgress = static_cast<float>(done) / total;
+    });
+    loadingTarget = target;
+    loadProgress = loader->Total() > 0 ? static_cast<float>(loader->Completed()) / loader->Total() : 0.0f;
+    if (target != MAIN_MENU) preferredMode = target;
+    loadStartTicks = SDL_GetTicks();
+    scenes.Push(&loadingScene);
+    return *loader;
+}
+
+void Game::StartPrefetch(GameState mode) {
+    if (prefetch && prefetchTarget == mode) return;
+    CancelPrefetch();
+    prefetch = new AssetLoader(*assets, jobSystem);
+    prefetchTarget = mode;
+    QueueModeAssets(mode, *prefetch);
+}
+
+void Game::CancelPrefetch() {
+    if (!prefetch) return;
+    prefetch->Cancel();
+    delete prefetch;  // Chỉ chờ các job đang giải mã dở; job chưa chạy thoát ngay
+    prefetch = nullptr;
+}
+
+void Game::QueueModeAssets(GameState mode, AssetLoader& modeLoader) {
+    if (mode == CAMPAIGN_GAME) {
+        CampaignGame::QueueAssets(modeLoader);
+    } else {
+        SurvivalGame::QueueAssets(modeLoader);
+    }
+}
+
+void Game::FinishLoading() {
+    delete loader;
+    loader = nullptr;
+    scenes.Pop();  // Bỏ màn loading
+
+    switch (loadingTarget) {
+        case CAMPAIGN_GAME:
+            StartCampaignGame();
+            break;
+        case SURVIVAL_GAME:
+            StartSurvivalGame();
+            break;
+        default:
+            // Mọi Acquire bên dưới đều trúng cache nên không đọc đĩa
+            if (!AcquireMenuAssets()) {
+                isRunning = false;
+                return;
+            }
+            scenes.Push(&mainMenuScene);
+            pendingReport = "Main menu";
+            Mix_PlayMusic(backgroundMusic, -1);
+            break;
     }
+}
 
-    //Mix_PlayMusic(backgroundMusic, -1);
-    Mix_VolumeMusic(static_cast<int>(volumeLevel * MIX_MAX_VOLUME));
+void Game::EnterMode(GameState mode) {
+    scenes.Pop();  // Bỏ màn chọn mode: hết ván thì về thẳng menu chính
+    bool warm = (mode == CAMPAIGN_GAME) ? campaignGame != nullptr : survivalGame != nullptr;
+    if (!warm) {
+        QueueModeAssets(mode, BeginLoading(mode));
+        return;
+    }
 
-    isRunning = true;
-    return true;
+    // Instance vẫn giữ texture và pool từ lần chơi trước, chỉ cần đặt lại ván
+    CancelPrefetch();
+    preferredMode = mode;
+    loadStartTicks = SDL_GetTicks();
+    if (mode == CAMPAIGN_GAME) StartCampaignGame();
+    else StartSurvivalGame();
 }
 
-Mix_Chunk* Game::LoadSound(const std::string& filePath) {
-    Mix_Chunk* sound = Mix_LoadWAV(filePath.c_str());
-    if (!sound) {
-        std::cerr << "Failed to load sound effect! Error: " << Mix_GetError() << std::endl;
+void Game::StartCampaignGame() {
+    if (!campaignGame) {
+        campaignGame = new CampaignGame(renderer, font);
+        campaignGame->SetJobSystem(jobSystem);
+        campaignGame->SetAssetCache(assets);
     }
-    return sound;
+    if (!campaignGame->Initialize()) {
+        delete campaignGame;
+        campaignGame = nullptr;
+        std::cerr << "Failed to initialize campaign game!" << std::endl;
+        scenes.Push(&modeSelectionScene);
+    } else {
+        scenes.Push(&campaignScene);
+        pendingReport = "Campaign";
+    }
+}
+
+void Game::StartSurvivalGame() {
+    if (!survivalGame) {
+        survivalGame = new SurvivalGame(renderer, font);
+        survivalGame->SetJobSystem(jobSystem);
+        survivalGame->SetAssetCache(assets);
+    }
+    if (!survivalGame->Initialize()) {
+        delete survivalGame;
+        survivalGame = nullptr;
+        std::cerr << "Failed to initialize survival game!" << std::endl;
+        scenes.Push(&modeSelectionScene);
+    } else {
+        scenes.Push(&survivalScene);
+        pendingReport = "Survival";
+    }
+}
+
+void Game::ReportInteractive(const char* what) {
+    std::cout << what << " interactive after " << SDL_GetTicks() - loadStartTicks << " ms" << std::endl;
+}
+
+Mix_Chunk* Game::LoadSound(const std::string& filePath) {
+    return assets->AcquireChunk(filePath);
 }
 
 void Game::PlayClickSound() {
@@ -154,195 +306,81 @@ void Game::PlayClickSound() {
 }
 
 SDL_Texture* Game::LoadTexture(const std::string& filePath) {
-    SDL_Texture* texture = IMG_LoadTexture(renderer, filePath.c_str());
-    if (!texture) {
-        std::cerr << "Unable to load texture " << filePath << "! Error: " << IMG_GetError() << std::endl;
-    }
-    return texture;
+    return assets->AcquireTexture(filePath);
+}
+
+void Game::SetFramePacing(FramePacing pacing, int fps) {
+    framePacing = pacing;
+    targetFps = fps;
 }
 
 void Game::Run() {
-    Mix_PlayMusic(backgroundMusic, -1);
+    pacer.Reset();
     while (isRunning) {
+        bool idle = IsIdle();
+        if (idle) {
+            // Màn hình đứng yên (menu, pause, hết ván): ngủ tới khi có event thay vì vẽ lại cùng một khung.
+            // Event vẫn nằm trong hàng đợi cho HandleEvents()
+            SDL_WaitEventTimeout(nullptr, IDLE_WAIT_MS);
+            pacer.Reset();
+        }
         HandleEvents();
         Update();
-        Render();
-        SDL_Delay(16);
+        if (!idle || dirty || scenes.Top() != renderedScene) {
+            Render();
+            // Chỉ ngủ phần còn lại của khung; với vsync thì present đã chờ refresh (120/144 Hz),
+            // mô phỏng vẫn 60 tick/giây trên thread riêng và Render() nội suy giữa hai tick
+            pacer.EndFrame();
+        }
     }
+    pacer.Report("Game", std::cout);
 }
 
 void Game::HandleEvents() {
+    // Nơi duy nhất poll SDL; event chỉ tới scene đang hiện
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
         if (event.type == SDL_QUIT) {
             isRunning = false;
         }
-
-        // Nếu đang trong game thì chuyển sự kiện cho game xử lý
-        if (currentState == CAMPAIGN_GAME && campaignGame) {
-            campaignGame->HandleInput();
-            continue;
-        }
-
-        if (event.type == SDL_MOUSEBUTTONDOWN) {
-            int mouseX, mouseY;
-            SDL_GetMouseState(&mouseX, &mouseY);
-
-            if (currentState == MAIN_MENU) {
-                if (event.button.button == SDL_BUTTON_LEFT) {
-                    if (CheckHover(playButton)) {
-                        PlayClickSound();
-                        currentState = MODE_SELECTION;
-                    }
-                    else if (CheckHover(optionsButton)) {
-                        PlayClickSound();
-                        currentState = OPTIONS;
-                    }
-                    else if (CheckHover(helpButton)) {
-                        PlayClickSound();
-                        currentState = HELP;
-                    }
-                    else if (CheckHover(quitButton)) {
-                        PlayClickSound();
-                        isRunning = false;
-                    }
-                }
-            }
-            else if (currentState == OPTIONS) {
-                if (event.button.button == SDL_BUTTON_LEFT) {
-                    if (CheckHover(backButton)) {
-                        PlayClickSound();
-                        currentState = MAIN_MENU;
-                    }
-                    else if (CheckHover(volumeSlider)) {
-                        draggingVolume = true;
-                    }
-                    else if (CheckHover(sfxVolumeSlider)) {  // Đổi từ brightnessSlider
-                        draggingSFXVolume = true;  // Đổi từ draggingBrightness
-                    }
-                }
-            }
-            else if (currentState == MODE_SELECTION) {
-                if (event.button.button == SDL_BUTTON_LEFT) {
-                    if (CheckHover(backButton)) {
-                        PlayClickSound();
-                        currentState = MAIN_MENU;
-                    }
-                    else if (CheckHover(campaignButton)) {
-                        PlayClickSound();
-                        if (!campaignGame) {
-                            campaignGame = new CampaignGame(renderer, font);
-                            if (!campaignGame->Initialize()) {
-                                delete campaignGame;
-                                campaignGame = nullptr;
-                                std::cerr << "Failed to initialize campaign game!" << std::endl;
-                            } else {
-                                currentState = CAMPAIGN_GAME;
-                            }
-                        }
-                    }
-                    else if (CheckHover(survivalButton)) {
-                        PlayClickSound();
-                        SurvivalGame* survivalGame = new SurvivalGame(renderer, font);
-                        if (!survivalGame->Initialize()) {
-                            delete survivalGame;
-                            std::cerr << "Failed to initialize survival game!" << std::endl;
-                        } else {
-                            currentState = SURVIVAL_GAME;
-                            survivalGame->Run();
-                            delete survivalGame;
-                            currentState = MAIN_MENU;
-                            Mix_PlayMusic(backgroundMusic, -1);
-                        }
-                    }
-                }
-            }
-            else if (currentState == HELP) {
-    if (event.button.button == SDL_BUTTON_LEFT) {
-        if (CheckHover(backButton)) {
-            PlayClickSound();
-            currentState = MAIN_MENU;
-            currentHelpPage = 1; // Reset về trang đầu khi quay lại menu
-        }
-        else if (currentHelpPage == 1 && CheckHover(nextPageButton)) {
-            PlayClickSound();
-            currentHelpPage = 2;
-        }
-        else if (currentHelpPage == 2) {
-            if (CheckHover(nextPageButton)) {
-                PlayClickSound();
-                currentHelpPage = 3;
-            }
-            else if (CheckHover(prevPageButton)) {
-                PlayClickSound();
-                currentHelpPage = 1;
-            }
-        }
-        else if (currentHelpPage == 3 && CheckHover(prevPageButton)) {
-            PlayClickSound();
-            currentHelpPage = 2;
-        }
-    }
-}
-        }
-        else if (event.type == SDL_MOUSEBUTTONUP) {
-            draggingVolume = false;
-            draggingSFXVolume = false;  // Đổi từ draggingBrightness
-        }
-        else if (event.type == SDL_MOUSEMOTION) {
-            if (draggingVolume) {
-                int mouseX, mouseY;
-                SDL_GetMouseState(&mouseX, &mouseY);
-                UpdateSlider(mouseX, volumeSlider, volumeTrack, volumeLevel);
-                Mix_VolumeMusic(static_cast<int>(volumeLevel * MIX_MAX_VOLUME));
-            }
-            else if (draggingSFXVolume) {  // Đổi từ draggingBrightness
-                int mouseX, mouseY;
-                SDL_GetMouseState(&mouseX, &mouseY);
-                UpdateSlider(mouseX, sfxVolumeSlider, sfxVolumeTrack, sfxVolumeLevel);  // Đổi từ brightnessSlider/Track/Level
-                Mix_Volume(-1, static_cast<int>(sfxVolumeLevel * MIX_MAX_VOLUME));  // Cập nhật volume SFX
-            }
-        }
+        if (Scene* scene = scenes.Top()) scene->HandleEvent(event);
+        dirty = true;
+        lastInputTicks = SDL_GetTicks();
     }
+    if (Scene* scene = scenes.Top()) scene->EventsPolled();
 }
 
 void Game::Update() {
-    if (currentState == CAMPAIGN_GAME && campaignGame) {
-        campaignGame->Update();
-
-        // Kiểm tra nếu game kết thúc thì quay về menu chính
-        if (!campaignGame->isRunning()) {
-            delete campaignGame;
-            campaignGame = nullptr;
-            currentState = MAIN_MENU;
-            Mix_PlayMusic(backgroundMusic, -1); // Phát lại nhạc menu
-        }
+    if (prefetch) {
+        prefetch->Pump(PREFETCH_SLICE_MS);
     }
+    if (Scene* scene = scenes.Top()) scene->Update();
+}
+
+bool Game::IsIdle() {
+    Scene* scene = scenes.Top();
+    if (!scene || !scene->IsIdle() || dirty || scene != renderedScene) return false;
+    return !prefetch || prefetch->IsDone();  // Nạp trước cần Pump() mỗi khung
+}
+
+void Game::ReturnToMainMenu() {
+    scenes.Pop();  // Instance của mode được giữ lại cho lần sau
+    Mix_PlayMusic(backgroundMusic, -1);
 }
 
 void Game::Render() {
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
     SDL_RenderClear(renderer);
 
-    switch (currentState) {
-        case MAIN_MENU:
-            RenderMainMenu();
-            break;
-        case OPTIONS:
-            RenderOptions();
-            break;
-        case MODE_SELECTION:
-            RenderModeSelection();
-            break;
-        case HELP:
-            RenderHelp();
-            break;
-        case CAMPAIGN_GAME:
-            RenderCampaignGame();
-            break;
-    }
+    renderedScene = scenes.Top();
+    if (renderedScene) renderedScene->Render();
+    dirty = false;
 
     SDL_RenderPresent(renderer);
+    if (pendingReport) {
+        ReportInteractive(pendingReport);
+        pendingReport = nullptr;
+    }
 }
 
 void Game::RenderMainMenu() {
@@ -367,20 +405,10 @@ void Game::RenderOptions() {
     SDL_Color white = {255, 255, 255, 255};
 
     // Nhãn âm lượng nhạc
-    SDL_Surface* volumeSurface = TTF_RenderText_Solid(font, "Background volume", white);
-    SDL_Texture* volumeTexture = SDL_CreateTextureFromSurface(renderer, volumeSurface);
-    SDL_Rect volumeTextRect = {volumeTrack.x, volumeTrack.y - 50, volumeSurface->w, volumeSurface->h};
-    SDL_RenderCopy(renderer, volumeTexture, nullptr, &volumeTextRect);
-    SDL_FreeSurface(volumeSurface);
-    SDL_DestroyTexture(volumeTexture);
+    textRenderer.DrawCached("options.volume", "Background volume", white, volumeTrack.x, volumeTrack.y - 50);
 
     // Nhãn âm lượng SFX (đổi từ brightness)
-    SDL_Surface* sfxSurface = TTF_RenderText_Solid(font, "SFX volume", white);
-    SDL_Texture* sfxTexture = SDL_CreateTextureFromSurface(renderer, sfxSurface);
-    SDL_Rect sfxTextRect = {sfxVolumeTrack.x, sfxVolumeTrack.y - 50, sfxSurface->w, sfxSurface->h};
-    SDL_RenderCopy(renderer, sfxTexture, nullptr, &sfxTextRect);
-    SDL_FreeSurface(sfxSurface);
-    SDL_DestroyTexture(sfxTexture);
+    textRenderer.DrawCached("options.sfx", "SFX volume", white, sfxVolumeTrack.x, sfxVolumeTrack.y - 50);
 }
 
 void Game::RenderModeSelection() {
@@ -410,10 +438,20 @@ void Game::RenderHelp() {
     }
 }
 
-void Game::RenderCampaignGame() {
-    if (campaignGame) {
-        campaignGame->Render();
+void Game::RenderLoading() {
+    if (loadingTarget != MAIN_MENU && modeBackground) {
+        SDL_RenderCopy(renderer, modeBackground, nullptr, nullptr);
     }
+
+    SDL_Rect track = {200, 700, 400, 20};
+    SDL_Rect filled = {track.x, track.y, static_cast<int>(track.w * loadProgress), track.h};
+    SDL_SetRenderDrawColor(renderer, 100, 100, 100, 255);
+    SDL_RenderFillRect(renderer, &track);
+    SDL_SetRenderDrawColor(renderer, 0, 200, 0, 255);
+    SDL_RenderFillRect(renderer, &filled);
+
+    SDL_Color white = {255, 255, 255, 255};
+    textRenderer.DrawCached("loading", "Loading...", white, track.x, track.y - 50);
 }
 
 bool Game::CheckHover(const SDL_Rect& rect) {
@@ -424,34 +462,22 @@ bool Game::CheckHover(const SDL_Rect& rect) {
 }
 
 void Game::Cleanup() {
-    if (clickSound) {
-        Mix_FreeChunk(clickSound);
-    }
-
-    if (backgroundMusic) {
-        Mix_FreeMusic(backgroundMusic);
-    }
-
-    if (menuBackground) {
-        SDL_DestroyTexture(menuBackground);
-    }
-
-    if (optionsBackground) {
-        SDL_DestroyTexture(optionsBackground);
-    }
-
-    if (modeBackground) {
-        SDL_DestroyTexture(modeBackground);
-    }
-
-    if (chooseModeBackground) {
-        SDL_DestroyTexture(chooseModeBackground);
-    }
-
-    if (helpBackground) {
-        SDL_DestroyTexture(helpBackground);
-    }
-
+    ReleaseAsset(clickSound);
+    ReleaseAsset(backgroundMusic);
+    ReleaseAsset(menuBackground);
+    ReleaseAsset(optionsBackground);
+    ReleaseAsset(modeBackground);
+    ReleaseAsset(chooseModeBackground);
+    ReleaseAsset(helpBackground);
+    ReleaseAsset(helpPage1);
+    ReleaseAsset(helpPage2);
+    ReleaseAsset(helpPage3);
+
+    // Cache giải phóng texture và nhạc nên phải hủy trước renderer và Mix_CloseAudio()
+    delete assets;
+    assets = nullptr;
+
+    textRenderer.Destroy();
     if (font) {
         TTF_CloseFont(font);
     }
@@ -464,11 +490,8 @@ void Game::Cleanup() {
         SDL_DestroyWindow(window);
     }
 
-    if (helpPage1) SDL_DestroyTexture(helpPage1);
-if (helpPage2) SDL_DestroyTexture(helpPage2);
-if (helpPage3) SDL_DestroyTexture(helpPage3);
-
     Mix_CloseAudio();
+    pack.Close();
     IMG_Quit();
     TTF_Quit();
     SDL_Quit();
@@ -8,12 +8,18 @@
 #include <string>
 #include "campaign_game.h"  // Thêm include này
 #include "survival_game.h"
+#include "text_renderer.h"
+#include "asset_cache.h"
+#include "asset_loader.h"
+#include "frame_pacer.h"
+#include "scene.h"
 
 class Game {
 public:
     Game();
     ~Game();
 
+    void SetFramePacing(FramePacing pacing, int targetFps);  // Gọi trước Initialize(); mặc định theo vsync
     bool Initialize(const char* title, int width, int height);
     void Run();
     void Cleanup();
@@ -21,24 +27,115 @@ public:
 private:
     enum GameState {
         MAIN_MENU,
-        OPTIONS,
-        MODE_SELECTION,
-        HELP,
         CAMPAIGN_GAME,  // Thêm trạng thái mới cho campaign game
         SURVIVAL_GAME
     };
 
+    // Mỗi màn hình là một scene lồng trong Game nên dùng thẳng thành viên của Game (game_scenes.cpp).
+    // Pause và màn kết thúc nằm trong trạng thái mô phỏng của từng chế độ chơi nên vẫn vẽ trong scene chơi.
+    class GameScene : public Scene {
+    public:
+        explicit GameScene(Game& owner) : game(owner) {}
+
+    protected:
+        Game& game;
+    };
+
+    class MainMenuScene : public GameScene {
+    public:
+        using GameScene::GameScene;
+        void HandleEvent(const SDL_Event& event) override;
+        void Render() override;
+        bool IsIdle() override { return true; }  // Bốn màn menu đều là ảnh tĩnh, chỉ đổi khi có input
+    };
+
+    class OptionsScene : public GameScene {
+    public:
+        using GameScene::GameScene;
+        void HandleEvent(const SDL_Event& event) override;
+        void Render() override;
+        bool IsIdle() override { return true; }
+    };
+
+    class ModeSelectionScene : public GameScene {
+    public:
+        using GameScene::GameScene;
+        void HandleEvent(const SDL_Event& event) override;
+        void Render() override;
+        bool IsIdle() override { return true; }
+    };
+
+    class HelpScene : public GameScene {
+    public:
+        using GameScene::GameScene;
+        void HandleEvent(const SDL_Event& event) override;
+        void Render() override;
+        bool IsIdle() override { return true; }
+    };
+
+    class LoadingScene : public GameScene {
+    public:
+        using GameScene::GameScene;
+        void HandleEvent(const SDL_Event&) override {}  // Đang nạp: bỏ qua input
+        void Update() override;
+        void Render() override;
+    };
+
+    // Gameplay chạy trên thread mô phỏng của mode; scene chuyển input sang và vẽ snapshot
+    class CampaignScene : public GameScene {
+    public:
+        using GameScene::GameScene;
+        void HandleEvent(const SDL_Event& event) override;
+        void EventsPolled() override;
+        void Update() override;
+        void Render() override;
+        bool IsIdle() override;  // Pause hoặc màn kết thúc
+    };
+
+    class SurvivalScene : public GameScene {
+    public:
+        using GameScene::GameScene;
+        void HandleEvent(const SDL_Event& event) override;
+        void EventsPolled() override;
+        void Update() override;
+        void Render() override;
+        bool IsIdle() override;  // Pause hoặc màn kết thúc
+    };
+
+    static const Uint32 LOAD_SLICE_MS = 4;  // Thời gian upload texture tối đa mỗi frame khi đang nạp
+    static const Uint32 PREFETCH_SLICE_MS = 2;  // Nạp trước ở màn chọn mode, nhỏ hơn để menu vẫn mượt
+    static const Uint32 IDLE_DELAY_MS = 250;  // Scene chơi: sau input cuối chừng này mới ngủ, để thread mô phỏng kịp xử lý
+    static const Uint32 IDLE_WAIT_MS = 250;   // Ngủ chờ event lâu nhất mỗi lần khi màn hình đứng yên
+
     void HandleEvents();
     void Update();
     void Render();
+    bool IsIdle();  // Scene đứng yên, không nạp gì và đã vẽ xong: không cần vẽ lại tới event kế tiếp
     void RenderMainMenu();
     void RenderOptions();
     void RenderModeSelection();
     void RenderHelp();
-    void RenderCampaignGame();  // Thêm hàm render cho campaign game
+    void RenderLoading();
+    void ReturnToMainMenu();  // Mode vừa thoát: bỏ scene chơi, phát lại nhạc menu
+
+    AssetLoader& BeginLoading(GameState target);  // Chuyển sang màn loading; người gọi xếp hàng tài nguyên vào loader
+    void FinishLoading();
+    void StartPrefetch(GameState mode);
+    void CancelPrefetch();
+    static void QueueModeAssets(GameState mode, AssetLoader& modeLoader);
+    void EnterMode(GameState mode);  // Mode đã có instance thì vào ngay, không thì qua màn loading
+    void StartCampaignGame();
+    void StartSurvivalGame();
+    bool AcquireMenuAssets();
+    void ReportInteractive(const char* what);  // In thời gian từ lúc bắt đầu nạp tới khi dùng được
 
     SDL_Texture* LoadTexture(const std::string& filePath);
     Mix_Chunk* LoadSound(const std::string& filePath);
+    template <typename T>
+    void ReleaseAsset(T*& asset) {
+        if (asset && assets) assets->Release(asset);
+        asset = nullptr;
+    }
     bool CheckHover(const SDL_Rect& rect);
     void PlayClickSound();
     void CreateSlider(SDL_Rect& slider, SDL_Rect& track, int x, int y, int width);
@@ -46,7 +143,11 @@ private:
 
     SDL_Window* window;
     SDL_Renderer* renderer;
+    FramePacer pacer;  // Giữ nhịp vòng lặp chính, dùng cho mọi scene
+    FramePacing framePacing;
+    int targetFps;
     TTF_Font* font;
+    TextRenderer textRenderer;
     SDL_Texture* menuBackground;
     SDL_Texture* optionsBackground;
     SDL_Texture* chooseModeBackground;
@@ -55,7 +156,19 @@ private:
     Mix_Music* backgroundMusic;
     Mix_Chunk* clickSound;
     bool isRunning;
-    GameState currentState;
+
+    // Scene trên đỉnh nhận event, Update() và Render(); các scene sống suốt đời Game
+    SceneStack scenes;
+    MainMenuScene mainMenuScene;
+    OptionsScene optionsScene;
+    ModeSelectionScene modeSelectionScene;
+    HelpScene helpScene;
+    LoadingScene loadingScene;
+    CampaignScene campaignScene;
+    SurvivalScene survivalScene;
+    Scene* renderedScene;  // Scene của khung vẽ gần nhất
+    bool dirty;            // Có event từ sau khung vẽ gần nhất
+    Uint32 lastInputTicks;
 
     // Main menu buttons
     SDL_Rect playButton;
@@ -91,6 +204,23 @@ private:
     // Campaign game instance
     CampaignGame* campaignGame;  // Thêm con trỏ đến campaign game
     SurvivalGame* survivalGame;  // Thêm dòng này
+
+    // Worker dùng chung cho mô phỏng của mọi chế độ chơi
+    JobSystem* jobSystem;
+
+    // Tài nguyên dùng chung cho menu và mọi chế độ chơi, sống cùng renderer
+    AssetPack pack;  // assets.pak nếu có; đóng sau cùng vì font, nhạc và texture có thể đọc từ vùng map của nó
+    AssetCache* assets;
+
+    // Nạp nền: menu lúc khởi động, tài nguyên của mode khi chọn mode
+    AssetLoader* loader;
+    GameState loadingTarget;
+    float loadProgress;
+    Uint32 loadStartTicks;
+    AssetLoader* prefetch;       // Nạp trước tài nguyên của prefetchTarget khi ở màn chọn mode
+    GameState prefetchTarget;
+    GameState preferredMode;     // Mode nạp trước khi vừa vào màn chọn mode: mode chơi gần nhất
+    const char* pendingReport;  // Khác nullptr: in thời gian tới khung hình tương tác được sau lần present kế tiếp
 };
 
 #endif // GAME_H
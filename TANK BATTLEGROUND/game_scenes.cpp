@@ -0,0 +1,189 @@
+#include "game.h"
+
+// Main menu
+void Game::MainMenuScene::HandleEvent(const SDL_Event& event) {
+    if (event.type != SDL_MOUSEBUTTONDOWN || event.button.button != SDL_BUTTON_LEFT) return;
+
+    if (game.CheckHover(game.playButton)) {
+        game.PlayClickSound();
+        game.scenes.Push(&game.modeSelectionScene);
+        game.StartPrefetch(game.preferredMode);
+    }
+    else if (game.CheckHover(game.optionsButton)) {
+        game.PlayClickSound();
+        game.scenes.Push(&game.optionsScene);
+    }
+    else if (game.CheckHover(game.helpButton)) {
+        game.PlayClickSound();
+        game.scenes.Push(&game.helpScene);
+    }
+    else if (game.CheckHover(game.quitButton)) {
+        game.PlayClickSound();
+        game.isRunning = false;
+    }
+}
+
+void Game::MainMenuScene::Render() {
+    game.RenderMainMenu();
+}
+
+// Options: hai thanh trượt âm lượng
+void Game::OptionsScene::HandleEvent(const SDL_Event& event) {
+    if (event.type == SDL_MOUSEBUTTONDOWN) {
+        if (event.button.button != SDL_BUTTON_LEFT) return;
+        if (game.CheckHover(game.backButton)) {
+            game.PlayClickSound();
+            game.scenes.Pop();
+        }
+        else if (game.CheckHover(game.volumeSlider)) {
+            game.draggingVolume = true;
+        }
+        else if (game.CheckHover(game.sfxVolumeSlider)) {  // Đổi từ brightnessSlider
+            game.draggingSFXVolume = true;  // Đổi từ draggingBrightness
+        }
+    }
+    else if (event.type == SDL_MOUSEBUTTONUP) {
+        game.draggingVolume = false;
+        game.draggingSFXVolume = false;  // Đổi từ draggingBrightness
+    }
+    else if (event.type == SDL_MOUSEMOTION) {
+        int mouseX, mouseY;
+        SDL_GetMouseState(&mouseX, &mouseY);
+        if (game.draggingVolume) {
+            game.UpdateSlider(mouseX, game.volumeSlider, game.volumeTrack, game.volumeLevel);
+            Mix_VolumeMusic(static_cast<int>(game.volumeLevel * MIX_MAX_VOLUME));
+        }
+        else if (game.draggingSFXVolume) {  // Đổi từ draggingBrightness
+            game.UpdateSlider(mouseX, game.sfxVolumeSlider, game.sfxVolumeTrack, game.sfxVolumeLevel);  // Đổi từ brightnessSlider/Track/Level
+            Mix_Volume(-1, static_cast<int>(game.sfxVolumeLevel * MIX_MAX_VOLUME));  // Cập nhật volume SFX
+        }
+    }
+}
+
+void Game::OptionsScene::Render() {
+    game.RenderOptions();
+}
+
+// Chọn mode: rê chuột vào nút nào thì nạp trước mode đó
+void Game::ModeSelectionScene::HandleEvent(const SDL_Event& event) {
+    if (event.type == SDL_MOUSEBUTTONDOWN) {
+        if (event.button.button != SDL_BUTTON_LEFT) return;
+        if (game.CheckHover(game.backButton)) {
+            game.PlayClickSound();
+            game.scenes.Pop();
+            game.CancelPrefetch();
+        }
+        else if (game.CheckHover(game.campaignButton)) {
+            game.PlayClickSound();
+            game.EnterMode(CAMPAIGN_GAME);
+        }
+        else if (game.CheckHover(game.survivalButton)) {
+            game.PlayClickSound();
+            game.EnterMode(SURVIVAL_GAME);
+        }
+    }
+    else if (event.type == SDL_MOUSEMOTION) {
+        if (game.CheckHover(game.campaignButton)) {
+            game.StartPrefetch(CAMPAIGN_GAME);
+        }
+        else if (game.CheckHover(game.survivalButton)) {
+            game.StartPrefetch(SURVIVAL_GAME);
+        }
+    }
+}
+
+void Game::ModeSelectionScene::Render() {
+    game.RenderModeSelection();
+}
+
+// Hướng dẫn: ba trang, chuyển bằng nút next/prev
+void Game::HelpScene::HandleEvent(const SDL_Event& event) {
+    if (event.type != SDL_MOUSEBUTTONDOWN || event.button.button != SDL_BUTTON_LEFT) return;
+
+    if (game.CheckHover(game.backButton)) {
+        game.PlayClickSound();
+        game.scenes.Pop();
+        game.currentHelpPage = 1; // Reset về trang đầu khi quay lại menu
+    }
+    else if (game.currentHelpPage == 1 && game.CheckHover(game.nextPageButton)) {
+        game.PlayClickSound();
+        game.currentHelpPage = 2;
+    }
+    else if (game.currentHelpPage == 2) {
+        if (game.CheckHover(game.nextPageButton)) {
+            game.PlayClickSound();
+            game.currentHelpPage = 3;
+        }
+        else if (game.CheckHover(game.prevPageButton)) {
+            game.PlayClickSound();
+            game.currentHelpPage = 1;
+        }
+    }
+    else if (game.currentHelpPage == 3 && game.CheckHover(game.prevPageButton)) {
+        game.PlayClickSound();
+        game.currentHelpPage = 2;
+    }
+}
+
+void Game::HelpScene::Render() {
+    game.RenderHelp();
+}
+
+// Đang nạp tài nguyên cho loadingTarget
+void Game::LoadingScene::Update() {
+    if (game.loader->Pump(LOAD_SLICE_MS)) game.FinishLoading();
+}
+
+void Game::LoadingScene::Render() {
+    game.RenderLoading();
+}
+
+// Campaign
+void Game::CampaignScene::HandleEvent(const SDL_Event& event) {
+    game.campaignGame->QueueEvent(event);
+}
+
+void Game::CampaignScene::EventsPolled() {
+    game.campaignGame->QueueKeys();  // Phím giữ được đọc một lần sau mỗi lượt poll
+}
+
+void Game::CampaignScene::Update() {
+    // Gameplay chạy trên thread mô phỏng; ở đây chỉ xem nó đã thoát về menu chưa
+    if (!game.campaignGame->isRunning()) {
+        game.campaignGame->StopSimulation();
+        game.ReturnToMainMenu();
+    }
+}
+
+void Game::CampaignScene::Render() {
+    game.campaignGame->Render();
+}
+
+bool Game::CampaignScene::IsIdle() {
+    // Input tới thread mô phỏng chậm một tick: vẽ tiếp một lúc sau click để kết quả kịp hiện ra
+    return game.campaignGame->IsIdle() && SDL_GetTicks() - game.lastInputTicks >= IDLE_DELAY_MS;
+}
+
+// Survival
+void Game::SurvivalScene::HandleEvent(const SDL_Event& event) {
+    game.survivalGame->QueueEvent(event);
+}
+
+void Game::SurvivalScene::EventsPolled() {
+    game.survivalGame->QueueKeys();
+}
+
+void Game::SurvivalScene::Update() {
+    if (!game.survivalGame->IsRunning()) {
+        game.survivalGame->StopSimulation();
+        game.ReturnToMainMenu();
+    }
+}
+
+void Game::SurvivalScene::Render() {
+    game.survivalGame->Render();
+}
+
+bool Game::SurvivalScene::IsIdle() {
+    return game.survivalGame->IsIdle() && SDL_GetTicks() - game.lastInputTicks >= IDLE_DELAY_MS;
+}
@@ -0,0 +1,132 @@
+#include "headless.h"
+#include "campaign_game.h"
+#include "survival_game.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+namespace {
+
+// Người chơi tự động: giữ một quyết định trong nửa giây rồi chọn lại, luôn bắn
+class BotPlayer {
+public:
+    explicit BotPlayer(unsigned int seed) : rng(seed), input{}, ticksLeft(0) {}
+
+    PlayerInput Next() {
+        if (ticksLeft == 0) {
+            input.forward = rng() % 100 < 50;
+            input.backward = !input.forward && rng() % 100 < 20;
+            int turn = static_cast<int>(rng() % 3);
+            input.turnLeft = (turn == 0);
+            input.turnRight = (turn == 1);
+            input.fire = true;
+            ticksLeft = SIM_TICK_RATE / 2;
+        }
+        ticksLeft--;
+        return input;
+    }
+
+private:
+    std::mt19937 rng;
+    PlayerInput input;
+    int ticksLeft;
+};
+
+// 0: dùng dung lượng mặc định của mode
+int CapacityOr(int requested, int fallback) {
+    return requested > 0 ? requested : fallback;
+}
+
+template <typename GameType>
+MatchResult RunMatch(Uint32 maxTicks, int maxEnemies, int maxBullets, unsigned int seed, JobSystem* jobs,
+                     std::ostream& poolReport) {
+    GameType game(nullptr, nullptr, maxEnemies, maxBullets);
+    game.Initialize();
+    game.Seed(seed);
+    game.SetJobSystem(jobs);
+
+    BotPlayer bot1(seed * 2 + 1);
+    BotPlayer bot2(seed * 2 + 2);
+    for (Uint32 tick = 0; tick < maxTicks && !game.GetMatchResult().isOver; tick++) {
+        game.SetPlayerInput(bot1.Next(), bot2.Next());
+        game.Step();
+    }
+    game.ReportPoolUsage(poolReport);
+    return game.GetMatchResult();
+}
+
+} // namespace
+
+bool ParseHeadlessArgs(int argc, char* argv[], HeadlessOptions& options) {
+    options = {HeadlessOptions::CAMPAIGN, 60 * 60 * SIM_TICK_RATE, 1, 1, JobSystem::DefaultWorkerCount(), 0, 0};
+    bool headless = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if (strcmp(arg, "--headless") == 0) {
+            headless = true;
+        } else if (strcmp(arg, "--mode") == 0 && value) {
+            options.mode = (strcmp(value, "survival") == 0) ? HeadlessOptions::SURVIVAL : HeadlessOptions::CAMPAIGN;
+            i++;
+        } else if (strcmp(arg, "--ticks") == 0 && value) {
+            options.ticks = static_cast<Uint32>(strtoul(value, nullptr, 10));
+            i++;
+        } else if (strcmp(arg, "--seed") == 0 && value) {
+            options.seed = static_cast<unsigned int>(strtoul(value, nullptr, 10));
+            i++;
+        } else if (strcmp(arg, "--matches") == 0 && value) {
+            options.matches = std::max(1, atoi(value));
+            i++;
+        } else if (strcmp(arg, "--threads") == 0 && value) {
+            options.threads = std::max(0, atoi(value));
+            i++;
+        } else if (strcmp(arg, "--max-enemies") == 0 && value) {
+            options.maxEnemies = std::max(0, atoi(value));
+            i++;
+        } else if (strcmp(arg, "--max-bullets") == 0 && value) {
+            options.maxBullets = std::max(0, atoi(value));
+            i++;
+        }
+    }
+    return headless;
+}
+
+int RunHeadless(const HeadlessOptions& options) {
+    const char* modeName = (options.mode == HeadlessOptions::SURVIVAL) ? "survival" : "campaign";
+    Uint64 totalTicks = 0;
+    // Kết quả không phụ thuộc số worker: cùng seed cho cùng kết quả với mọi giá trị --threads
+    JobSystem jobSystem(options.threads);
+    JobSystem* jobs = options.threads > 0 ? &jobSystem : nullptr;
+    Uint64 startCounter = SDL_GetPerformanceCounter();
+
+    for (int i = 0; i < options.matches; i++) {
+        unsigned int seed = options.seed + i;
+        std::ostringstream poolReport;
+        MatchResult result;
+        if (options.mode == HeadlessOptions::SURVIVAL) {
+            result = RunMatch<SurvivalGame>(options.ticks, CapacityOr(options.maxEnemies, SurvivalGame::MAX_LIVE_ENEMIES),
+                                            CapacityOr(options.maxBullets, SurvivalGame::MAX_LIVE_BULLETS), seed, jobs,
+                                            poolReport);
+        } else {
+            result = RunMatch<CampaignGame>(options.ticks, CapacityOr(options.maxEnemies, MAX_LIVE_ENEMIES),
+                                            CapacityOr(options.maxBullets, MAX_LIVE_BULLETS), seed, jobs, poolReport);
+        }
+        totalTicks += result.ticks;
+
+        std::cout << "match " << i + 1 << ": mode=" << modeName << " seed=" << seed
+                  << " ticks=" << result.ticks << " score1=" << result.score1
+                  << " score2=" << result.score2 << " over=" << (result.isOver ? "yes" : "no") << std::endl;
+        std::cout << "  " << poolReport.str();
+    }
+
+    double elapsedMs = (SDL_GetPerformanceCounter() - startCounter) * 1000.0 / SDL_GetPerformanceFrequency();
+    std::cout << "simulated " << totalTicks << " ticks in " << elapsedMs << " ms ("
+              << (elapsedMs > 0 ? totalTicks * 1000.0 / elapsedMs : 0.0) << " ticks/s, "
+              << (elapsedMs > 0 ? totalTicks * 1000.0 / elapsedMs / SIM_TICK_RATE : 0.0) << "x real time, "
+              << options.threads << " worker threads)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,26 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <SDL.h>
+
+// Chạy mô phỏng không cần cửa sổ, renderer, font hay thiết bị âm thanh
+struct HeadlessOptions {
+    enum Mode {
+        CAMPAIGN,
+        SURVIVAL
+    };
+
+    Mode mode;
+    Uint32 ticks;       // Số tick tối đa mỗi trận
+    unsigned int seed;  // Trận thứ i dùng seed + i
+    int matches;
+    int threads;        // Số worker; 0 = chạy tuần tự trên thread chính
+    int maxEnemies;     // Dung lượng pool enemy/đạn; 0 = mặc định của mode
+    int maxBullets;
+};
+
+// Trả về true nếu dòng lệnh có --headless; các tham số khác dùng giá trị mặc định nếu thiếu
+bool ParseHeadlessArgs(int argc, char* argv[], HeadlessOptions& options);
+int RunHeadless(const HeadlessOptions& options);
+
+#endif // HEADLESS_H
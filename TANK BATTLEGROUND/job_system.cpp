@@ -0,0 +1,206 @@
+#include "job_system.h"
+#include <algorithm>
+#include <iostream>
+
+// Worker biết pool của mình và hàng đợi riêng; main thread và thread ngoài pool dùng hàng đợi 0
+static thread_local const JobSystem* currentSystem = nullptr;
+static thread_local int currentQueue = 0;
+
+JobSystem::JobSystem(int workerThreads)
+    : queues(std::max(0, workerThreads) + 1), sleepLock(SDL_CreateMutex()), wakeUp(SDL_CreateCond()) {
+    SDL_AtomicSet(&queuedJobs, 0);
+    SDL_AtomicSet(&startedThreads, 0);
+    SDL_AtomicSet(&quitting, 0);
+    for (WorkQueue& queue : queues) queue.lock = SDL_CreateMutex();
+
+    for (int i = 0; i < workerThreads; i++) {
+        SDL_Thread* thread = SDL_CreateThread(workerMain, "JobWorker", this);
+        if (!thread) {
+            std::cerr << "Unable to create job worker! SDL_Error: " << SDL_GetError() << std::endl;
+            break;
+        }
+        threads.push_back(thread);
+    }
+}
+
+JobSystem::~JobSystem() {
+    SDL_AtomicSet(&quitting, 1);
+    SDL_LockMutex(sleepLock);
+    SDL_CondBroadcast(wakeUp);
+    SDL_UnlockMutex(sleepLock);
+    for (SDL_Thread* thread : threads) SDL_WaitThread(thread, nullptr);
+
+    for (WorkQueue& queue : queues) SDL_DestroyMutex(queue.lock);
+    SDL_DestroyCond(wakeUp);
+    SDL_DestroyMutex(sleepLock);
+}
+
+int JobSystem::DefaultWorkerCount() {
+    return std::max(0, SDL_GetCPUCount() - 1);
+}
+
+void JobSystem::Submit(JobFn run, void* data, int begin, int end, Counter* counter) {
+    QueuedJob job{run, data, begin, end, counter};
+    WorkQueue& queue = queues[currentSystem == this ? currentQueue : 0];
+    SDL_LockMutex(queue.lock);
+    if (queue.count == QUEUE_CAPACITY) {
+        SDL_UnlockMutex(queue.lock);
+        runJob(job);
+        return;
+    }
+    queue.jobs[(queue.head + queue.count) % QUEUE_CAPACITY] = job;
+    queue.count++;
+    SDL_AtomicIncRef(&counter->queued);
+    SDL_UnlockMutex(queue.lock);
+
+    // Tăng bộ đếm trước khi báo để worker đang kiểm tra điều kiện ngủ không bỏ lỡ job.
+    // Báo tất cả: thread đang Wait() một counter chỉ thức dậy nếu job mới là của counter đó.
+    SDL_AtomicIncRef(&queuedJobs);
+    SDL_LockMutex(sleepLock);
+    SDL_CondBroadcast(wakeUp);
+    SDL_UnlockMutex(sleepLock);
+}
+
+bool JobSystem::takeJob(int thread, Counter* only, QueuedJob& job) {
+    if (SDL_AtomicGet(only ? &only->queued : &queuedJobs) == 0) return false;
+
+    // Lấy job mới nhất của chính mình trước (dữ liệu còn nóng trong cache), sau đó mới lấy trộm job cũ nhất
+    int queueCount = static_cast<int>(queues.size());
+    for (int k = 0; k < queueCount; k++) {
+        WorkQueue& queue = queues[(thread + k) % queueCount];
+        SDL_LockMutex(queue.lock);
+        for (int n = 0; n < queue.count; n++) {
+            int offset = (k == 0) ? queue.count - 1 - n : n;
+            const QueuedJob& candidate = queue.jobs[(queue.head + offset) % QUEUE_CAPACITY];
+            if (only && candidate.counter != only) continue;
+
+            job = candidate;
+            removeAt(queue, offset);
+            SDL_AtomicAdd(&job.counter->queued, -1);
+            SDL_UnlockMutex(queue.lock);
+            SDL_AtomicAdd(&queuedJobs, -1);
+            return true;
+        }
+        SDL_UnlockMutex(queue.lock);
+    }
+    return false;
+}
+
+void JobSystem::removeAt(WorkQueue& queue, int offset) {
+    if (offset == 0) {
+        queue.head = (queue.head + 1) % QUEUE_CAPACITY;
+    } else {
+        // Job ở giữa (chỉ khi lọc theo counter): dồn các job sau nó lên một ô
+        for (int i = offset; i < queue.count - 1; i++) {
+            queue.jobs[(queue.head + i) % QUEUE_CAPACITY] = queue.jobs[(queue.head + i + 1) % QUEUE_CAPACITY];
+        }
+    }
+    queue.count--;
+}
+
+void JobSystem::runJob(const QueuedJob& job) {
+    job.run(job.data, job.begin, job.end);
+    if (SDL_AtomicAdd(&job.counter->pending, -1) == 1) {
+        // Job cuối của counter: đánh thức thread đang ngủ trong Wait()
+        SDL_LockMutex(sleepLock);
+        SDL_CondBroadcast(wakeUp);
+        SDL_UnlockMutex(sleepLock);
+    }
+}
+
+void JobSystem::Wait(Counter* counter) {
+    int thread = currentSystem == this ? currentQueue : 0;
+    QueuedJob job;
+    while (SDL_AtomicGet(&counter->pending) > 0) {
+        if (takeJob(thread, counter, job)) {
+            runJob(job);
+            continue;
+        }
+
+        // Job còn lại của counter đang chạy trên thread khác: ngủ tới khi nó có job mới hoặc về 0
+        SDL_LockMutex(sleepLock);
+        while (SDL_AtomicGet(&counter->pending) > 0 && SDL_AtomicGet(&counter->queued) == 0) {
+            SDL_CondWait(wakeUp, sleepLock);
+        }
+        SDL_UnlockMutex(sleepLock);
+    }
+}
+
+int JobSystem::workerMain(void* data) {
+    JobSystem* system = static_cast<JobSystem*>(data);
+    currentSystem = system;
+    currentQueue = SDL_AtomicAdd(&system->startedThreads, 1) + 1;
+
+    QueuedJob job;
+    while (!SDL_AtomicGet(&system->quitting)) {
+        if (system->takeJob(currentQueue, nullptr, job)) {
+            system->runJob(job);
+            continue;
+        }
+
+        SDL_LockMutex(system->sleepLock);
+        while (SDL_AtomicGet(&system->queuedJobs) == 0 && !SDL_AtomicGet(&system->quitting)) {
+            SDL_CondWait(system->wakeUp, system->sleepLock);
+        }
+        SDL_UnlockMutex(system->sleepLock);
+    }
+    return 0;
+}
+
+void JobSystem::ParallelFor(int count, int grainSize, JobFn run, void* data) {
+    if (count <= 0) return;
+    grainSize = std::max(1, grainSize);
+    if (threads.empty() || count <= grainSize) {
+        for (int begin = 0; begin < count; begin += grainSize) run(data, begin, std::min(count, begin + grainSize));
+        return;
+    }
+
+    Counter counter;
+    SDL_AtomicSet(&counter.pending, (count + grainSize - 1) / grainSize);
+    for (int begin = 0; begin < count; begin += grainSize) {
+        Submit(run, data, begin, std::min(count, begin + grainSize), &counter);
+    }
+    Wait(&counter);
+}
+
+int PhaseGraph::Add(const char* name, const PhaseFn& run, std::initializer_list<int> dependsOn) {
+    int index = static_cast<int>(phases.size());
+    phases.push_back(Phase{name, run, 0, {}, {0}});
+    for (int dependency : dependsOn) {
+        if (dependency < 0 || dependency >= index) {
+            std::cerr << "Phase " << name << " depends on an unknown phase " << dependency << std::endl;
+            continue;
+        }
+        phases[dependency].dependents.push_back(index);
+        phases[index].dependencyCount++;
+    }
+    return index;
+}
+
+void PhaseGraph::Run(JobSystem* jobs) {
+    if (!jobs || jobs->WorkerCount() == 0) {
+        for (Phase& phase : phases) phase.run();
+        return;
+    }
+
+    running = jobs;
+    SDL_AtomicSet(&done.pending, static_cast<int>(phases.size()));
+    for (Phase& phase : phases) SDL_AtomicSet(&phase.remaining, phase.dependencyCount);
+    for (int i = 0; i < static_cast<int>(phases.size()); i++) {
+        if (phases[i].dependencyCount == 0) jobs->Submit(phaseJob, this, i, i + 1, &done);
+    }
+    jobs->Wait(&done);
+    running = nullptr;
+}
+
+void PhaseGraph::phaseJob(void* graph, int index, int) {
+    static_cast<PhaseGraph*>(graph)->runPhase(index);
+}
+
+void PhaseGraph::runPhase(int index) {
+    phases[index].run();
+    for (int next : phases[index].dependents) {
+        // Pha cuối cùng hoàn thành trong số các phụ thuộc sẽ đưa pha kế tiếp vào hàng đợi
+        if (SDL_AtomicAdd(&phases[next].remaining, -1) == 1) running->Submit(phaseJob, this, next, next + 1, &done);
+    }
+}
@@ -0,0 +1,129 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <SDL.h>
+#include <functional>
+#include <initializer_list>
+#include <vector>
+
+// Thread pool kiểu work-stealing dựng trên SDL_Thread. Mỗi thread có một hàng đợi riêng:
+// chủ hàng đợi lấy job mới nhất ở cuối, thread rảnh lấy trộm job cũ nhất ở đầu hàng đợi khác.
+// Thread đang chờ cũng tự chạy job của counter nó chờ, nên job được phép tách tiếp thành job con.
+// Job chỉ là con trỏ hàm + dữ liệu + một đoạn chỉ số, hàng đợi là mảng vòng cố định: Submit() không cấp phát.
+class JobSystem {
+public:
+    // Số job chưa xong; Wait() trả về khi về 0
+    struct Counter {
+        SDL_atomic_t pending;
+        SDL_atomic_t queued;  // Số job của counter còn nằm trong hàng đợi, JobSystem tự quản lý
+
+        Counter() {
+            SDL_AtomicSet(&pending, 0);
+            SDL_AtomicSet(&queued, 0);
+        }
+    };
+
+    typedef void (*JobFn)(void* data, int begin, int end);
+
+    explicit JobSystem(int workerThreads);
+    ~JobSystem();
+
+    static int DefaultWorkerCount();  // Số lõi CPU - 1
+    int WorkerCount() const { return static_cast<int>(threads.size()); }
+
+    // Cộng counter->pending trước khi Submit; mỗi job chạy xong giảm counter đi 1.
+    // Hàng đợi đầy thì job chạy luôn trên thread gọi.
+    void Submit(JobFn run, void* data, int begin, int end, Counter* counter);
+    // Vừa chờ vừa chạy job của chính counter này, không chạy job khác (vd. giải mã ảnh giữa một tick);
+    // hết job của nó để lấy thì ngủ tới khi counter về 0
+    void Wait(Counter* counter);
+
+    // Chia [0, count) thành các đoạn grainSize phần tử và chạy song song.
+    // Cách chia chỉ phụ thuộc count và grainSize, không phụ thuộc số thread.
+    void ParallelFor(int count, int grainSize, JobFn run, void* data);
+    template <typename RangeFn>
+    void ParallelFor(int count, int grainSize, const RangeFn& job) {
+        ParallelFor(count, grainSize, &callRange<RangeFn>, const_cast<RangeFn*>(&job));
+    }
+
+private:
+    static const int QUEUE_CAPACITY = 256;
+
+    struct QueuedJob {
+        JobFn run;
+        void* data;
+        int begin;
+        int end;
+        Counter* counter;
+    };
+
+    struct WorkQueue {
+        SDL_mutex* lock;
+        QueuedJob jobs[QUEUE_CAPACITY];
+        int head;   // Job cũ nhất
+        int count;
+    };
+
+    template <typename RangeFn>
+    static void callRange(void* data, int begin, int end) {
+        (*static_cast<const RangeFn*>(data))(begin, end);
+    }
+
+    bool takeJob(int thread, Counter* only, QueuedJob& job);  // only == nullptr: job bất kỳ
+    static void removeAt(WorkQueue& queue, int offset);
+    void runJob(const QueuedJob& job);
+    static int workerMain(void* data);
+
+    std::vector<WorkQueue> queues;  // queues[0] dành cho các thread không thuộc pool
+    std::vector<SDL_Thread*> threads;
+    SDL_mutex* sleepLock;
+    SDL_cond* wakeUp;
+    SDL_atomic_t queuedJobs;
+    SDL_atomic_t startedThreads;
+    SDL_atomic_t quitting;
+};
+
+// jobs == nullptr: chạy tuần tự từng đoạn ngay trên thread gọi, cách chia đoạn giữ nguyên
+template <typename RangeFn>
+void ParallelFor(JobSystem* jobs, int count, int grainSize, const RangeFn& job) {
+    if (jobs) {
+        jobs->ParallelFor(count, grainSize, job);
+        return;
+    }
+    if (grainSize < 1) grainSize = 1;
+    for (int begin = 0; begin < count; begin += grainSize) {
+        job(begin, begin + grainSize < count ? begin + grainSize : count);
+    }
+}
+
+// Đồ thị các pha của một tick. Pha chỉ phụ thuộc vào pha được thêm trước nó nên thứ tự thêm
+// luôn là một thứ tự chạy hợp lệ; các pha không phụ thuộc nhau có thể chạy cùng lúc.
+class PhaseGraph {
+public:
+    typedef std::function<void()> PhaseFn;
+
+    PhaseGraph() : running(nullptr) {}
+
+    int Add(const char* name, const PhaseFn& run, std::initializer_list<int> dependsOn = {});
+
+    // jobs == nullptr hoặc không có worker: chạy tuần tự theo thứ tự thêm
+    void Run(JobSystem* jobs);
+
+private:
+    struct Phase {
+        const char* name;
+        PhaseFn run;
+        int dependencyCount;
+        std::vector<int> dependents;
+        SDL_atomic_t remaining;
+    };
+
+    static void phaseJob(void* graph, int index, int);
+    void runPhase(int index);
+
+    std::vector<Phase> phases;
+    JobSystem* running;  // Của lần Run() đang chạy; job chỉ mang chỉ số pha
+    JobSystem::Counter done;
+};
+
+#endif // JOB_SYSTEM_H
@@ -1,8 +1,22 @@
 #include "game.h"
+#include "headless.h"
 
 int main(int argc, char* argv[]) {
+    // Chạy mô phỏng không có cửa sổ: btap --headless --mode survival --ticks 36000 --seed 1
+    HeadlessOptions headlessOptions;
+    if (ParseHeadlessArgs(argc, argv, headlessOptions)) {
+        return RunHeadless(headlessOptions);
+    }
+
     Game game;
 
+    // Nhịp khung hình: mặc định theo vsync, --uncapped để không giới hạn, --fps 144 để đặt mục tiêu
+    FramePacing pacing = FRAME_PACING_VSYNC;
+    int targetFps = 0;
+    if (ParseFramePacingArgs(argc, argv, pacing, targetFps)) {
+        game.SetFramePacing(pacing, targetFps);
+    }
+
     // Khởi tạo game với tiêu đề và kích thước cửa sổ
     if (!game.Initialize("TANKS BATTLEGROUND", 800, 800)) {
         return -1; // Thoát nếu khởi tạo thất bại
@@ -0,0 +1,101 @@
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+#include <SDL.h>
+#include <vector>
+
+// Pool dung lượng cố định cho các đối tượng ngắn hạn (vụ nổ, vết cháy...).
+// Bộ nhớ cấp một lần lúc tạo; ô trống được dùng lại qua free list nên lúc chơi không cấp phát.
+// Handle gồm index và generation: giải phóng ô sẽ tăng generation, handle cũ trở thành không hợp lệ.
+template <typename T>
+class ObjectPool {
+public:
+    struct Handle {
+        int index;  // -1: không hợp lệ (pool đầy)
+        Uint32 generation;
+    };
+
+    explicit ObjectPool(int capacity) : capacity(capacity), liveCount(0), highWater(0) {
+        items.reserve(capacity);
+        generations.reserve(capacity);
+        alive.reserve(capacity);
+        freeList.reserve(capacity);
+    }
+
+    int Capacity() const { return capacity; }
+    int Size() const { return liveCount; }
+    int HighWater() const { return highWater; }  // Số đối tượng sống nhiều nhất từng có
+    bool Empty() const { return liveCount == 0; }
+
+    // Pool đầy thì không thêm và trả về handle có index -1
+    Handle Acquire(const T& value) {
+        int index;
+        if (!freeList.empty()) {
+            index = freeList.back();
+            freeList.pop_back();
+            items[index] = value;
+        } else if (static_cast<int>(items.size()) < capacity) {
+            index = static_cast<int>(items.size());
+            items.push_back(value);  // Đã reserve đủ nên không cấp phát lại
+            generations.push_back(0);
+            alive.push_back(false);
+        } else {
+            return Handle{-1, 0};
+        }
+        alive[index] = true;
+        liveCount++;
+        if (liveCount > highWater) highWater = liveCount;
+        return Handle{index, generations[index]};
+    }
+
+    bool IsValid(Handle handle) const {
+        return handle.index >= 0 && handle.index < static_cast<int>(items.size()) &&
+               alive[handle.index] && generations[handle.index] == handle.generation;
+    }
+
+    T* Get(Handle handle) { return IsValid(handle) ? &items[handle.index] : nullptr; }
+
+    void Release(Handle handle) {
+        if (IsValid(handle)) releaseSlot(handle.index);
+    }
+
+    // Duyệt các đối tượng còn sống theo thứ tự ô
+    template <typename Fn>
+    void ForEach(Fn fn) const {
+        for (size_t i = 0; i < items.size(); i++) {
+            if (alive[i]) fn(items[i]);
+        }
+    }
+
+    template <typename Pred>
+    void ReleaseIf(Pred shouldRelease) {
+        for (size_t i = 0; i < items.size(); i++) {
+            if (alive[i] && shouldRelease(items[i])) releaseSlot(static_cast<int>(i));
+        }
+    }
+
+    // Giải phóng mọi đối tượng nhưng giữ bộ nhớ và high-water mark
+    void Clear() {
+        for (size_t i = 0; i < items.size(); i++) {
+            if (alive[i]) releaseSlot(static_cast<int>(i));
+        }
+    }
+
+private:
+    void releaseSlot(int index) {
+        alive[index] = false;
+        generations[index]++;
+        freeList.push_back(index);
+        liveCount--;
+    }
+
+    int capacity;
+    int liveCount;
+    int highWater;
+    std::vector<T> items;
+    std::vector<Uint32> generations;
+    std::vector<bool> alive;
+    std::vector<int> freeList;
+};
+
+#endif // OBJECT_POOL_H
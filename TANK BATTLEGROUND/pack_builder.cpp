@@ -0,0 +1,221 @@
+// Công cụ tạo gói tài nguyên (chạy lúc build, không nằm trong game), chạy trong thư mục game:
+//   pack_builder <file .pak> <thư mục>... [--decode-images] [--premultiply] [--decode-max-bytes N]
+// Gom mọi file trong các thư mục (đệ quy) vào một file theo định dạng trong asset_pack.h.
+// --decode-images lưu PNG dưới dạng pixel ARGB8888 đã giải mã (chỉ ảnh giải mã ra không quá N byte,
+// ảnh nền lớn vẫn để PNG cho gói không phình ra); --premultiply nhân sẵn alpha cho các pixel đó.
+// Ảnh rời đã có trong atlas.txt cùng thư mục bị bỏ qua vì game không bao giờ nạp chúng.
+#include <SDL.h>
+#include <SDL_image.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "asset_pack.h"
+#include "atlas_manifest.h"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+struct Options {
+    bool decodeImages = false;
+    bool premultiply = false;
+    size_t decodeMaxBytes = 4u * 1024u * 1024u;
+};
+
+struct PackedFile {
+    std::string path;  // Đã chuẩn hóa bằng AssetPack::NormalizePath
+    fs::path source;
+    AssetPack::Entry entry;
+    std::vector<Uint8> bytes;
+};
+
+Uint64 alignUp(Uint64 value) {
+    return (value + AssetPack::ALIGNMENT - 1) / AssetPack::ALIGNMENT * AssetPack::ALIGNMENT;
+}
+
+bool readRaw(PackedFile& file) {
+    std::ifstream in(file.source, std::ios::binary);
+    if (!in) {
+        std::cerr << "Unable to read " << file.source.string() << std::endl;
+        return false;
+    }
+    file.bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    file.entry.format = AssetPack::FORMAT_RAW;
+    return true;
+}
+
+// Trả về false nếu lỗi; ảnh quá lớn thì giữ nguyên PNG
+bool decodeImage(PackedFile& file, const Options& options) {
+    SDL_Surface* loaded = IMG_Load(file.source.string().c_str());
+    if (!loaded) {
+        std::cerr << "Unable to load image " << file.source.string() << "! SDL_image Error: " << IMG_GetError() << std::endl;
+        return false;
+    }
+    size_t decodedBytes = static_cast<size_t>(loaded->w) * loaded->h * 4;
+    if (decodedBytes > options.decodeMaxBytes) {
+        SDL_FreeSurface(loaded);
+        return readRaw(file);
+    }
+
+    SDL_Surface* pixels = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888, 0);
+    SDL_FreeSurface(loaded);
+    if (!pixels) {
+        std::cerr << "Unable to convert " << file.source.string() << "! SDL_Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    int rowBytes = pixels->w * 4;
+    file.bytes.resize(static_cast<size_t>(rowBytes) * pixels->h);
+    for (int y = 0; y < pixels->h; y++) {
+        const Uint8* row = static_cast<const Uint8*>(pixels->pixels) + y * pixels->pitch;
+        std::memcpy(&file.bytes[static_cast<size_t>(y) * rowBytes], row, rowBytes);
+    }
+    if (options.premultiply) {
+        Uint32* texels = reinterpret_cast<Uint32*>(file.bytes.data());
+        for (size_t i = 0; i < file.bytes.size() / 4; i++) {
+            Uint32 p = texels[i];
+            Uint32 a = p >> 24;
+            Uint32 r = (((p >> 16) & 0xFF) * a + 127) / 255;
+            Uint32 g = (((p >> 8) & 0xFF) * a + 127) / 255;
+            Uint32 b = ((p & 0xFF) * a + 127) / 255;
+            texels[i] = (a << 24) | (r << 16) | (g << 8) | b;
+        }
+    }
+
+    file.entry.format = options.premultiply ? AssetPack::FORMAT_PIXELS_PREMULTIPLIED : AssetPack::FORMAT_PIXELS;
+    file.entry.width = static_cast<Uint32>(pixels->w);
+    file.entry.height = static_cast<Uint32>(pixels->h);
+    file.entry.pitch = static_cast<Uint32>(rowBytes);
+    SDL_FreeSurface(pixels);
+    return true;
+}
+
+// Id các sprite đã nằm trong atlas của thư mục đó
+const std::set<std::string>& atlasIds(std::map<fs::path, std::set<std::string>>& known, const fs::path& directory) {
+    auto it = known.find(directory);
+    if (it != known.end()) return it->second;
+
+    std::set<std::string>& ids = known[directory];
+    AtlasManifest manifest;
+    if (manifest.Read((directory / AtlasManifest::FILE_NAME).string())) {
+        for (const AtlasManifest::Entry& entry : manifest.entries) ids.insert(entry.id);
+    }
+    return ids;
+}
+
+int run(const std::string& output, const std::vector<std::string>& directories, const Options& options) {
+    std::vector<PackedFile> files;
+    std::map<fs::path, std::set<std::string>> atlases;
+    for (const std::string& directory : directories) {
+        for (const fs::directory_entry& item : fs::recursive_directory_iterator(directory)) {
+            if (!item.is_regular_file() || item.path().extension() == ".pak") continue;
+            const fs::path& source = item.path();
+            if (source.extension() == ".png" && atlasIds(atlases, source.parent_path()).count(source.stem().string())) {
+                continue;
+            }
+            PackedFile file;
+            file.path = AssetPack::NormalizePath(source.generic_string());
+            file.source = source;
+            file.entry = AssetPack::Entry{};
+            files.push_back(file);
+        }
+    }
+    if (files.empty()) {
+        std::cerr << "No files to pack" << std::endl;
+        return 1;
+    }
+
+    // Game tra bằng tìm kiếm nhị phân nên entry phải sắp theo đường dẫn
+    std::sort(files.begin(), files.end(), [](const PackedFile& a, const PackedFile& b) { return a.path < b.path; });
+    for (size_t i = 1; i < files.size(); i++) {
+        if (files[i].path == files[i - 1].path) {
+            std::cerr << "Duplicate path in pack: " << files[i].path << std::endl;
+            return 1;
+        }
+    }
+
+    std::string strings;
+    for (PackedFile& file : files) {
+        std::string extension = AssetPack::NormalizePath(file.source.extension().string());
+        bool ok = (options.decodeImages && extension == ".png") ? decodeImage(file, options) : readRaw(file);
+        if (!ok) return 1;
+        file.entry.pathOffset = static_cast<Uint32>(strings.size());
+        file.entry.pathLength = static_cast<Uint32>(file.path.size());
+        strings += file.path;
+    }
+
+    AssetPack::Header header;
+    std::memcpy(header.magic, "TBPK", 4);
+    header.version = AssetPack::VERSION;
+    header.entryCount = static_cast<Uint32>(files.size());
+    header.stringTableSize = static_cast<Uint32>(strings.size());
+
+    Uint64 offset = alignUp(sizeof(header) + files.size() * sizeof(AssetPack::Entry) + strings.size());
+    for (PackedFile& file : files) {
+        file.entry.dataOffset = offset;
+        file.entry.dataSize = file.bytes.size();
+        offset = alignUp(offset + file.bytes.size());
+    }
+
+    std::ofstream out(output, std::ios::binary);
+    if (!out) {
+        std::cerr << "Unable to write " << output << std::endl;
+        return 1;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const PackedFile& file : files) out.write(reinterpret_cast<const char*>(&file.entry), sizeof(file.entry));
+    out.write(strings.data(), strings.size());
+    Uint64 written = sizeof(header) + files.size() * sizeof(AssetPack::Entry) + strings.size();
+    for (const PackedFile& file : files) {
+        std::vector<char> padding(static_cast<size_t>(file.entry.dataOffset - written), 0);  // Căn theo ALIGNMENT
+        out.write(padding.data(), padding.size());
+        out.write(reinterpret_cast<const char*>(file.bytes.data()), file.bytes.size());
+        written = file.entry.dataOffset + file.bytes.size();
+    }
+    if (!out) {
+        std::cerr << "Unable to write " << output << std::endl;
+        return 1;
+    }
+
+    std::cout << "Packed " << files.size() << " files into " << output << " (" << written << " bytes)" << std::endl;
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: pack_builder <output.pak> <directory>... [--decode-images] [--premultiply] [--decode-max-bytes N]"
+                  << std::endl;
+        return 1;
+    }
+
+    std::string output = argv[1];
+    std::vector<std::string> directories;
+    Options options;
+    for (int i = 2; i < argc; i++) {
+        if (std::strcmp(argv[i], "--decode-images") == 0) options.decodeImages = true;
+        else if (std::strcmp(argv[i], "--premultiply") == 0) options.premultiply = true;
+        else if (std::strcmp(argv[i], "--decode-max-bytes") == 0 && i + 1 < argc) options.decodeMaxBytes = std::strtoul(argv[++i], nullptr, 10);
+        else if (argv[i][0] == '-') {
+            std::cerr << "Unknown option: " << argv[i] << std::endl;
+            return 1;
+        }
+        else directories.push_back(argv[i]);
+    }
+
+    if (options.decodeImages && !(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG)) {
+        std::cerr << "SDL_image could not initialize! SDL_image Error: " << IMG_GetError() << std::endl;
+        return 1;
+    }
+    int result = run(output, directories, options);
+    if (options.decodeImages) IMG_Quit();
+    return result;
+}
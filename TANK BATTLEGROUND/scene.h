@@ -0,0 +1,44 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <SDL.h>
+#include <vector>
+
+// Một màn hình của game (menu, options, chế độ chơi...). Vòng lặp chính poll event một chỗ
+// và chỉ chuyển cho scene trên đỉnh stack, rồi gọi Update() và Render() của scene đó.
+class Scene {
+public:
+    virtual ~Scene() {}
+
+    virtual void HandleEvent(const SDL_Event& event) = 0;
+    virtual void EventsPolled() {}  // Sau mỗi lượt SDL_PollEvent, vd. để đọc phím đang giữ
+    virtual void Update() {}
+    virtual void Render() = 0;  // Chỉ vẽ; vòng lặp chính present một lần mỗi khung
+    // true: không có gì tự chuyển động, vòng lặp chính ngủ chờ event và chỉ vẽ lại khi có input
+    virtual bool IsIdle() { return false; }
+};
+
+// Stack không sở hữu scene: scene sống trong object tạo ra nó, push/pop chỉ đổi màn hình đang hiện.
+// Scene được phép push/pop ngay trong HandleEvent()/Update() của chính nó.
+class SceneStack {
+public:
+    SceneStack() { scenes.reserve(8); }
+
+    void Push(Scene* scene) { scenes.push_back(scene); }
+    void Pop() {
+        if (!scenes.empty()) scenes.pop_back();
+    }
+    void Replace(Scene* scene) {  // Pop() rồi Push()
+        Pop();
+        Push(scene);
+    }
+    void Clear() { scenes.clear(); }
+
+    bool Empty() const { return scenes.empty(); }
+    Scene* Top() const { return scenes.empty() ? nullptr : scenes.back(); }
+
+private:
+    std::vector<Scene*> scenes;
+};
+
+#endif // SCENE_H
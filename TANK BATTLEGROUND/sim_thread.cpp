@@ -0,0 +1,56 @@
+#include "sim_thread.h"
+#include <iostream>
+#include "simulation.h"
+
+SimulationThread::SimulationThread() : thread(nullptr) {
+    SDL_AtomicSet(&running, 0);
+    SDL_AtomicSet(&stopping, 0);
+}
+
+SimulationThread::~SimulationThread() {
+    Stop();
+}
+
+bool SimulationThread::Start(const char* name, const FrameFn& frameFn) {
+    Stop();
+    frame = frameFn;
+    SDL_AtomicSet(&stopping, 0);
+    SDL_AtomicSet(&running, 1);
+    thread = SDL_CreateThread(threadMain, name, this);
+    if (!thread) {
+        std::cerr << "Unable to create simulation thread! SDL_Error: " << SDL_GetError() << std::endl;
+        SDL_AtomicSet(&running, 0);
+        return false;
+    }
+    return true;
+}
+
+void SimulationThread::Stop() {
+    if (!thread) return;
+    SDL_AtomicSet(&stopping, 1);
+    SDL_WaitThread(thread, nullptr);
+    thread = nullptr;
+    SDL_AtomicSet(&running, 0);
+}
+
+int SimulationThread::threadMain(void* data) {
+    SimulationThread* self = static_cast<SimulationThread*>(data);
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    const Uint64 period = frequency / SIM_TICK_RATE;
+    Uint64 next = SDL_GetPerformanceCounter();
+
+    while (!SDL_AtomicGet(&self->stopping)) {
+        if (!self->frame()) break;
+
+        // Ngủ tới mốc tick kế tiếp; trễ quá một tick thì bắt đầu lại từ bây giờ thay vì chạy dồn
+        next += period;
+        Uint64 now = SDL_GetPerformanceCounter();
+        if (now < next) {
+            SDL_Delay(static_cast<Uint32>((next - now) * 1000 / frequency));
+        } else if (now - next > period) {
+            next = now;
+        }
+    }
+    SDL_AtomicSet(&self->running, 0);
+    return 0;
+}
@@ -0,0 +1,30 @@
+#ifndef SIM_THREAD_H
+#define SIM_THREAD_H
+
+#include <SDL.h>
+#include <functional>
+
+// Thread riêng cho mô phỏng của một chế độ chơi. frame() được gọi lặp lại khoảng SIM_TICK_RATE
+// lần mỗi giây (số tick thật vẫn do FixedTimestep tính), nên Render() chậm trên main thread
+// không làm chậm gameplay. Hai thread chỉ trao đổi qua SpscQueue (input) và TripleBuffer (snapshot).
+class SimulationThread {
+public:
+    typedef std::function<bool()> FrameFn;  // Trả về false để dừng thread
+
+    SimulationThread();
+    ~SimulationThread();  // Stop()
+
+    bool Start(const char* name, const FrameFn& frame);
+    void Stop();  // Yêu cầu dừng và chờ thread kết thúc; gọi trên thread đã Start()
+    bool IsRunning() const { return SDL_AtomicGet(&running) != 0; }
+
+private:
+    static int threadMain(void* data);
+
+    SDL_Thread* thread;
+    FrameFn frame;
+    mutable SDL_atomic_t running;  // 0 khi frame() trả về false hoặc đã Stop()
+    SDL_atomic_t stopping;
+};
+
+#endif // SIM_THREAD_H
@@ -0,0 +1,60 @@
+#include "simulation.h"
+
+FixedTimestep::FixedTimestep()
+    : lastCounter(0), accumulatorMs(0.0), timeScale(1.0), maxTicksPerFrame(SIM_MAX_TICKS_PER_FRAME) {}
+
+void FixedTimestep::Reset() {
+    lastCounter = SDL_GetPerformanceCounter();
+    accumulatorMs = 0.0;
+}
+
+int FixedTimestep::Advance() {
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (lastCounter == 0) lastCounter = now;
+
+    double elapsedMs = (now - lastCounter) * 1000.0 / SDL_GetPerformanceFrequency();
+    lastCounter = now;
+    accumulatorMs += elapsedMs * timeScale;
+
+    int ticks = static_cast<int>(accumulatorMs / SIM_TICK_MS);
+    int maxTicks = static_cast<int>(maxTicksPerFrame * (timeScale > 1.0 ? timeScale : 1.0));
+    if (ticks > maxTicks) {
+        // Máy quá chậm: bỏ phần thời gian không kịp mô phỏng thay vì dồn lại mãi
+        ticks = maxTicks;
+        accumulatorMs = 0.0;
+    } else {
+        accumulatorMs -= ticks * SIM_TICK_MS;
+    }
+    return ticks;
+}
+
+float FixedTimestep::Alpha() const {
+    return static_cast<float>(accumulatorMs / SIM_TICK_MS);
+}
+
+void FixedTimestep::SetTimeScale(double scale) {
+    timeScale = scale > 0.0 ? scale : 1.0;
+}
+
+void FixedTimestep::SetMaxTicksPerFrame(int maxTicks) {
+    maxTicksPerFrame = maxTicks > 0 ? maxTicks : 1;
+}
+
+float RenderAlpha(float publishedAlpha, Uint64 publishedAt) {
+    double elapsedMs = (SDL_GetPerformanceCounter() - publishedAt) * 1000.0 / SDL_GetPerformanceFrequency();
+    float alpha = publishedAlpha + static_cast<float>(elapsedMs / SIM_TICK_MS);
+    return alpha < 1.0f ? alpha : 1.0f;
+}
+
+InputMessage ReadPlayerKeys() {
+    const Uint8* keystate = SDL_GetKeyboardState(NULL);
+    InputMessage message;
+    message.event.type = SDL_FIRSTEVENT;
+    message.player1 = {keystate[SDL_SCANCODE_W] != 0, keystate[SDL_SCANCODE_S] != 0,
+                       keystate[SDL_SCANCODE_A] != 0, keystate[SDL_SCANCODE_D] != 0,
+                       keystate[SDL_SCANCODE_SPACE] != 0};
+    message.player2 = {keystate[SDL_SCANCODE_UP] != 0, keystate[SDL_SCANCODE_DOWN] != 0,
+                       keystate[SDL_SCANCODE_LEFT] != 0, keystate[SDL_SCANCODE_RIGHT] != 0,
+                       keystate[SDL_SCANCODE_RETURN] != 0};
+    return message;
+}
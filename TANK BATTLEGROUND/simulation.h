@@ -0,0 +1,94 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <SDL.h>
+
+// Mô phỏng chạy theo bước cố định: mọi tốc độ trong game là "pixel mỗi tick"
+const int SIM_TICK_RATE = 60;
+const double SIM_TICK_MS = 1000.0 / SIM_TICK_RATE;
+const int SIM_MAX_TICKS_PER_FRAME = 8;
+
+// Đổi thời lượng (ms) sang số tick, làm tròn lên
+inline Uint32 MsToTicks(Uint32 ms) {
+    return (ms * SIM_TICK_RATE + 999) / 1000;
+}
+
+inline Uint32 TicksToMs(Uint32 ticks) {
+    return static_cast<Uint32>(ticks * 1000ull / SIM_TICK_RATE);
+}
+
+// Âm thanh do gameplay phát ra; được xếp hàng và phát sau khi chạy xong các tick
+enum GameSound {
+    SOUND_SPAWN,
+    SOUND_ENEMY_DEATH,
+    SOUND_PLAYER_DEATH
+};
+
+// Kết quả trận đấu, dùng cho chế độ chạy headless
+struct MatchResult {
+    Uint32 ticks;
+    int score1;
+    int score2;
+    bool isOver;
+};
+
+// Trạng thái điều khiển của một người chơi trong một tick
+struct PlayerInput {
+    bool forward;
+    bool backward;
+    bool turnLeft;
+    bool turnRight;
+    bool fire;
+};
+
+// Main thread gửi cho thread mô phỏng qua SpscQueue: một SDL event, hoặc trạng thái phím điều khiển
+// của hai người chơi khi event.type == SDL_FIRSTEVENT (gửi sau mỗi lượt SDL_PollEvent)
+struct InputMessage {
+    SDL_Event event;
+    PlayerInput player1;
+    PlayerInput player2;
+};
+
+// Đọc phím điều khiển hiện tại (WASD + Space, mũi tên + Enter); chỉ gọi trên main thread
+InputMessage ReadPlayerKeys();
+
+// Bộ tích lũy thời gian: đo thời gian thực và cho biết cần chạy bao nhiêu tick
+class FixedTimestep {
+public:
+    FixedTimestep();
+
+    void Reset();   // Bỏ thời gian tồn đọng (sau khi pause, load tài nguyên...)
+    int Advance();  // Gọi mỗi frame, trả về số tick cần mô phỏng
+    float Alpha() const;  // Phần dư của accumulator so với một tick (0..1)
+
+    void SetTimeScale(double scale);  // > 1 để chạy nhanh hơn thời gian thực
+    double GetTimeScale() const { return timeScale; }
+    void SetMaxTicksPerFrame(int maxTicks);
+
+private:
+    Uint64 lastCounter;
+    double accumulatorMs;
+    double timeScale;
+    int maxTicksPerFrame;
+};
+
+// Nội suy tuyến tính giữa trạng thái tick trước (alpha = 0) và tick hiện tại (alpha = 1)
+inline float Lerp(float previous, float current, float alpha) {
+    return previous + (current - previous) * alpha;
+}
+
+// Nội suy x, y, angle của một đối tượng có ba trường đó (Player của các chế độ chơi)
+template <typename T>
+T LerpPose(const T& previous, const T& current, float alpha) {
+    T result = current;
+    result.x = Lerp(previous.x, current.x, alpha);
+    result.y = Lerp(previous.y, current.y, alpha);
+    result.angle = Lerp(previous.angle, current.angle, alpha);
+    return result;
+}
+
+// Hệ số nội suy lúc vẽ: Alpha() của thread mô phỏng khi công bố snapshot cộng thời gian đã trôi
+// từ publishedAt (SDL_GetPerformanceCounter()), không vượt quá 1 để không đoán trước tick chưa chạy
+float RenderAlpha(float publishedAlpha, Uint64 publishedAt);
+
+#endif // SIMULATION_H
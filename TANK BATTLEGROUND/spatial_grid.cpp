@@ -0,0 +1,41 @@
+#include "spatial_grid.h"
+#include <cmath>
+
+SpatialGrid::SpatialGrid(float minX, float minY, float maxX, float maxY, float cellSize)
+    : minX(minX), minY(minY), invCellSize(1.0f / cellSize),
+      cols(std::max(1, static_cast<int>(std::ceil((maxX - minX) / cellSize)))),
+      rows(std::max(1, static_cast<int>(std::ceil((maxY - minY) / cellSize)))),
+      cellStart(cols * rows + 1, 0) {}
+
+void SpatialGrid::Reserve(int maxItems) {
+    pendingIndex.reserve(maxItems);
+    pendingCell.reserve(maxItems);
+    cellItems.reserve(maxItems);
+}
+
+void SpatialGrid::Begin() {
+    pendingIndex.clear();
+    pendingCell.clear();
+}
+
+void SpatialGrid::Insert(int index, float x, float y) {
+    pendingIndex.push_back(index);
+    pendingCell.push_back(cellRow(y) * cols + cellCol(x));
+}
+
+void SpatialGrid::Finish() {
+    // Counting sort theo ô: giữ nguyên thứ tự Insert trong từng ô
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+    for (int cell : pendingCell) {
+        cellStart[cell + 1]++;
+    }
+    for (size_t i = 1; i < cellStart.size(); i++) {
+        cellStart[i] += cellStart[i - 1];
+    }
+
+    cellCursor.assign(cellStart.begin(), cellStart.end() - 1);
+    cellItems.resize(pendingIndex.size());
+    for (size_t i = 0; i < pendingIndex.size(); i++) {
+        cellItems[cellCursor[pendingCell[i]]++] = pendingIndex[i];
+    }
+}
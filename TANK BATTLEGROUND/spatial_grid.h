@@ -0,0 +1,57 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <vector>
+#include <algorithm>
+
+// Lưới đồng nhất dùng làm broadphase va chạm. Dựng lại mỗi tick:
+//   Begin() -> Insert() cho từng đối tượng -> Finish() -> ForEachNear()
+// Đối tượng nằm ngoài vùng lưới được dồn vào ô ở biên nên truy vấn vẫn đúng.
+class SpatialGrid {
+public:
+    SpatialGrid(float minX, float minY, float maxX, float maxY, float cellSize);
+
+    void Reserve(int maxItems);  // Cấp phát trước để Insert() không phải cấp phát lại
+
+    void Begin();
+    void Insert(int index, float x, float y);
+    void Finish();
+
+    // Gọi fn(index) cho mọi đối tượng trong các ô giao với hình vuông bán kính radius quanh (x, y).
+    // Trong cùng một ô, index được trả về theo thứ tự Insert.
+    template <typename Fn>
+    void ForEachNear(float x, float y, float radius, Fn fn) const {
+        int minCol = cellCol(x - radius);
+        int maxCol = cellCol(x + radius);
+        int minRow = cellRow(y - radius);
+        int maxRow = cellRow(y + radius);
+        for (int row = minRow; row <= maxRow; row++) {
+            for (int col = minCol; col <= maxCol; col++) {
+                int cell = row * cols + col;
+                for (int i = cellStart[cell]; i < cellStart[cell + 1]; i++) {
+                    fn(cellItems[i]);
+                }
+            }
+        }
+    }
+
+private:
+    int cellCol(float x) const {
+        return std::max(0, std::min(cols - 1, static_cast<int>((x - minX) * invCellSize)));
+    }
+    int cellRow(float y) const {
+        return std::max(0, std::min(rows - 1, static_cast<int>((y - minY) * invCellSize)));
+    }
+
+    float minX, minY;
+    float invCellSize;
+    int cols, rows;
+
+    std::vector<int> pendingIndex;  // index theo thứ tự Insert
+    std::vector<int> pendingCell;   // ô tương ứng
+    std::vector<int> cellStart;     // cols * rows + 1 phần tử, dạng prefix sum
+    std::vector<int> cellItems;     // index sắp xếp theo ô
+    std::vector<int> cellCursor;    // vị trí ghi tiếp theo của từng ô khi Finish()
+};
+
+#endif // SPATIAL_GRID_H
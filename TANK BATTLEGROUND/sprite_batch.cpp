@@ -0,0 +1,85 @@
+#include "sprite_batch.h"
+#include <cmath>
+#include <iostream>
+
+SpriteBatch::SpriteBatch() : renderer(nullptr), activeBatches(0), reportedError(false) {}
+
+SpriteBatch::Batch& SpriteBatch::batchFor(SDL_Texture* texture) {
+    // Mỗi frame chỉ có vài texture nên tìm tuyến tính là đủ
+    for (size_t i = 0; i < activeBatches; i++) {
+        if (batches[i].texture == texture) return batches[i];
+    }
+    if (activeBatches == batches.size()) batches.push_back(Batch());
+    Batch& batch = batches[activeBatches++];
+    batch.texture = texture;
+    return batch;
+}
+
+void SpriteBatch::addQuad(SDL_Texture* texture, const SDL_FPoint corners[4], const SDL_FRect& uv, SDL_Color color) {
+    float right = uv.x + uv.w;
+    float bottom = uv.y + uv.h;
+    const SDL_FPoint texCoords[4] = {{uv.x, uv.y}, {right, uv.y}, {right, bottom}, {uv.x, bottom}};
+    Batch& batch = batchFor(texture);
+    int base = static_cast<int>(batch.vertices.size());
+    for (int i = 0; i < 4; i++) {
+        batch.vertices.push_back(SDL_Vertex{corners[i], color, texCoords[i]});
+    }
+    const int QUAD_INDICES[6] = {0, 1, 2, 0, 2, 3};
+    for (int index : QUAD_INDICES) batch.indices.push_back(base + index);
+}
+
+void SpriteBatch::Draw(const Sprite& sprite, const SDL_Rect& destRect) {
+    if (!sprite.texture) return;
+    float left = static_cast<float>(destRect.x);
+    float top = static_cast<float>(destRect.y);
+    float right = left + destRect.w;
+    float bottom = top + destRect.h;
+    SDL_FPoint corners[4] = {{left, top}, {right, top}, {right, bottom}, {left, bottom}};
+    addQuad(sprite.texture, corners, sprite.uv, SDL_Color{255, 255, 255, 255});
+}
+
+void SpriteBatch::DrawRotated(const Sprite& sprite, const SDL_Rect& destRect, double angle) {
+    if (!sprite.texture) return;
+    float radians = static_cast<float>(angle * M_PI / 180.0);
+    float c = std::cos(radians);
+    float s = std::sin(radians);
+    float halfW = destRect.w / 2.0f;
+    float halfH = destRect.h / 2.0f;
+    float centerX = destRect.x + halfW;
+    float centerY = destRect.y + halfH;
+
+    // Trục y hướng xuống nên ma trận quay thường cho ra chiều kim đồng hồ trên màn hình
+    const float OFFSETS[4][2] = {{-halfW, -halfH}, {halfW, -halfH}, {halfW, halfH}, {-halfW, halfH}};
+    SDL_FPoint corners[4];
+    for (int i = 0; i < 4; i++) {
+        corners[i].x = centerX + OFFSETS[i][0] * c - OFFSETS[i][1] * s;
+        corners[i].y = centerY + OFFSETS[i][0] * s + OFFSETS[i][1] * c;
+    }
+    addQuad(sprite.texture, corners, sprite.uv, SDL_Color{255, 255, 255, 255});
+}
+
+void SpriteBatch::FillRect(const SDL_Rect& rect, SDL_Color color) {
+    if (rect.w <= 0 || rect.h <= 0) return;
+    float left = static_cast<float>(rect.x);
+    float top = static_cast<float>(rect.y);
+    float right = left + rect.w;
+    float bottom = top + rect.h;
+    SDL_FPoint corners[4] = {{left, top}, {right, top}, {right, bottom}, {left, bottom}};
+    addQuad(nullptr, corners, SDL_FRect{0.0f, 0.0f, 1.0f, 1.0f}, color);
+}
+
+void SpriteBatch::Flush() {
+    for (size_t i = 0; i < activeBatches; i++) {
+        Batch& batch = batches[i];
+        if (!batch.indices.empty() && renderer) {
+            if (SDL_RenderGeometry(renderer, batch.texture, batch.vertices.data(), static_cast<int>(batch.vertices.size()),
+                                   batch.indices.data(), static_cast<int>(batch.indices.size())) < 0 && !reportedError) {
+                std::cerr << "SDL_RenderGeometry failed! SDL_Error: " << SDL_GetError() << std::endl;
+                reportedError = true;
+            }
+        }
+        batch.vertices.clear();  // Giữ capacity cho frame sau
+        batch.indices.clear();
+    }
+    activeBatches = 0;
+}
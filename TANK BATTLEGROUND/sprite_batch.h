@@ -0,0 +1,43 @@
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include <SDL.h>
+#include <vector>
+#include "texture_atlas.h"
+
+// Gom các sprite theo texture rồi vẽ mỗi texture bằng một lần SDL_RenderGeometry,
+// nên số draw call chỉ phụ thuộc số texture chứ không phụ thuộc số enemy, đạn, vụ nổ...
+// Sprite lấy từ TextureAtlas dùng chung texture nên cả mode thường chỉ còn một batch.
+// Sprite xoay được tính đỉnh sẵn trên CPU; hình chữ nhật màu (thanh máu) là một batch không texture.
+// Flush() vẽ các batch theo thứ tự texture xuất hiện lần đầu: lớp nào cần nằm trên thì Flush() trước nó
+// hoặc đưa vào batch sau cùng.
+class SpriteBatch {
+public:
+    SpriteBatch();
+
+    void SetRenderer(SDL_Renderer* renderer) { this->renderer = renderer; }
+
+    void Draw(const Sprite& sprite, const SDL_Rect& destRect);
+    // Quay theo chiều kim đồng hồ quanh tâm destRect, giống SDL_RenderCopyEx với center = NULL
+    void DrawRotated(const Sprite& sprite, const SDL_Rect& destRect, double angle);
+    void FillRect(const SDL_Rect& rect, SDL_Color color);
+
+    void Flush();
+
+private:
+    struct Batch {
+        SDL_Texture* texture;  // nullptr: hình màu không texture
+        std::vector<SDL_Vertex> vertices;
+        std::vector<int> indices;
+    };
+
+    Batch& batchFor(SDL_Texture* texture);
+    void addQuad(SDL_Texture* texture, const SDL_FPoint corners[4], const SDL_FRect& uv, SDL_Color color);
+
+    SDL_Renderer* renderer;
+    std::vector<Batch> batches;  // Giữ lại giữa các frame để không cấp phát lại
+    size_t activeBatches;
+    bool reportedError;
+};
+
+#endif // SPRITE_BATCH_H
@@ -0,0 +1,51 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <SDL.h>
+
+// Hàng đợi vòng không khóa, đúng một thread đẩy vào và đúng một thread lấy ra.
+// Dung lượng cố định (lũy thừa của 2), cấp sẵn trong object nên Push()/Pop() không cấp phát.
+// Chỉ số head/tail tăng mãi và chỉ lấy phần dư khi truy cập mảng, nên đầy/rỗng không cần ô trống.
+template <typename T, int CAPACITY>
+class SpscQueue {
+    static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY phải là lũy thừa của 2");
+
+public:
+    SpscQueue() {
+        SDL_AtomicSet(&head, 0);
+        SDL_AtomicSet(&tail, 0);
+    }
+
+    // Thread đẩy vào; trả về false nếu đầy (phần tử bị bỏ)
+    bool Push(const T& value) {
+        Uint32 end = static_cast<Uint32>(SDL_AtomicGet(&tail));
+        if (end - static_cast<Uint32>(SDL_AtomicGet(&head)) == CAPACITY) return false;
+        items[end & (CAPACITY - 1)] = value;
+        SDL_AtomicSet(&tail, static_cast<int>(end + 1));  // Công bố sau khi đã ghi xong phần tử
+        return true;
+    }
+
+    // Thread lấy ra: chép phần tử đầu mà không lấy ra; trả về false nếu rỗng
+    bool Peek(T& value) {
+        Uint32 begin = static_cast<Uint32>(SDL_AtomicGet(&head));
+        if (begin == static_cast<Uint32>(SDL_AtomicGet(&tail))) return false;
+        value = items[begin & (CAPACITY - 1)];
+        return true;
+    }
+
+    // Thread lấy ra; trả về false nếu rỗng
+    bool Pop(T& value) {
+        Uint32 begin = static_cast<Uint32>(SDL_AtomicGet(&head));
+        if (begin == static_cast<Uint32>(SDL_AtomicGet(&tail))) return false;
+        value = items[begin & (CAPACITY - 1)];
+        SDL_AtomicSet(&head, static_cast<int>(begin + 1));
+        return true;
+    }
+
+private:
+    T items[CAPACITY];
+    SDL_atomic_t head;  // Chỉ thread lấy ra ghi
+    SDL_atomic_t tail;  // Chỉ thread đẩy vào ghi
+};
+
+#endif // SPSC_QUEUE_H
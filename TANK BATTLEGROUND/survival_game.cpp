@@ -3,66 +3,132 @@
 const int SurvivalGame::MIN_SPAWN_RATE = 2000;
 const float SurvivalGame::RELOAD_TIME = 1500.0f;
 
-SurvivalGame::SurvivalGame(SDL_Renderer* renderer, TTF_Font* font)
+SurvivalGame::Snapshot::Snapshot()
+    : simTick(0), generation(0), alpha(1.0f), publishedAt(0), player1(0, 0), player2(0, 0),
+      previousPlayer1(0, 0), previousPlayer2(0, 0), player1InvincibleUntil(0), player2InvincibleUntil(0),
+      player1Info{0, 0, Sprite{}, Sprite{}}, player2Info{0, 0, Sprite{}, Sprite{}},
+      player1BulletInfo{MAX_BULLETS, 0.0f, std::vector<bool>(MAX_BULLETS, true), Sprite{}},
+      player2BulletInfo{MAX_BULLETS, 0.0f, std::vector<bool>(MAX_BULLETS, true), Sprite{}},
+      bullets(0), enemies(0),  // Dung lượng do constructor của game đặt
+      isPaused(false), showGameOverScreen(false), endGameTime(0), highScore(0), musicVolume(0), sfxVolume(0) {
+    explosions.reserve(MAX_EXPLOSIONS);
+}
+
+SurvivalGame::SurvivalGame(SDL_Renderer* renderer, TTF_Font* font, int maxEnemies, int maxBullets)
     : renderer(renderer), font(font), isRunning(false),
-      player1(PLAY_AREA_MIN_X + PLAYER_OFFSET, SCREEN_HEIGHT / 2, 0),
-      player2(PLAY_AREA_MAX_X - PLAYER_WIDTH - PLAYER_OFFSET, SCREEN_HEIGHT / 2, 180),
-      startTime(0), lastFireTime1(0), lastFireTime2(0), lastSpawnTime(0), spawnRate(5000),
-      player1InvincibleStart(0), player2InvincibleStart(0), player1IsInvincible(false),
+      headless(renderer == nullptr), resourcesLoaded(false), rng(static_cast<unsigned int>(time(nullptr))),
+      playerSprite{}, player2Sprite{}, bulletSprite{},
+      backgroundTexture(nullptr), grassSprite{}, enemySprite{},
+      boomSprite{}, afterBoomSprite{}, shieldSprite{},
+      gameOverBackgroundTexture(nullptr), pauseTexture(nullptr), menuButtonTexture(nullptr),
+      enemyDeathSound(nullptr), playerDeathSound(nullptr), spawnSound(nullptr),
+      backgroundMusic(nullptr),
+      simTick(0), nextFireTick1(0), nextFireTick2(0), nextSpawnTick(0), spawnRate(5000),
+      player1BulletInfo{MAX_BULLETS, 0.0f, std::vector<bool>(MAX_BULLETS, true), Sprite{}},
+      player2BulletInfo{MAX_BULLETS, 0.0f, std::vector<bool>(MAX_BULLETS, true), Sprite{}},
+      player1InvincibleUntil(0), player2InvincibleUntil(0), player1IsInvincible(false),
       player2IsInvincible(false), isPaused(false), highScore(0), showGameOverScreen(false),
-      endGameTime(0), musicVolume(64), sfxVolume(64), isDraggingMusic(false), isDraggingSFX(false),
+      endGameTime(0), musicVolume(64), sfxVolume(64),
       musicSlider{SCREEN_WIDTH / 2 - 150, SCREEN_HEIGHT / 2 - 40, 300, 30},
       sfxSlider{SCREEN_WIDTH / 2 - 150, SCREEN_HEIGHT / 2 + 40, 300, 30},
+      isDraggingMusic(false), isDraggingSFX(false),
       menuButtonRect{0, 0, 0, 0},
-      playerTexture(nullptr), player2Texture(nullptr), bulletTexture(nullptr),
-      backgroundTexture(nullptr), grassTexture(nullptr), enemyTexture(nullptr),
-      boomTexture(nullptr), afterBoomTexture(nullptr), shieldTexture(nullptr),
-      gameOverBackgroundTexture(nullptr), pauseTexture(nullptr), menuButtonTexture(nullptr),
-      enemyDeathSound(nullptr), playerDeathSound(nullptr), spawnSound(nullptr),
-      backgroundMusic(nullptr),
-      player1BulletInfo{MAX_BULLETS, 0.0f, std::vector<bool>(MAX_BULLETS, true), nullptr},
-      player2BulletInfo{MAX_BULLETS, 0.0f, std::vector<bool>(MAX_BULLETS, true), nullptr},
-      player1Info{MAX_LIVES, 0, nullptr, nullptr},
-      player2Info{MAX_LIVES, 0, nullptr, nullptr} {}
+      player1(PLAY_AREA_MIN_X + PLAYER_OFFSET, SCREEN_HEIGHT / 2, 0),
+      player2(PLAY_AREA_MAX_X - PLAYER_WIDTH - PLAYER_OFFSET, SCREEN_HEIGHT / 2, 180),
+      previousPlayer1(player1), previousPlayer2(player2),
+      player1Input{}, player2Input{},
+      player1Info{MAX_LIVES, 0, Sprite{}, Sprite{}},
+      player2Info{MAX_LIVES, 0, Sprite{}, Sprite{}},
+      bullets(maxBullets), enemies(maxEnemies),
+      explosions(MAX_EXPLOSIONS),
+      assets(nullptr), ownedAssets(nullptr),
+      enemyGrid(PLAY_AREA_MIN_X, PLAY_AREA_MIN_Y, PLAY_AREA_MAX_X, PLAY_AREA_MAX_Y, COLLISION_CELL_SIZE), jobs(nullptr),
+      generation(0), renderedGeneration(0), renderedIdle(false) {
+    // Nút về menu trong màn pause; cố định để thread mô phỏng kiểm tra click mà không cần Render()
+    menuButtonRect = {SCREEN_WIDTH / 2 - BUTTON_WIDTH / 2, sfxSlider.y + sfxSlider.h + 50, BUTTON_WIDTH, BUTTON_HEIGHT};
+    enemyGrid.Reserve(maxEnemies);
+    enemyDead.reserve(maxEnemies);
+    bulletDead.reserve(maxBullets);
+    // Mỗi bản snapshot cũng đủ chỗ cho cả pool để PublishSnapshot() chỉ chép trong dung lượng sẵn có
+    for (int i = 0; i < 3; i++) {
+        snapshots.Slot(i).bullets = BulletStore(maxBullets);
+        snapshots.Slot(i).enemies = EnemyStore(maxEnemies);
+    }
+}
 
 SurvivalGame::~SurvivalGame() {
     Cleanup();
-    bullets.clear();
-    enemies.clear();
-    explosions.clear();
-    afterBoomMarks.clear();
+    bullets.Clear();
+    enemies.Clear();
+    explosions.Clear();
+}
+
+void SurvivalGame::QueueAssets(AssetLoader& loader) {
+    loader.QueueSprites("images/survivalmode", {
+        "player1", "player2", "grass", "enemy", "boom", "afterboom", "bullet", "shield",
+        "bullet_icon", "player1_avatar", "player2_avatar", "heart"});
+    loader.QueueTexture("images/survivalmode/background.png");
+    loader.QueueTexture("images/survivalmode/gameover_background.png");
+    loader.QueueTexture("images/survivalmode/pause.png");
+    loader.QueueTexture("images/survivalmode/menu_button.png");
+    loader.QueueChunk("audio/enemydeath.wav");
+    loader.QueueChunk("audio/playerdeath.wav");
+    loader.QueueChunk("audio/spawn.wav");
+    loader.QueueMusic("audio/CampaignMode.mp3");
 }
 
 bool SurvivalGame::Initialize() {
+    StopSimulation();
+    if (headless) {
+        ResetGame();
+        isRunning = true;
+        return true;
+    }
+    if (resourcesLoaded) {
+        // Vào lại mode: texture, âm thanh và pool vẫn còn, chỉ cần đặt lại ván chơi
+        ResetGame();
+        if (backgroundMusic) {
+            Mix_VolumeMusic(musicVolume);
+            Mix_PlayMusic(backgroundMusic, -1);
+        }
+        return StartSimulation();
+    }
+
     std::cerr << "Starting initialization..." << std::endl;
 
-    // Tải các texture
-    playerTexture = LoadTexture("images/survivalmode/player1.png");
-    if (!playerTexture) std::cerr << "Warning: Failed to load player1.png" << std::endl;
+    if (!assets) assets = ownedAssets = new AssetCache(renderer);
+
+    // Tải các texture; sprite nhỏ lấy từ atlas nếu đã đóng gói (atlas_packer), không thì nạp ảnh rời
+    atlas.Load(*assets, "images/survivalmode");
+    playerSprite = LoadSprite("player1");
+    if (!playerSprite.texture) std::cerr << "Warning: Failed to load player1.png" << std::endl;
 
-    player2Texture = LoadTexture("images/survivalmode/player2.png");
-    if (!player2Texture) std::cerr << "Warning: Failed to load player2.png" << std::endl;
+    player2Sprite = LoadSprite("player2");
+    if (!player2Sprite.texture) std::cerr << "Warning: Failed to load player2.png" << std::endl;
 
     backgroundTexture = LoadTexture("images/survivalmode/background.png");
     if (!backgroundTexture) std::cerr << "Warning: Failed to load background.png" << std::endl;
 
-    grassTexture = LoadTexture("images/survivalmode/grass.png");
-    if (!grassTexture) std::cerr << "Warning: Failed to load grass.png" << std::endl;
+    grassSprite = LoadSprite("grass");
+    if (!grassSprite.texture) std::cerr << "Warning: Failed to load grass.png" << std::endl;
 
-    enemyTexture = LoadTexture("images/survivalmode/enemy.png");
-    if (!enemyTexture) std::cerr << "Warning: Failed to load enemy.png" << std::endl;
+    enemySprite = LoadSprite("enemy");
+    if (!enemySprite.texture) std::cerr << "Warning: Failed to load enemy.png" << std::endl;
 
-    boomTexture = LoadTexture("images/survivalmode/boom.png");
-    if (!boomTexture) std::cerr << "Warning: Failed to load boom.png" << std::endl;
+    boomSprite = LoadSprite("boom");
+    if (!boomSprite.texture) std::cerr << "Warning: Failed to load boom.png" << std::endl;
 
-    afterBoomTexture = LoadTexture("images/survivalmode/afterboom.png");
-    if (!afterBoomTexture) std::cerr << "Warning: Failed to load afterboom.png" << std::endl;
+    afterBoomSprite = LoadSprite("afterboom");
+    if (!afterBoomSprite.texture) std::cerr << "Warning: Failed to load afterboom.png" << std::endl;
+    decals.Create(renderer, backgroundTexture, SCREEN_WIDTH, SCREEN_HEIGHT);
+    textRenderer.Create(renderer, font);
+    sprites.SetRenderer(renderer);
 
-    bulletTexture = LoadTexture("images/survivalmode/bullet.png");
-    if (!bulletTexture) std::cerr << "Warning: Failed to load bullet.png" << std::endl;
+    bulletSprite = LoadSprite("bullet");
+    if (!bulletSprite.texture) std::cerr << "Warning: Failed to load bullet.png" << std::endl;
 
-    shieldTexture = LoadTexture("images/survivalmode/shield.png");
-    if (!shieldTexture) std::cerr << "Warning: Failed to load shield.png" << std::endl;
+    shieldSprite = LoadSprite("shield");
+    if (!shieldSprite.texture) std::cerr << "Warning: Failed to load shield.png" << std::endl;
 
     gameOverBackgroundTexture = LoadTexture("images/survivalmode/gameover_background.png");
     if (!gameOverBackgroundTexture) std::cerr << "Warning: Failed to load gameover_background.png" << std::endl;
@@ -73,19 +139,19 @@ bool SurvivalGame::Initialize() {
     menuButtonTexture = LoadTexture("images/survivalmode/menu_button.png"); // Thêm dòng này
     if (!menuButtonTexture) std::cerr << "Warning: Failed to load menu_button.png" << std::endl;
 
-    player1BulletInfo.bulletIcon = LoadTexture("images/survivalmode/bullet_icon.png");
-    if (!player1BulletInfo.bulletIcon) std::cerr << "Warning: Failed to load bullet_icon.png" << std::endl;
-    player2BulletInfo.bulletIcon = player1BulletInfo.bulletIcon;
+    player1BulletInfo.bulletIcon = LoadSprite("bullet_icon");
+    if (!player1BulletInfo.bulletIcon.texture) std::cerr << "Warning: Failed to load bullet_icon.png" << std::endl;
+    player2BulletInfo.bulletIcon = LoadSprite("bullet_icon");
 
-    player1Info.avatar = LoadTexture("images/survivalmode/player1_avatar.png");
-    if (!player1Info.avatar) std::cerr << "Warning: Failed to load player1_avatar.png" << std::endl;
+    player1Info.avatar = LoadSprite("player1_avatar");
+    if (!player1Info.avatar.texture) std::cerr << "Warning: Failed to load player1_avatar.png" << std::endl;
 
-    player2Info.avatar = LoadTexture("images/survivalmode/player2_avatar.png");
-    if (!player2Info.avatar) std::cerr << "Warning: Failed to load player2_avatar.png" << std::endl;
+    player2Info.avatar = LoadSprite("player2_avatar");
+    if (!player2Info.avatar.texture) std::cerr << "Warning: Failed to load player2_avatar.png" << std::endl;
 
-    player1Info.heartTexture = LoadTexture("images/survivalmode/heart.png");
-    if (!player1Info.heartTexture) std::cerr << "Warning: Failed to load heart.png" << std::endl;
-    player2Info.heartTexture = player1Info.heartTexture;
+    player1Info.heartSprite = LoadSprite("heart");
+    if (!player1Info.heartSprite.texture) std::cerr << "Warning: Failed to load heart.png" << std::endl;
+    player2Info.heartSprite = LoadSprite("heart");
 
     // Tải âm thanh
     enemyDeathSound = LoadSound("audio/enemydeath.wav");
@@ -97,12 +163,12 @@ bool SurvivalGame::Initialize() {
     spawnSound = LoadSound("audio/spawn.wav");
     if (!spawnSound) std::cerr << "Warning: Failed to load spawn.wav" << std::endl;
 
-backgroundMusic = Mix_LoadMUS("audio/CampaignMode.mp3");
-if (!backgroundMusic) std::cerr << "Warning: Failed to load CampaignMode.mp3" << std::endl;
+    backgroundMusic = assets->AcquireMusic("audio/CampaignMode.mp3");
+    if (!backgroundMusic) std::cerr << "Warning: Failed to load CampaignMode.mp3" << std::endl;
 
 
     // Kiểm tra các tài nguyên quan trọng
-    if (!playerTexture || !player2Texture || !backgroundTexture) {
+    if (!playerSprite.texture || !player2Sprite.texture || !backgroundTexture) {
         std::cerr << "Failed to load critical textures! Initialization aborted." << std::endl;
         return false;
     }
@@ -116,245 +182,358 @@ if (!backgroundMusic) std::cerr << "Warning: Failed to load CampaignMode.mp3" <<
     if (playerDeathSound) Mix_VolumeChunk(playerDeathSound, sfxVolume);
     if (spawnSound) Mix_VolumeChunk(spawnSound, sfxVolume);
 
-    startTime = SDL_GetTicks();
-    isRunning = true;
+    resourcesLoaded = true;
+    ResetGame();
     std::cerr << "Initialization completed!" << std::endl;
-    return true;
+    return StartSimulation();
 }
 
-SDL_Texture* SurvivalGame::LoadTexture(const char* path) {
-    SDL_Surface* loadedSurface = IMG_Load(path);
-    if (!loadedSurface) {
-        std::cerr << "Unable to load image " << path << "! SDL_image Error: " << IMG_GetError() << std::endl;
-        return nullptr;
+bool SurvivalGame::StartSimulation() {
+    // Từ đây trạng thái game thuộc về thread mô phỏng; Render() chỉ đọc snapshot
+    isRunning = true;
+    PublishSnapshot();
+    return simulation.Start("SurvivalSim", [this]() { return SimulateFrame(); });
+}
+
+void SurvivalGame::StopSimulation() {
+    simulation.Stop();
+}
+
+void SurvivalGame::QueueEvent(const SDL_Event& event) {
+    if (event.type == SDL_RENDER_TARGETS_RESET) {
+        decals.Restore();  // Nội dung render target đã mất: in lại nền và các vết; decal thuộc về main thread
+        return;
     }
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, loadedSurface);
-    SDL_FreeSurface(loadedSurface);
-    if (!texture) {
-        std::cerr << "Failed to create texture from " << path << "! SDL Error: " << SDL_GetError() << std::endl;
+    InputMessage message;
+    message.event = event;
+    input.Push(message);
+}
+
+void SurvivalGame::QueueKeys() {
+    input.Push(ReadPlayerKeys());
+}
+
+bool SurvivalGame::SimulateFrame() {
+    bool wasIdle = isPaused || showGameOverScreen;
+    bool handledEvent = false;
+    InputMessage message;
+    while (input.Pop(message)) {
+        if (message.event.type != SDL_FIRSTEVENT) {
+            HandleEvent(message.event);
+            handledEvent = true;
+        } else if (!isPaused && !showGameOverScreen) {
+            player1Input = message.player1;
+            player2Input = message.player2;
+        }
     }
-    return texture;
+    Update();
+    // Đứng yên từ trước và không có event: snapshot cũ vẫn đúng, không chép lại để main thread được nghỉ
+    if (!wasIdle || handledEvent || !(isPaused || showGameOverScreen)) PublishSnapshot();
+    return isRunning;
+}
+
+void SurvivalGame::PublishSnapshot() {
+    Snapshot& view = snapshots.WriteBuffer();
+    view.simTick = simTick;
+    view.generation = generation;
+    view.alpha = (isPaused || showGameOverScreen) ? 1.0f : clock.Alpha();
+    view.publishedAt = SDL_GetPerformanceCounter();
+    view.player1 = player1;
+    view.player2 = player2;
+    view.previousPlayer1 = previousPlayer1;
+    view.previousPlayer2 = previousPlayer2;
+    view.player1InvincibleUntil = player1InvincibleUntil;
+    view.player2InvincibleUntil = player2InvincibleUntil;
+    view.player1Info = player1Info;
+    view.player2Info = player2Info;
+    view.player1BulletInfo = player1BulletInfo;
+    view.player2BulletInfo = player2BulletInfo;
+    view.bullets = bullets;
+    view.enemies = enemies;
+    view.explosions.clear();
+    explosions.ForEach([&](const Explosion& explosion) { view.explosions.push_back(explosion); });
+    view.isPaused = isPaused;
+    view.showGameOverScreen = showGameOverScreen;
+    view.endGameTime = endGameTime;
+    view.highScore = highScore;
+    view.musicVolume = musicVolume;
+    view.sfxVolume = sfxVolume;
+    snapshots.Publish();
+}
+
+void SurvivalGame::SavePreviousState() {
+    previousPlayer1 = player1;
+    previousPlayer2 = player2;
+    enemies.SavePrevious();
+}
+
+SDL_Texture* SurvivalGame::LoadTexture(const char* path) {
+    return assets->AcquireTexture(path);
+}
+
+Sprite SurvivalGame::LoadSprite(const char* id) {
+    Sprite sprite;
+    if (atlas.Find(id, &sprite)) return sprite;
+    std::string path = std::string("images/survivalmode/") + id + ".png";
+    return MakeSprite(LoadTexture(path.c_str()));
+}
+
+void SurvivalGame::DestroySprite(Sprite& sprite) {
+    // Sprite trong atlas không giữ tham chiếu riêng, atlas trả texture khi Destroy()
+    if (!atlas.Owns(sprite.texture)) ReleaseAsset(sprite.texture);
+    sprite.texture = nullptr;
 }
 
 Mix_Chunk* SurvivalGame::LoadSound(const std::string& filePath) {
-    Mix_Chunk* sound = Mix_LoadWAV(filePath.c_str());
-    if (!sound) {
-        std::cerr << "Failed to load sound " << filePath << "! SDL_mixer Error: " << Mix_GetError() << std::endl;
-    }
-    return sound;
+    return assets->AcquireChunk(filePath);
 }
 
-void SurvivalGame::Run() {
-    while (isRunning) {
-        HandleInput();
-        Update();
-        Render();
-        SDL_Delay(16); // ~60 FPS
+void SurvivalGame::HandleEvent(const SDL_Event& e) {
+    // Chạy trên thread mô phỏng: tọa độ chuột lấy từ event, không gọi SDL_GetMouseState()
+    if (e.type == SDL_QUIT) {
+        isRunning = false;
+    }
+    if (showGameOverScreen) {
+        if (e.type == SDL_MOUSEBUTTONDOWN) HandleGameOverClick(e.button.x, e.button.y);
+        return;
+    }
+    if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_p) {
+        isPaused = !isPaused;
     }
-}
 
-void SurvivalGame::HandleInput() {
-    SDL_Event e;
-    int mouseX, mouseY;
-    while (SDL_PollEvent(&e)) {
-        if (e.type == SDL_QUIT) {
-            isRunning = false;
+    if (isPaused) {
+        if (e.type == SDL_MOUSEBUTTONDOWN) {
+            int mouseX = e.button.x;
+            int mouseY = e.button.y;
+            if (mouseX >= musicSlider.x && mouseX <= musicSlider.x + musicSlider.w &&
+                mouseY >= musicSlider.y && mouseY <= musicSlider.y + musicSlider.h) {
+                isDraggingMusic = true;
+            }
+            if (mouseX >= sfxSlider.x && mouseX <= sfxSlider.x + sfxSlider.w &&
+                mouseY >= sfxSlider.y && mouseY <= sfxSlider.y + sfxSlider.h) {
+                isDraggingSFX = true;
+            }
+            if (IsMouseOverButton(mouseX, mouseY, menuButtonRect.x, menuButtonRect.y,
+                                 menuButtonRect.w, menuButtonRect.h)) {
+                isRunning = false;
+            }
         }
-        if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_p) {
-            isPaused = !isPaused;
+        if (e.type == SDL_MOUSEBUTTONUP) {
+            isDraggingMusic = false;
+            isDraggingSFX = false;
         }
-
-        if (isPaused) {
-            if (e.type == SDL_MOUSEBUTTONDOWN) {
-                SDL_GetMouseState(&mouseX, &mouseY);
-                if (mouseX >= musicSlider.x && mouseX <= musicSlider.x + musicSlider.w &&
-                    mouseY >= musicSlider.y && mouseY <= musicSlider.y + musicSlider.h) {
-                    isDraggingMusic = true;
-                }
-                if (mouseX >= sfxSlider.x && mouseX <= sfxSlider.x + sfxSlider.w &&
-                    mouseY >= sfxSlider.y && mouseY <= sfxSlider.y + sfxSlider.h) {
-                    isDraggingSFX = true;
-                }
-                if (IsMouseOverButton(mouseX, mouseY, menuButtonRect.x, menuButtonRect.y,
-                                     menuButtonRect.w, menuButtonRect.h)) {
-                    isRunning = false;
-                }
+        if (e.type == SDL_MOUSEMOTION && (isDraggingMusic || isDraggingSFX)) {
+            int mouseX = e.motion.x;
+            if (isDraggingMusic) {
+                musicVolume = ((mouseX - musicSlider.x) * 128) / musicSlider.w;
+                musicVolume = std::max(0, std::min(128, musicVolume));
+                Mix_VolumeMusic(musicVolume);
             }
-            if (e.type == SDL_MOUSEBUTTONUP) {
-                isDraggingMusic = false;
-                isDraggingSFX = false;
-            }
-            if (e.type == SDL_MOUSEMOTION && (isDraggingMusic || isDraggingSFX)) {
-                SDL_GetMouseState(&mouseX, &mouseY);
-                if (isDraggingMusic) {
-                    musicVolume = ((mouseX - musicSlider.x) * 128) / musicSlider.w;
-                    musicVolume = std::max(0, std::min(128, musicVolume));
-                    Mix_VolumeMusic(musicVolume);
-                }
-                if (isDraggingSFX) {
-                    sfxVolume = ((mouseX - sfxSlider.x) * 128) / sfxSlider.w;
-                    sfxVolume = std::max(0, std::min(128, sfxVolume));
-                    Mix_VolumeChunk(enemyDeathSound, sfxVolume);
-                    Mix_VolumeChunk(playerDeathSound, sfxVolume);
-                    Mix_VolumeChunk(spawnSound, sfxVolume);
-                }
+            if (isDraggingSFX) {
+                sfxVolume = ((mouseX - sfxSlider.x) * 128) / sfxSlider.w;
+                sfxVolume = std::max(0, std::min(128, sfxVolume));
+                Mix_VolumeChunk(enemyDeathSound, sfxVolume);
+                Mix_VolumeChunk(playerDeathSound, sfxVolume);
+                Mix_VolumeChunk(spawnSound, sfxVolume);
             }
         }
     }
+}
 
-    if (!isPaused && !showGameOverScreen) {
-        const Uint8* keystate = SDL_GetKeyboardState(NULL);
-        Uint32 currentTime = SDL_GetTicks();
-
-        if (player1.isAlive) {
-            float rad1 = player1.angle * M_PI / 180.0;
-            float nextX1 = player1.x;
-            float nextY1 = player1.y;
+void SurvivalGame::UpdatePlayers() {
+    if (player1.isAlive) {
+        float rad1 = player1.angle * M_PI / 180.0;
+        float nextX1 = player1.x;
+        float nextY1 = player1.y;
 
-            if (keystate[SDL_SCANCODE_W]) {
-                nextX1 += 5 * cos(rad1);
-                nextY1 += 5 * sin(rad1);
-            }
-            if (keystate[SDL_SCANCODE_S]) {
-                nextX1 -= 5 * cos(rad1);
-                nextY1 -= 5 * sin(rad1);
-            }
+        if (player1Input.forward) {
+            nextX1 += 5 * cos(rad1);
+            nextY1 += 5 * sin(rad1);
+        }
+        if (player1Input.backward) {
+            nextX1 -= 5 * cos(rad1);
+            nextY1 -= 5 * sin(rad1);
+        }
 
-            if (!player2.isAlive || !CheckCollision(nextX1, nextY1, player2.x, player2.y)) {
-                player1.x = std::clamp(nextX1, static_cast<float>(PLAY_AREA_MIN_X),
-                                     static_cast<float>(PLAY_AREA_MAX_X - PLAYER_WIDTH));
-                player1.y = std::clamp(nextY1, static_cast<float>(PLAY_AREA_MIN_Y),
-                                     static_cast<float>(PLAY_AREA_MAX_Y - PLAYER_HEIGHT));
-            }
-            if (keystate[SDL_SCANCODE_A]) player1.angle -= 5;
-            if (keystate[SDL_SCANCODE_D]) player1.angle += 5;
-
-            if (keystate[SDL_SCANCODE_SPACE] && player1BulletInfo.currentBullets > 0 &&
-                currentTime - lastFireTime1 > FIRE_RATE) {
-                float bulletX = player1.x + PLAYER_WIDTH / 2 + (PLAYER_WIDTH / 2) * cos(rad1);
-                float bulletY = player1.y + PLAYER_HEIGHT / 2 + (PLAYER_WIDTH / 2) * sin(rad1);
-                bullets.emplace_back(bulletX, bulletY, rad1);
-                lastFireTime1 = currentTime;
-                player1BulletInfo.currentBullets--;
-                player1BulletInfo.bulletStates[player1BulletInfo.currentBullets] = false;
-                player1BulletInfo.reloadTimer = RELOAD_TIME;
-            }
+        if (!player2.isAlive || !CheckCollision(nextX1, nextY1, player2.x, player2.y)) {
+            player1.x = std::clamp(nextX1, static_cast<float>(PLAY_AREA_MIN_X),
+                                 static_cast<float>(PLAY_AREA_MAX_X - PLAYER_WIDTH));
+            player1.y = std::clamp(nextY1, static_cast<float>(PLAY_AREA_MIN_Y),
+                                 static_cast<float>(PLAY_AREA_MAX_Y - PLAYER_HEIGHT));
+        }
+        if (player1Input.turnLeft) player1.angle -= 5;
+        if (player1Input.turnRight) player1.angle += 5;
+
+        if (player1Input.fire && player1BulletInfo.currentBullets > 0 &&
+            simTick >= nextFireTick1) {
+            float bulletX = player1.x + PLAYER_WIDTH / 2 + (PLAYER_WIDTH / 2) * cos(rad1);
+            float bulletY = player1.y + PLAYER_HEIGHT / 2 + (PLAYER_WIDTH / 2) * sin(rad1);
+            bullets.Add(bulletX, bulletY, rad1, BULLET_SPEED);
+            nextFireTick1 = simTick + MsToTicks(FIRE_RATE);
+            player1BulletInfo.currentBullets--;
+            player1BulletInfo.bulletStates[player1BulletInfo.currentBullets] = false;
+            player1BulletInfo.reloadTimer = RELOAD_TIME;
         }
+    }
 
-        if (player2.isAlive) {
-            float rad2 = player2.angle * M_PI / 180.0;
-            float nextX2 = player2.x;
-            float nextY2 = player2.y;
+    if (player2.isAlive) {
+        float rad2 = player2.angle * M_PI / 180.0;
+        float nextX2 = player2.x;
+        float nextY2 = player2.y;
 
-            if (keystate[SDL_SCANCODE_UP]) {
-                nextX2 += 5 * cos(rad2);
-                nextY2 += 5 * sin(rad2);
-            }
-            if (keystate[SDL_SCANCODE_DOWN]) {
-                nextX2 -= 5 * cos(rad2);
-                nextY2 -= 5 * sin(rad2);
-            }
+        if (player2Input.forward) {
+            nextX2 += 5 * cos(rad2);
+            nextY2 += 5 * sin(rad2);
+        }
+        if (player2Input.backward) {
+            nextX2 -= 5 * cos(rad2);
+            nextY2 -= 5 * sin(rad2);
+        }
 
-            if (!player1.isAlive || !CheckCollision(player1.x, player1.y, nextX2, nextY2)) {
-                player2.x = std::clamp(nextX2, static_cast<float>(PLAY_AREA_MIN_X),
-                                     static_cast<float>(PLAY_AREA_MAX_X - PLAYER_WIDTH));
-                player2.y = std::clamp(nextY2, static_cast<float>(PLAY_AREA_MIN_Y),
-                                     static_cast<float>(PLAY_AREA_MAX_Y - PLAYER_HEIGHT));
-            }
-            if (keystate[SDL_SCANCODE_LEFT]) player2.angle -= 5;
-            if (keystate[SDL_SCANCODE_RIGHT]) player2.angle += 5;
-
-            if (keystate[SDL_SCANCODE_RETURN] && player2BulletInfo.currentBullets > 0 &&
-                currentTime - lastFireTime2 > FIRE_RATE) {
-                float bulletX = player2.x + PLAYER_WIDTH / 2 + (PLAYER_WIDTH / 2) * cos(rad2);
-                float bulletY = player2.y + PLAYER_HEIGHT / 2 + (PLAYER_WIDTH / 2) * sin(rad2);
-                bullets.emplace_back(bulletX, bulletY, rad2);
-                lastFireTime2 = currentTime;
-                player2BulletInfo.currentBullets--;
-                player2BulletInfo.bulletStates[player2BulletInfo.currentBullets] = false;
-                player2BulletInfo.reloadTimer = RELOAD_TIME;
-            }
+        if (!player1.isAlive || !CheckCollision(player1.x, player1.y, nextX2, nextY2)) {
+            player2.x = std::clamp(nextX2, static_cast<float>(PLAY_AREA_MIN_X),
+                                 static_cast<float>(PLAY_AREA_MAX_X - PLAYER_WIDTH));
+            player2.y = std::clamp(nextY2, static_cast<float>(PLAY_AREA_MIN_Y),
+                                 static_cast<float>(PLAY_AREA_MAX_Y - PLAYER_HEIGHT));
+        }
+        if (player2Input.turnLeft) player2.angle -= 5;
+        if (player2Input.turnRight) player2.angle += 5;
+
+        if (player2Input.fire && player2BulletInfo.currentBullets > 0 &&
+            simTick >= nextFireTick2) {
+            float bulletX = player2.x + PLAYER_WIDTH / 2 + (PLAYER_WIDTH / 2) * cos(rad2);
+            float bulletY = player2.y + PLAYER_HEIGHT / 2 + (PLAYER_WIDTH / 2) * sin(rad2);
+            bullets.Add(bulletX, bulletY, rad2, BULLET_SPEED);
+            nextFireTick2 = simTick + MsToTicks(FIRE_RATE);
+            player2BulletInfo.currentBullets--;
+            player2BulletInfo.bulletStates[player2BulletInfo.currentBullets] = false;
+            player2BulletInfo.reloadTimer = RELOAD_TIME;
         }
-    } else if (showGameOverScreen) {
-        HandleGameOverInput();
     }
 }
 
 void SurvivalGame::Update() {
-    if (isPaused || showGameOverScreen) return;
+    if (isPaused || showGameOverScreen) {
+        // Không tích lũy thời gian khi đứng yên, tránh chạy dồn tick lúc tiếp tục
+        clock.Reset();
+        return;
+    }
 
+    int ticks = clock.Advance();
+    for (int i = 0; i < ticks && !showGameOverScreen; i++) {
+        Step();
+    }
+    PlayPendingSounds();
+}
+
+void SurvivalGame::SetPlayerInput(const PlayerInput& input1, const PlayerInput& input2) {
+    player1Input = input1;
+    player2Input = input2;
+}
+
+MatchResult SurvivalGame::GetMatchResult() const {
+    return {simTick, player1Info.score, player2Info.score, showGameOverScreen};
+}
+
+void SurvivalGame::ReportPoolUsage(std::ostream& out) const {
+    out << "pools: bullets " << bullets.HighWater() << "/" << bullets.Capacity()
+        << " enemies " << enemies.HighWater() << "/" << enemies.Capacity()
+        << " explosions " << explosions.HighWater() << "/" << explosions.Capacity() << std::endl;
+}
+
+void SurvivalGame::QueueSound(GameSound sound) {
+    if (!headless) pendingSounds.push_back(sound);
+}
+
+void SurvivalGame::PlayPendingSounds() {
+    for (GameSound sound : pendingSounds) {
+        switch (sound) {
+            case SOUND_SPAWN: Mix_PlayChannel(-1, spawnSound, 0); break;
+            case SOUND_ENEMY_DEATH: Mix_PlayChannel(-1, enemyDeathSound, 0); break;
+            case SOUND_PLAYER_DEATH: Mix_PlayChannel(-1, playerDeathSound, 0); break;
+        }
+    }
+    pendingSounds.clear();
+}
+
+void SurvivalGame::Step() {
     if (!player1.isAlive && !player2.isAlive && !showGameOverScreen) {
-        endGameTime = SDL_GetTicks() - startTime;
+        endGameTime = TicksToMs(simTick);
         showGameOverScreen = true;
         int totalScore = player1Info.score + player2Info.score;
         highScore = std::max(highScore, totalScore);
         return;
     }
 
-    if (player1IsInvincible && !IsPlayerInvincible(player1InvincibleStart)) {
+    if (player1IsInvincible && !IsPlayerInvincible(player1InvincibleUntil)) {
         player1IsInvincible = false;
     }
-    if (player2IsInvincible && !IsPlayerInvincible(player2InvincibleStart)) {
+    if (player2IsInvincible && !IsPlayerInvincible(player2InvincibleUntil)) {
         player2IsInvincible = false;
     }
 
-    static Uint32 lastTime = SDL_GetTicks();
-    Uint32 currentTime = SDL_GetTicks();
-    float deltaTime = (currentTime - lastTime);
-    lastTime = currentTime;
-
-    UpdateBulletSystem(deltaTime);
+    SavePreviousState();
+    UpdatePlayers();
+    UpdateBulletSystem(SIM_TICK_MS);
     UpdateBullets();
     UpdateEnemies();
     CheckBulletCollisions();
     CheckEnemyPlayerCollision();
     UpdateExplosions();
     SpawnEnemy();
+    simTick++;
 }
 
 void SurvivalGame::Render() {
+    if (headless) return;
+
+    const Snapshot& view = snapshots.Read();
+    if (view.generation != renderedGeneration) {
+        // Ván mới: bỏ decal của ván trước; vết còn trong hàng đợi được lọc theo generation khi in
+        decals.Clear();
+        renderedGeneration = view.generation;
+    }
+    renderedIdle = view.isPaused || view.showGameOverScreen;
+
     SDL_RenderClear(renderer);
 
-    if (showGameOverScreen) {
-        RenderGameOverScreen();
+    if (view.showGameOverScreen) {
+        RenderGameOverScreen(view);
     } else {
-        SDL_Rect backgroundRect = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
-        SDL_RenderCopy(renderer, backgroundTexture, nullptr, &backgroundRect);
+        RenderAfterBoomMarks();  // Nền cùng mọi vết cháy, một lần copy
 
-        for (const auto& mark : afterBoomMarks) {
-            SDL_Rect markRect = {static_cast<int>(mark.x - 30), static_cast<int>(mark.y - 30), 60, 60};
-            SDL_RenderCopy(renderer, afterBoomTexture, nullptr, &markRect);
-        }
+        // Vẽ giữa tick trước và tick hiện tại theo thời gian thực, màn hình > 60 Hz vẫn chuyển động mượt
+        float alpha = RenderAlpha(view.alpha, view.publishedAt);
 
-        for (const auto& bullet : bullets) {
+        const BulletStore& bullets = view.bullets;
+        for (size_t i = 0; i < bullets.Size(); i++) {
+            // Đạn bay thẳng: vị trí tick trước là vị trí hiện tại trừ một bước vận tốc
             SDL_Rect bulletRect = {
-                static_cast<int>(bullet.x - BULLET_SIZE/2),
-                static_cast<int>(bullet.y - BULLET_SIZE/2),
+                static_cast<int>(bullets.x[i] - bullets.vx[i] * (1.0f - alpha) - BULLET_SIZE/2),
+                static_cast<int>(bullets.y[i] - bullets.vy[i] * (1.0f - alpha) - BULLET_SIZE/2),
                 BULLET_SIZE, BULLET_SIZE
             };
-            if (bulletTexture) {
-                SDL_RenderCopyEx(renderer, bulletTexture, nullptr, &bulletRect,
-                               bullet.angle * 180.0f / M_PI + 90, nullptr, SDL_FLIP_NONE);
-            }
+            sprites.DrawRotated(bulletSprite, bulletRect, bullets.angle[i] * 180.0f / M_PI + 90);
         }
 
-        for (const auto& explosion : explosions) {
+        for (const Explosion& explosion : view.explosions) {
             SDL_Rect explosionRect = {
                 static_cast<int>(explosion.x - 50),
                 static_cast<int>(explosion.y - 50),
                 100, 100
             };
-            SDL_RenderCopy(renderer, boomTexture, nullptr, &explosionRect);
+            sprites.Draw(boomSprite, explosionRect);
         }
 
+        Player player1 = LerpPose(view.previousPlayer1, view.player1, alpha);
+        Player player2 = LerpPose(view.previousPlayer2, view.player2, alpha);
         if (player1.isAlive) {
             SDL_Rect destRect1 = {
                 static_cast<int>(player1.x),
                 static_cast<int>(player1.y),
                 PLAYER_WIDTH, PLAYER_HEIGHT
             };
-            SDL_RenderCopyEx(renderer, playerTexture, nullptr, &destRect1, player1.angle, nullptr, SDL_FLIP_NONE);
-            RenderShieldEffect(player1.x, player1.y, player1InvincibleStart);
+            sprites.DrawRotated(playerSprite, destRect1, player1.angle);
         }
 
         if (player2.isAlive) {
@@ -363,112 +542,123 @@ void SurvivalGame::Render() {
                 static_cast<int>(player2.y),
                 PLAYER_WIDTH, PLAYER_HEIGHT
             };
-            SDL_RenderCopyEx(renderer, player2Texture, nullptr, &destRect2, player2.angle, nullptr, SDL_FLIP_NONE);
-            RenderShieldEffect(player2.x, player2.y, player2InvincibleStart);
+            sprites.DrawRotated(player2Sprite, destRect2, player2.angle);
         }
 
-        for (const auto& enemy : enemies) {
+        // Khiên vẽ sau cả hai xe để batch khiên nằm trên
+        if (player1.isAlive) RenderShieldEffect(view, player1, view.player1InvincibleUntil);
+        if (player2.isAlive) RenderShieldEffect(view, player2, view.player2InvincibleUntil);
+
+        const EnemyStore& enemies = view.enemies;
+        for (size_t i = 0; i < enemies.Size(); i++) {
             SDL_Rect enemyRect = {
-                static_cast<int>(enemy.x),
-                static_cast<int>(enemy.y),
+                static_cast<int>(Lerp(enemies.prevX[i], enemies.x[i], alpha)),
+                static_cast<int>(Lerp(enemies.prevY[i], enemies.y[i], alpha)),
                 ENEMY_SIZE, ENEMY_SIZE
             };
-            SDL_RenderCopy(renderer, enemyTexture, nullptr, &enemyRect);
+            sprites.Draw(enemySprite, enemyRect);
         }
 
         SDL_Rect grassRect = {SCREEN_WIDTH / 2 - 75, SCREEN_HEIGHT / 2 - 75, 150, 150};
-        SDL_RenderCopy(renderer, grassTexture, nullptr, &grassRect);
+        sprites.Draw(grassSprite, grassRect);
+        sprites.Flush();  // Mỗi texture một lần vẽ, thứ tự lớp giữ nguyên vì mỗi nhóm dùng texture riêng
 
-        RenderUI();
+        RenderUI(view);
 
-        if (isPaused) {
+        if (view.isPaused) {
             SDL_Rect pauseRect = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
             SDL_RenderCopy(renderer, pauseTexture, nullptr, &pauseRect);
 
             SDL_Color white = {255, 255, 255, 255};
 
             std::string musicText = "Music Volume";
-            SDL_Surface* musicSurface = TTF_RenderText_Solid(font, musicText.c_str(), white);
-            SDL_Texture* musicTexture = SDL_CreateTextureFromSurface(renderer, musicSurface);
+            const TextRenderer::TextImage& musicImage = textRenderer.Cached("pause.music", musicText, white);
             SDL_Rect musicTextRect = {
-                SCREEN_WIDTH / 2 - musicSurface->w / 2,
-                musicSlider.y - musicSurface->h - 5,
-                musicSurface->w, musicSurface->h
+                SCREEN_WIDTH / 2 - musicImage.w / 2,
+                musicSlider.y - musicImage.h - 5,
+                musicImage.w, musicImage.h
             };
-            SDL_RenderCopy(renderer, musicTexture, nullptr, &musicTextRect);
+            SDL_RenderCopy(renderer, musicImage.texture, nullptr, &musicTextRect);
 
             SDL_SetRenderDrawColor(renderer, 100, 100, 100, 255);
             SDL_RenderFillRect(renderer, &musicSlider);
             SDL_Rect musicFill = {
                 musicSlider.x,
                 musicSlider.y,
-                (musicVolume * musicSlider.w) / 128,
+                (view.musicVolume * musicSlider.w) / 128,
                 musicSlider.h
             };
             SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
             SDL_RenderFillRect(renderer, &musicFill);
 
             std::string sfxText = "SFX Volume";
-            SDL_Surface* sfxSurface = TTF_RenderText_Solid(font, sfxText.c_str(), white);
-            SDL_Texture* sfxTexture = SDL_CreateTextureFromSurface(renderer, sfxSurface);
+            const TextRenderer::TextImage& sfxImage = textRenderer.Cached("pause.sfx", sfxText, white);
             SDL_Rect sfxTextRect = {
-                SCREEN_WIDTH / 2 - sfxSurface->w / 2,
-                sfxSlider.y - sfxSurface->h - 5,
-                sfxSurface->w, sfxSurface->h
+                SCREEN_WIDTH / 2 - sfxImage.w / 2,
+                sfxSlider.y - sfxImage.h - 5,
+                sfxImage.w, sfxImage.h
             };
-            SDL_RenderCopy(renderer, sfxTexture, nullptr, &sfxTextRect);
+            SDL_RenderCopy(renderer, sfxImage.texture, nullptr, &sfxTextRect);
 
             SDL_SetRenderDrawColor(renderer, 100, 100, 100, 255);
             SDL_RenderFillRect(renderer, &sfxSlider);
             SDL_Rect sfxFill = {
                 sfxSlider.x,
                 sfxSlider.y,
-                (sfxVolume * sfxSlider.w) / 128,
+                (view.sfxVolume * sfxSlider.w) / 128,
                 sfxSlider.h
             };
             SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
             SDL_RenderFillRect(renderer, &sfxFill);
 
-            menuButtonRect = {
-                SCREEN_WIDTH / 2 - BUTTON_WIDTH / 2,
-                sfxSlider.y + sfxSlider.h + 50,
-                BUTTON_WIDTH, BUTTON_HEIGHT
-            };
             SDL_RenderCopy(renderer, menuButtonTexture, nullptr, &menuButtonRect);
-
-            SDL_FreeSurface(musicSurface);
-            SDL_DestroyTexture(musicTexture);
-            SDL_FreeSurface(sfxSurface);
-            SDL_DestroyTexture(sfxTexture);
         }
     }
-
-    SDL_RenderPresent(renderer);
 }
 
 void SurvivalGame::SpawnEnemy() {
-    Uint32 currentTime = SDL_GetTicks();
-    if (currentTime - lastSpawnTime >= spawnRate) {
-        enemies.emplace_back(SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
-        lastSpawnTime = currentTime;
-        Mix_PlayChannel(-1, spawnSound, 0);
+    if (simTick >= nextSpawnTick && !enemies.Full()) {
+        enemies.Add(SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2, 0, 0, 1);
+        nextSpawnTick = simTick + MsToTicks(spawnRate);
+        QueueSound(SOUND_SPAWN);
         spawnRate = std::max(MIN_SPAWN_RATE, spawnRate - 200);
     }
 }
 
+void SurvivalGame::AddAfterBoomMark(float x, float y) {
+    if (!headless) newMarks.Push(QueuedMark{x, y, generation});  // Hàng đợi đầy thì bỏ vết, chỉ là trang trí
+}
+
+void SurvivalGame::RenderAfterBoomMarks() {
+    // Vết mới được in một lần vào lớp decal, sau đó nằm sẵn trong nền. Vết của ván trước bị bỏ;
+    // vết của ván mới mà snapshot chưa tới thì để lại trong hàng đợi cho tới khi vẽ ván đó.
+    QueuedMark mark;
+    while (newMarks.Peek(mark) && mark.generation <= renderedGeneration) {
+        newMarks.Pop(mark);
+        if (mark.generation != renderedGeneration) continue;
+        SDL_Rect markRect = {static_cast<int>(mark.x - 30), static_cast<int>(mark.y - 30), 60, 60};
+        decals.Stamp(afterBoomSprite, markRect);
+    }
+    decals.Render();
+}
+
 void SurvivalGame::UpdateEnemies() {
-    for (auto it = enemies.begin(); it != enemies.end();) {
+    bool anyDead = false;
+    enemyDead.assign(enemies.Size(), false);
+    for (size_t i = 0; i < enemies.Size(); i++) {
+        float& ex = enemies.x[i];
+        float& ey = enemies.y[i];
         float distance1 = std::numeric_limits<float>::max();
         if (player1.isAlive) {
-            float dx1 = player1.x - it->x;
-            float dy1 = player1.y - it->y;
+            float dx1 = player1.x - ex;
+            float dy1 = player1.y - ey;
             distance1 = std::sqrt(dx1 * dx1 + dy1 * dy1);
         }
 
         float distance2 = std::numeric_limits<float>::max();
         if (player2.isAlive) {
-            float dx2 = player2.x - it->x;
-            float dy2 = player2.y - it->y;
+            float dx2 = player2.x - ex;
+            float dy2 = player2.y - ey;
             distance2 = std::sqrt(dx2 * dx2 + dy2 * dy2);
         }
 
@@ -480,67 +670,78 @@ void SurvivalGame::UpdateEnemies() {
             targetX = player2.x;
             targetY = player2.y;
         } else {
-            targetX = it->x + (rand() % 3 - 1);
-            targetY = it->y + (rand() % 3 - 1);
+            targetX = ex + (static_cast<int>(rng() % 3) - 1);
+            targetY = ey + (static_cast<int>(rng() % 3) - 1);
         }
 
-        float dx = targetX - it->x;
-        float dy = targetY - it->y;
+        float dx = targetX - ex;
+        float dy = targetY - ey;
         float distance = std::sqrt(dx * dx + dy * dy);
 
         if (distance > 0) {
-            it->x += (dx / distance) * ENEMY_SPEED;
-            it->y += (dy / distance) * ENEMY_SPEED;
+            ex += (dx / distance) * ENEMY_SPEED;
+            ey += (dy / distance) * ENEMY_SPEED;
         }
 
         const int ENEMY_PADDING = 5;
-        it->x = std::clamp(it->x,
-                          static_cast<float>(PLAY_AREA_MIN_X + ENEMY_PADDING),
-                          static_cast<float>(PLAY_AREA_MAX_X - ENEMY_SIZE - ENEMY_PADDING));
-        it->y = std::clamp(it->y,
-                          static_cast<float>(PLAY_AREA_MIN_Y + ENEMY_PADDING),
-                          static_cast<float>(PLAY_AREA_MAX_Y - ENEMY_SIZE - ENEMY_PADDING));
-
-        if (it->x < 0 || it->x > SCREEN_WIDTH || it->y < 0 || it->y > SCREEN_HEIGHT) {
-            it = enemies.erase(it);
-        } else {
-            ++it;
+        ex = std::clamp(ex,
+                        static_cast<float>(PLAY_AREA_MIN_X + ENEMY_PADDING),
+                        static_cast<float>(PLAY_AREA_MAX_X - ENEMY_SIZE - ENEMY_PADDING));
+        ey = std::clamp(ey,
+                        static_cast<float>(PLAY_AREA_MIN_Y + ENEMY_PADDING),
+                        static_cast<float>(PLAY_AREA_MAX_Y - ENEMY_SIZE - ENEMY_PADDING));
+
+        if (ex < 0 || ex > SCREEN_WIDTH || ey < 0 || ey > SCREEN_HEIGHT) {
+            enemyDead[i] = true;
+            anyDead = true;
         }
     }
+    if (anyDead) enemies.Compact(enemyDead);
 }
 
 void SurvivalGame::CheckBulletCollisions() {
-    for (auto bulletIt = bullets.begin(); bulletIt != bullets.end();) {
-        bool hit = false;
-        for (auto enemyIt = enemies.begin(); enemyIt != enemies.end();) {
-            float dx = bulletIt->x - (enemyIt->x + ENEMY_SIZE/2);
-            float dy = bulletIt->y - (enemyIt->y + ENEMY_SIZE/2);
-            float distance = sqrt(dx*dx + dy*dy);
-
-            if (distance < (BULLET_SIZE/2 + ENEMY_SIZE/2)) {
-                Mix_PlayChannel(-1, enemyDeathSound, 0);
-
-                float angleDiff1 = fabs(bulletIt->angle - (player1.angle * M_PI / 180.0));
-                float angleDiff2 = fabs(bulletIt->angle - (player2.angle * M_PI / 180.0));
-                if (angleDiff1 < angleDiff2 && player1.isAlive) {
-                    player1Info.score += 10;
-                } else if (player2.isAlive) {
-                    player2Info.score += 10;
-                }
-
-                enemyIt = enemies.erase(enemyIt);
-                hit = true;
-                break;
-            } else {
-                ++enemyIt;
+    // Broadphase: đưa tâm enemy vào lưới, mỗi viên đạn chỉ xét các ô lân cận
+    enemyDead.assign(enemies.Size(), false);
+    enemyGrid.Begin();
+    for (size_t i = 0; i < enemies.Size(); i++) {
+        enemyGrid.Insert(i, enemies.x[i] + ENEMY_SIZE / 2, enemies.y[i] + ENEMY_SIZE / 2);
+    }
+    enemyGrid.Finish();
+
+    const float hitDistance = BULLET_SIZE / 2 + ENEMY_SIZE / 2;
+    bulletDead.assign(bullets.Size(), false);
+    for (size_t b = 0; b < bullets.Size(); b++) {
+        float bulletX = bullets.x[b];
+        float bulletY = bullets.y[b];
+
+        // Narrowphase: so sánh bình phương khoảng cách; nếu trúng nhiều enemy thì lấy enemy đứng trước trong danh sách
+        int hitIndex = -1;
+        enemyGrid.ForEachNear(bulletX, bulletY, hitDistance, [&](int i) {
+            if (enemyDead[i] || (hitIndex != -1 && i > hitIndex)) return;
+            float dx = bulletX - (enemies.x[i] + ENEMY_SIZE / 2);
+            float dy = bulletY - (enemies.y[i] + ENEMY_SIZE / 2);
+            if (dx * dx + dy * dy < hitDistance * hitDistance) hitIndex = i;
+        });
+
+        if (hitIndex != -1) {
+            QueueSound(SOUND_ENEMY_DEATH);
+
+            float angleDiff1 = fabs(bullets.angle[b] - (player1.angle * M_PI / 180.0));
+            float angleDiff2 = fabs(bullets.angle[b] - (player2.angle * M_PI / 180.0));
+            if (angleDiff1 < angleDiff2 && player1.isAlive) {
+                player1Info.score += 10;
+            } else if (player2.isAlive) {
+                player2Info.score += 10;
             }
-        }
-        if (hit) {
-            bulletIt = bullets.erase(bulletIt);
-        } else {
-            ++bulletIt;
+
+            enemyDead[hitIndex] = true;
+            bulletDead[b] = true;
         }
     }
+    bullets.Compact(bulletDead);
+
+    // Xóa enemy chết một lần sau khi xét hết đạn, giữ nguyên thứ tự
+    enemies.Compact(enemyDead);
 }
 
 void SurvivalGame::UpdateBulletSystem(float deltaTime) {
@@ -563,7 +764,11 @@ void SurvivalGame::UpdateBulletSystem(float deltaTime) {
     }
 }
 
-void SurvivalGame::RenderUI() {
+void SurvivalGame::RenderUI(const Snapshot& view) {
+    const PlayerInfo& player1Info = view.player1Info;
+    const PlayerInfo& player2Info = view.player2Info;
+    const BulletInfo& player1BulletInfo = view.player1BulletInfo;
+    const BulletInfo& player2BulletInfo = view.player2BulletInfo;
     SDL_Color white = {255, 255, 255, 255};
     const int UI_ELEMENT_SPACING = 10;
     const int BULLET_ICON_SIZE = 20;
@@ -571,7 +776,7 @@ void SurvivalGame::RenderUI() {
     const int UI_TOP_OFFSET = 5;
 
     SDL_Rect avatar1Rect = {UI_MARGIN, UI_TOP_OFFSET, AVATAR_SIZE, AVATAR_SIZE};
-    SDL_RenderCopy(renderer, player1Info.avatar, nullptr, &avatar1Rect);
+    sprites.Draw(player1Info.avatar, avatar1Rect);
 
     int rightOfAvatarX = UI_MARGIN + AVATAR_SIZE + UI_ELEMENT_SPACING;
 
@@ -581,17 +786,15 @@ void SurvivalGame::RenderUI() {
             UI_TOP_OFFSET + (AVATAR_SIZE - HEART_SIZE) / 2,
             HEART_SIZE, HEART_SIZE
         };
-        SDL_RenderCopy(renderer, player1Info.heartTexture, nullptr, &heartRect);
+        sprites.Draw(player1Info.heartSprite, heartRect);
     }
 
     int score1Y = UI_TOP_OFFSET + AVATAR_SIZE - HEART_SIZE + UI_ELEMENT_SPACING - 3;
     std::string score1Text = "Score: " + std::to_string(player1Info.score);
-    SDL_Surface* score1Surface = TTF_RenderText_Solid(font, score1Text.c_str(), white);
-    SDL_Texture* score1Texture = SDL_CreateTextureFromSurface(renderer, score1Surface);
-    SDL_Rect score1Rect = {rightOfAvatarX, score1Y, score1Surface->w, score1Surface->h};
-    SDL_RenderCopy(renderer, score1Texture, nullptr, &score1Rect);
+    SDL_Point score1Size = textRenderer.MeasureGlyphs(score1Text);
+    textRenderer.DrawGlyphs(score1Text, white, rightOfAvatarX, score1Y);
 
-    int bullet1Y = score1Y + score1Surface->h + UI_ELEMENT_SPACING - 3;
+    int bullet1Y = score1Y + score1Size.y + UI_ELEMENT_SPACING - 3;
     for (int i = 0; i < MAX_BULLETS; i++) {
         if (player1BulletInfo.bulletStates[i]) {
             SDL_Rect bulletRect = {
@@ -599,13 +802,13 @@ void SurvivalGame::RenderUI() {
                 bullet1Y,
                 BULLET_ICON_SIZE, BULLET_ICON_SIZE
             };
-            SDL_RenderCopy(renderer, player1BulletInfo.bulletIcon, nullptr, &bulletRect);
+            sprites.Draw(player1BulletInfo.bulletIcon, bulletRect);
         }
     }
 
     int player2AvatarX = SCREEN_WIDTH - UI_MARGIN - AVATAR_SIZE;
     SDL_Rect avatar2Rect = {player2AvatarX, UI_TOP_OFFSET, AVATAR_SIZE, AVATAR_SIZE};
-    SDL_RenderCopy(renderer, player2Info.avatar, nullptr, &avatar2Rect);
+    sprites.Draw(player2Info.avatar, avatar2Rect);
 
     int player2UIStartX = player2AvatarX - UI_ELEMENT_SPACING;
 
@@ -615,17 +818,15 @@ void SurvivalGame::RenderUI() {
             UI_TOP_OFFSET + (AVATAR_SIZE - HEART_SIZE) / 2,
             HEART_SIZE, HEART_SIZE
         };
-        SDL_RenderCopy(renderer, player2Info.heartTexture, nullptr, &heartRect);
+        sprites.Draw(player2Info.heartSprite, heartRect);
     }
 
     std::string score2Text = "Score: " + std::to_string(player2Info.score);
-    SDL_Surface* score2Surface = TTF_RenderText_Solid(font, score2Text.c_str(), white);
-    SDL_Texture* score2Texture = SDL_CreateTextureFromSurface(renderer, score2Surface);
-    int score2X = player2UIStartX - score2Surface->w;
-    SDL_Rect score2Rect = {score2X, score1Y, score2Surface->w, score2Surface->h};
-    SDL_RenderCopy(renderer, score2Texture, nullptr, &score2Rect);
+    SDL_Point score2Size = textRenderer.MeasureGlyphs(score2Text);
+    int score2X = player2UIStartX - score2Size.x;
+    textRenderer.DrawGlyphs(score2Text, white, score2X, score1Y);
 
-    int bullet2Y = score1Y + score2Surface->h + UI_ELEMENT_SPACING - 3;
+    int bullet2Y = score1Y + score2Size.y + UI_ELEMENT_SPACING - 3;
     for (int i = 0; i < MAX_BULLETS; i++) {
         if (player2BulletInfo.bulletStates[i]) {
             SDL_Rect bulletRect = {
@@ -633,75 +834,73 @@ void SurvivalGame::RenderUI() {
                 bullet2Y,
                 BULLET_ICON_SIZE, BULLET_ICON_SIZE
             };
-            SDL_RenderCopy(renderer, player2BulletInfo.bulletIcon, nullptr, &bulletRect);
+            sprites.Draw(player2BulletInfo.bulletIcon, bulletRect);
         }
     }
 
-    Uint32 currentTime = (SDL_GetTicks() - startTime) / 1000;
+    Uint32 currentTime = TicksToMs(view.simTick) / 1000;
     int minutes = currentTime / 60;
     int seconds = currentTime % 60;
     std::string timeText = std::to_string(minutes) + ":" + (seconds < 10 ? "0" : "") + std::to_string(seconds);
-    SDL_Surface* timeSurface = TTF_RenderText_Solid(font, timeText.c_str(), white);
-    SDL_Texture* timeTexture = SDL_CreateTextureFromSurface(renderer, timeSurface);
-    SDL_Rect timeRect = {SCREEN_WIDTH / 2 - timeSurface->w / 2, UI_TOP_OFFSET, timeSurface->w, timeSurface->h};
-    SDL_RenderCopy(renderer, timeTexture, nullptr, &timeRect);
+    SDL_Point timeSize = textRenderer.MeasureGlyphs(timeText);
+    textRenderer.DrawGlyphs(timeText, white, SCREEN_WIDTH / 2 - timeSize.x / 2, UI_TOP_OFFSET);
 
-    SDL_FreeSurface(score1Surface);
-    SDL_DestroyTexture(score1Texture);
-    SDL_FreeSurface(score2Surface);
-    SDL_DestroyTexture(score2Texture);
-    SDL_FreeSurface(timeSurface);
-    SDL_DestroyTexture(timeTexture);
+    sprites.Flush();  // Avatar, tim và icon đạn: mỗi texture một lần vẽ
 }
 
 void SurvivalGame::CheckEnemyPlayerCollision() {
-    if (player1.isAlive && !IsPlayerInvincible(player1InvincibleStart)) {
-        for (auto enemyIt = enemies.begin(); enemyIt != enemies.end();) {
-            if (std::abs(enemyIt->x - player1.x) < ENEMY_SIZE/2 + PLAYER_WIDTH/2 &&
-                std::abs(enemyIt->y - player1.y) < ENEMY_SIZE/2 + PLAYER_HEIGHT/2) {
+    // Enemy va vào người chơi bị đánh dấu rồi xóa một lần ở cuối
+    bool anyDead = false;
+    enemyDead.assign(enemies.Size(), false);
+
+    if (player1.isAlive && !IsPlayerInvincible(player1InvincibleUntil)) {
+        for (size_t i = 0; i < enemies.Size(); i++) {
+            if (std::abs(enemies.x[i] - player1.x) < ENEMY_SIZE/2 + PLAYER_WIDTH/2 &&
+                std::abs(enemies.y[i] - player1.y) < ENEMY_SIZE/2 + PLAYER_HEIGHT/2) {
                 player1Info.lives--;
-                Mix_PlayChannel(-1, playerDeathSound, 0);
-                player1InvincibleStart = SDL_GetTicks();
+                QueueSound(SOUND_PLAYER_DEATH);
+                player1InvincibleUntil = simTick + MsToTicks(INVINCIBLE_DURATION);
                 player1IsInvincible = true;
 
                 if (player1Info.lives <= 0) {
-                    explosions.emplace_back(player1.x, player1.y);
-                    afterBoomMarks.emplace_back(player1.x, player1.y);
+                    explosions.Acquire(Explosion(player1.x, player1.y, simTick));
+                    AddAfterBoomMark(player1.x, player1.y);
                     player1.isAlive = false;
                     player1IsInvincible = false;
                 }
 
-                enemyIt = enemies.erase(enemyIt);
+                enemyDead[i] = true;
+                anyDead = true;
                 break;
-            } else {
-                ++enemyIt;
             }
         }
     }
 
-    if (player2.isAlive && !IsPlayerInvincible(player2InvincibleStart)) {
-        for (auto enemyIt = enemies.begin(); enemyIt != enemies.end();) {
-            if (std::abs(enemyIt->x - player2.x) < ENEMY_SIZE/2 + PLAYER_WIDTH/2 &&
-                std::abs(enemyIt->y - player2.y) < ENEMY_SIZE/2 + PLAYER_HEIGHT/2) {
+    if (player2.isAlive && !IsPlayerInvincible(player2InvincibleUntil)) {
+        for (size_t i = 0; i < enemies.Size(); i++) {
+            if (enemyDead[i]) continue;
+            if (std::abs(enemies.x[i] - player2.x) < ENEMY_SIZE/2 + PLAYER_WIDTH/2 &&
+                std::abs(enemies.y[i] - player2.y) < ENEMY_SIZE/2 + PLAYER_HEIGHT/2) {
                 player2Info.lives--;
-                Mix_PlayChannel(-1, playerDeathSound, 0);
-                player2InvincibleStart = SDL_GetTicks();
+                QueueSound(SOUND_PLAYER_DEATH);
+                player2InvincibleUntil = simTick + MsToTicks(INVINCIBLE_DURATION);
                 player2IsInvincible = true;
 
                 if (player2Info.lives <= 0) {
-                    explosions.emplace_back(player2.x, player2.y);
-                    afterBoomMarks.emplace_back(player2.x, player2.y);
+                    explosions.Acquire(Explosion(player2.x, player2.y, simTick));
+                    AddAfterBoomMark(player2.x, player2.y);
                     player2.isAlive = false;
                     player2IsInvincible = false;
                 }
 
-                enemyIt = enemies.erase(enemyIt);
+                enemyDead[i] = true;
+                anyDead = true;
                 break;
-            } else {
-                ++enemyIt;
             }
         }
     }
+
+    if (anyDead) enemies.Compact(enemyDead);
 }
 
 bool SurvivalGame::CheckCollision(float x1, float y1, float x2, float y2) {
@@ -710,45 +909,27 @@ bool SurvivalGame::CheckCollision(float x1, float y1, float x2, float y2) {
 }
 
 void SurvivalGame::UpdateExplosions() {
-    const Uint32 explosionDuration = 500;
-    Uint32 currentTime = SDL_GetTicks();
-
-    for (auto it = explosions.begin(); it != explosions.end();) {
-        if (currentTime - it->startTime > explosionDuration) {
-            it = explosions.erase(it);
-        } else {
-            ++it;
-        }
-    }
+    const Uint32 explosionDuration = MsToTicks(500);
+    explosions.ReleaseIf([&](const Explosion& explosion) { return simTick - explosion.startTick > explosionDuration; });
 }
 
 void SurvivalGame::UpdateBullets() {
-    for (auto it = bullets.begin(); it != bullets.end();) {
-        it->x += BULLET_SPEED * cos(it->angle);
-        it->y += BULLET_SPEED * sin(it->angle);
-
-        if (it->x < PLAY_AREA_MIN_X || it->x > PLAY_AREA_MAX_X ||
-            it->y < PLAY_AREA_MIN_Y || it->y > PLAY_AREA_MAX_Y) {
-            it = bullets.erase(it);
-        } else {
-            ++it;
-        }
-    }
+    const BulletBounds playArea = {PLAY_AREA_MIN_X, PLAY_AREA_MIN_Y, PLAY_AREA_MAX_X, PLAY_AREA_MAX_Y};
+    bullets.IntegrateAndCull(&playArea, 1, jobs);
 }
 
-bool SurvivalGame::IsPlayerInvincible(Uint32 invincibleStart) {
-    if (invincibleStart == 0) return false;
-    return (SDL_GetTicks() - invincibleStart) < INVINCIBLE_DURATION;
+bool SurvivalGame::IsPlayerInvincible(Uint32 invincibleUntil) {
+    return simTick < invincibleUntil;
 }
 
-void SurvivalGame::RenderShieldEffect(float playerX, float playerY, Uint32 invincibleStart) {
-    if (IsPlayerInvincible(invincibleStart)) {
+void SurvivalGame::RenderShieldEffect(const Snapshot& view, const Player& player, Uint32 invincibleUntil) {
+    if (view.simTick < invincibleUntil) {
         SDL_Rect shieldRect = {
-            static_cast<int>(playerX + PLAYER_WIDTH/2 - SHIELD_SIZE/2),
-            static_cast<int>(playerY + PLAYER_HEIGHT/2 - SHIELD_SIZE/2),
+            static_cast<int>(player.x + PLAYER_WIDTH/2 - SHIELD_SIZE/2),
+            static_cast<int>(player.y + PLAYER_HEIGHT/2 - SHIELD_SIZE/2),
             SHIELD_SIZE, SHIELD_SIZE
         };
-        SDL_RenderCopy(renderer, shieldTexture, nullptr, &shieldRect);
+        sprites.Draw(shieldSprite, shieldRect);
     }
 }
 
@@ -757,185 +938,167 @@ bool SurvivalGame::IsMouseOverButton(int mouseX, int mouseY, int buttonX, int bu
             mouseY >= buttonY && mouseY <= buttonY + buttonH);
 }
 
-void SurvivalGame::HandleGameOverInput() {
-    SDL_Event e;
-    int mouseX, mouseY;
-    while (SDL_PollEvent(&e)) {
-        if (e.type == SDL_QUIT) {
-            isRunning = false;
-        }
-        if (e.type == SDL_MOUSEBUTTONDOWN) {
-            SDL_GetMouseState(&mouseX, &mouseY);
-            int restartButtonX = BUTTON_WIDTH - 5;
-            int restartButtonY = SCREEN_HEIGHT / 2 + 280;
-            int restartButtonW = BUTTON_WIDTH + 190;
-            int restartButtonH = BUTTON_HEIGHT + 30;
-
-            int menuButtonX = SCREEN_WIDTH / 2 + 15;
-            int menuButtonY = SCREEN_HEIGHT / 2 + 280;
-            int menuButtonW = BUTTON_WIDTH + 190;
-            int menuButtonH = BUTTON_HEIGHT + 30;
-
-            if (IsMouseOverButton(mouseX, mouseY, restartButtonX, restartButtonY, restartButtonW, restartButtonH)) {
-                ResetGame();
-            }
-            if (IsMouseOverButton(mouseX, mouseY, menuButtonX, menuButtonY, menuButtonW, menuButtonH)) {
-                isRunning = false;
-            }
-        }
+void SurvivalGame::HandleGameOverClick(int mouseX, int mouseY) {
+    int restartButtonX = BUTTON_WIDTH - 5;
+    int restartButtonY = SCREEN_HEIGHT / 2 + 280;
+    int restartButtonW = BUTTON_WIDTH + 190;
+    int restartButtonH = BUTTON_HEIGHT + 30;
+
+    int menuButtonX = SCREEN_WIDTH / 2 + 15;
+    int menuButtonY = SCREEN_HEIGHT / 2 + 280;
+    int menuButtonW = BUTTON_WIDTH + 190;
+    int menuButtonH = BUTTON_HEIGHT + 30;
+
+    if (IsMouseOverButton(mouseX, mouseY, restartButtonX, restartButtonY, restartButtonW, restartButtonH)) {
+        ResetGame();
+    }
+    if (IsMouseOverButton(mouseX, mouseY, menuButtonX, menuButtonY, menuButtonW, menuButtonH)) {
+        isRunning = false;
     }
 }
 
 void SurvivalGame::ResetGame() {
     player1 = Player(PLAY_AREA_MIN_X + PLAYER_OFFSET, SCREEN_HEIGHT / 2, 0);
     player2 = Player(PLAY_AREA_MAX_X - PLAYER_WIDTH - PLAYER_OFFSET, SCREEN_HEIGHT / 2, 180);
-    player1Info = {MAX_LIVES, 0, player1Info.avatar, player1Info.heartTexture};
-    player2Info = {MAX_LIVES, 0, player2Info.avatar, player2Info.heartTexture};
-    player1BulletInfo = {MAX_BULLETS, 0.0f, std::vector<bool>(MAX_BULLETS, true), player1BulletInfo.bulletIcon};
-    player2BulletInfo = {MAX_BULLETS, 0.0f, std::vector<bool>(MAX_BULLETS, true), player2BulletInfo.bulletIcon};
-    bullets.clear();
-    enemies.clear();
-    explosions.clear();
-    afterBoomMarks.clear();
-    startTime = SDL_GetTicks();
-    lastSpawnTime = 0;
+    player1Input = PlayerInput{};
+    player2Input = PlayerInput{};
+    player1Info = {MAX_LIVES, 0, player1Info.avatar, player1Info.heartSprite};
+    player2Info = {MAX_LIVES, 0, player2Info.avatar, player2Info.heartSprite};
+    player1BulletInfo.Refill();
+    player2BulletInfo.Refill();
+    // Các pool giữ nguyên bộ nhớ, chơi lại không cấp phát
+    bullets.Clear();
+    enemies.Clear();
+    explosions.Clear();
+    pendingSounds.clear();
+    generation++;  // Decal thuộc main thread: Render() xóa khi thấy generation đổi; vết mới mang generation này
+    simTick = 0;
+    nextSpawnTick = 0;
+    nextFireTick1 = 0;
+    nextFireTick2 = 0;
     player1IsInvincible = false;
     player2IsInvincible = false;
-    player1InvincibleStart = 0;
-    player2InvincibleStart = 0;
+    player1InvincibleUntil = 0;
+    player2InvincibleUntil = 0;
     spawnRate = 5000;
+    isPaused = false;
+    isDraggingMusic = false;
+    isDraggingSFX = false;
     showGameOverScreen = false;
+    endGameTime = 0;
+    SavePreviousState();
+    clock.Reset();
 }
 
-void SurvivalGame::RenderGameOverScreen() {
+void SurvivalGame::RenderGameOverScreen(const Snapshot& view) {
     SDL_Color white = {255, 255, 255, 255};
     SDL_Color yellow = {255, 255, 0, 255};
 
     SDL_Rect backgroundRect = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
     SDL_RenderCopy(renderer, gameOverBackgroundTexture, nullptr, &backgroundRect);
 
-    int totalScore = player1Info.score + player2Info.score;
-    Uint32 playTime = endGameTime / 1000;
+    int totalScore = view.player1Info.score + view.player2Info.score;
+    Uint32 playTime = view.endGameTime / 1000;
     int minutes = playTime / 60;
     int seconds = playTime % 60;
 
     std::string player1Text = "Player 1";
-    SDL_Surface* player1Surface = TTF_RenderText_Solid(font, player1Text.c_str(), white);
-    SDL_Texture* player1Texture = SDL_CreateTextureFromSurface(renderer, player1Surface);
+    const TextRenderer::TextImage& player1Image = textRenderer.Cached("gameover.player1", player1Text, white);
     SDL_Rect player1Rect = {
-        SCREEN_WIDTH / 4 - player1Surface->w / 2 + 30,
+        SCREEN_WIDTH / 4 - player1Image.w / 2 + 30,
         SCREEN_HEIGHT / 2 + 12,
-        player1Surface->w, player1Surface->h
+        player1Image.w, player1Image.h
     };
-    SDL_RenderCopy(renderer, player1Texture, nullptr, &player1Rect);
+    SDL_RenderCopy(renderer, player1Image.texture, nullptr, &player1Rect);
 
-    std::string score1Text = "Score: " + std::to_string(player1Info.score);
-    SDL_Surface* score1Surface = TTF_RenderText_Solid(font, score1Text.c_str(), white);
-    SDL_Texture* score1Texture = SDL_CreateTextureFromSurface(renderer, score1Surface);
+    std::string score1Text = "Score: " + std::to_string(view.player1Info.score);
+    const TextRenderer::TextImage& score1Image = textRenderer.Cached("gameover.score1", score1Text, white);
     SDL_Rect score1Rect = {
-        SCREEN_WIDTH / 4 - score1Surface->w / 2 + 30,
-        player1Rect.y + player1Surface->h - 15,
-        score1Surface->w, score1Surface->h
+        SCREEN_WIDTH / 4 - score1Image.w / 2 + 30,
+        player1Rect.y + player1Image.h - 15,
+        score1Image.w, score1Image.h
     };
-    SDL_RenderCopy(renderer, score1Texture, nullptr, &score1Rect);
+    SDL_RenderCopy(renderer, score1Image.texture, nullptr, &score1Rect);
 
     std::string player2Text = "Player 2";
-    SDL_Surface* player2Surface = TTF_RenderText_Solid(font, player2Text.c_str(), white);
-    SDL_Texture* player2Texture = SDL_CreateTextureFromSurface(renderer, player2Surface);
+    const TextRenderer::TextImage& player2Image = textRenderer.Cached("gameover.player2", player2Text, white);
     SDL_Rect player2Rect = {
-        3 * SCREEN_WIDTH / 4 - player2Surface->w / 2 - 30,
+        3 * SCREEN_WIDTH / 4 - player2Image.w / 2 - 30,
         SCREEN_HEIGHT / 2 + 12,
-        player2Surface->w, player2Surface->h
+        player2Image.w, player2Image.h
     };
-    SDL_RenderCopy(renderer, player2Texture, nullptr, &player2Rect);
+    SDL_RenderCopy(renderer, player2Image.texture, nullptr, &player2Rect);
 
-    std::string score2Text = "Score: " + std::to_string(player2Info.score);
-    SDL_Surface* score2Surface = TTF_RenderText_Solid(font, score2Text.c_str(), white);
-    SDL_Texture* score2Texture = SDL_CreateTextureFromSurface(renderer, score2Surface);
+    std::string score2Text = "Score: " + std::to_string(view.player2Info.score);
+    const TextRenderer::TextImage& score2Image = textRenderer.Cached("gameover.score2", score2Text, white);
     SDL_Rect score2Rect = {
-        3 * SCREEN_WIDTH / 4 - score2Surface->w / 2 - 30,
-        player2Rect.y + player2Surface->h - 15,
-        score2Surface->w, score2Surface->h
+        3 * SCREEN_WIDTH / 4 - score2Image.w / 2 - 30,
+        player2Rect.y + player2Image.h - 15,
+        score2Image.w, score2Image.h
     };
-    SDL_RenderCopy(renderer, score2Texture, nullptr, &score2Rect);
+    SDL_RenderCopy(renderer, score2Image.texture, nullptr, &score2Rect);
 
     std::string totalScoreText = "Total Score: " + std::to_string(totalScore);
-    SDL_Surface* totalScoreSurface = TTF_RenderText_Solid(font, totalScoreText.c_str(), white);
-    SDL_Texture* totalScoreTexture = SDL_CreateTextureFromSurface(renderer, totalScoreSurface);
+    const TextRenderer::TextImage& totalScoreImage = textRenderer.Cached("gameover.totalScore", totalScoreText, white);
     SDL_Rect totalScoreRect = {
-        SCREEN_WIDTH / 2 - totalScoreSurface->w / 2,
+        SCREEN_WIDTH / 2 - totalScoreImage.w / 2,
         SCREEN_HEIGHT / 2 + 100,
-        totalScoreSurface->w, totalScoreSurface->h
+        totalScoreImage.w, totalScoreImage.h
     };
-    SDL_RenderCopy(renderer, totalScoreTexture, nullptr, &totalScoreRect);
+    SDL_RenderCopy(renderer, totalScoreImage.texture, nullptr, &totalScoreRect);
 
     std::string timeText = "Play Time: " + std::to_string(minutes) + ":" + (seconds < 10 ? "0" : "") + std::to_string(seconds);
-    SDL_Surface* timeSurface = TTF_RenderText_Solid(font, timeText.c_str(), white);
-    SDL_Texture* timeTexture = SDL_CreateTextureFromSurface(renderer, timeSurface);
+    const TextRenderer::TextImage& timeImage = textRenderer.Cached("gameover.time", timeText, white);
     SDL_Rect timeRect = {
-        SCREEN_WIDTH / 2 - timeSurface->w / 2,
+        SCREEN_WIDTH / 2 - timeImage.w / 2,
         SCREEN_HEIGHT / 2 + 150,
-        timeSurface->w, timeSurface->h
+        timeImage.w, timeImage.h
     };
-    SDL_RenderCopy(renderer, timeTexture, nullptr, &timeRect);
+    SDL_RenderCopy(renderer, timeImage.texture, nullptr, &timeRect);
 
-    std::string highScoreText = "High Score: " + std::to_string(highScore);
-    SDL_Surface* highScoreSurface = TTF_RenderText_Solid(font, highScoreText.c_str(), yellow);
-    SDL_Texture* highScoreTexture = SDL_CreateTextureFromSurface(renderer, highScoreSurface);
+    std::string highScoreText = "High Score: " + std::to_string(view.highScore);
+    const TextRenderer::TextImage& highScoreImage = textRenderer.Cached("gameover.highScore", highScoreText, yellow);
     SDL_Rect highScoreRect = {
-        SCREEN_WIDTH / 2 - highScoreSurface->w / 2,
+        SCREEN_WIDTH / 2 - highScoreImage.w / 2,
         SCREEN_HEIGHT / 2 + 200,
-        highScoreSurface->w, highScoreSurface->h
+        highScoreImage.w, highScoreImage.h
     };
-    SDL_RenderCopy(renderer, highScoreTexture, nullptr, &highScoreRect);
-
-    SDL_FreeSurface(player1Surface);
-    SDL_DestroyTexture(player1Texture);
-    SDL_FreeSurface(score1Surface);
-    SDL_DestroyTexture(score1Texture);
-    SDL_FreeSurface(player2Surface);
-    SDL_DestroyTexture(player2Texture);
-    SDL_FreeSurface(score2Surface);
-    SDL_DestroyTexture(score2Texture);
-    SDL_FreeSurface(totalScoreSurface);
-    SDL_DestroyTexture(totalScoreTexture);
-    SDL_FreeSurface(timeSurface);
-    SDL_DestroyTexture(timeTexture);
-    SDL_FreeSurface(highScoreSurface);
-    SDL_DestroyTexture(highScoreTexture);
+    SDL_RenderCopy(renderer, highScoreImage.texture, nullptr, &highScoreRect);
 }
 
 void SurvivalGame::Cleanup() {
-    if (player1BulletInfo.bulletIcon && player1BulletInfo.bulletIcon == player2BulletInfo.bulletIcon) {
-        SDL_DestroyTexture(player1BulletInfo.bulletIcon);
-        player1BulletInfo.bulletIcon = nullptr;
-        player2BulletInfo.bulletIcon = nullptr;
-    }
-    if (player1Info.heartTexture && player1Info.heartTexture == player2Info.heartTexture) {
-        SDL_DestroyTexture(player1Info.heartTexture);
-        player1Info.heartTexture = nullptr;
-        player2Info.heartTexture = nullptr;
-    }
-
-    if (player1Info.avatar) SDL_DestroyTexture(player1Info.avatar);
-    if (player2Info.avatar) SDL_DestroyTexture(player2Info.avatar);
-    if (playerTexture) SDL_DestroyTexture(playerTexture);
-    if (player2Texture) SDL_DestroyTexture(player2Texture);
-    if (bulletTexture) SDL_DestroyTexture(bulletTexture);
-    if (backgroundTexture) SDL_DestroyTexture(backgroundTexture);
-    if (grassTexture) SDL_DestroyTexture(grassTexture);
-    if (enemyTexture) SDL_DestroyTexture(enemyTexture);
-    if (boomTexture) SDL_DestroyTexture(boomTexture);
-    if (afterBoomTexture) SDL_DestroyTexture(afterBoomTexture);
-    if (shieldTexture) SDL_DestroyTexture(shieldTexture);
-    if (gameOverBackgroundTexture) SDL_DestroyTexture(gameOverBackgroundTexture);
-    if (pauseTexture) SDL_DestroyTexture(pauseTexture);
-    if (menuButtonTexture) SDL_DestroyTexture(menuButtonTexture);
-
-    if (enemyDeathSound) Mix_FreeChunk(enemyDeathSound);
-    if (playerDeathSound) Mix_FreeChunk(playerDeathSound);
-    if (spawnSound) Mix_FreeChunk(spawnSound);
-    if (backgroundMusic) Mix_FreeMusic(backgroundMusic);
+    StopSimulation();
+    DestroySprite(player1BulletInfo.bulletIcon);
+    DestroySprite(player2BulletInfo.bulletIcon);
+    DestroySprite(player1Info.heartSprite);
+    DestroySprite(player2Info.heartSprite);
+    DestroySprite(player1Info.avatar);
+    DestroySprite(player2Info.avatar);
+    DestroySprite(playerSprite);
+    DestroySprite(player2Sprite);
+    DestroySprite(bulletSprite);
+    ReleaseAsset(backgroundTexture);
+    DestroySprite(grassSprite);
+    DestroySprite(enemySprite);
+    DestroySprite(boomSprite);
+    DestroySprite(afterBoomSprite);
+    decals.Destroy();
+    textRenderer.Destroy();
+    DestroySprite(shieldSprite);
+    atlas.Destroy();
+    ReleaseAsset(gameOverBackgroundTexture);
+    ReleaseAsset(pauseTexture);
+    ReleaseAsset(menuButtonTexture);
+
+    if (backgroundMusic && Mix_PlayingMusic()) Mix_HaltMusic();  // Nhạc vẫn nằm trong cache nên phải tự dừng
+    ReleaseAsset(enemyDeathSound);
+    ReleaseAsset(playerDeathSound);
+    ReleaseAsset(spawnSound);
+    ReleaseAsset(backgroundMusic);
+    if (assets == ownedAssets) assets = nullptr;
+    delete ownedAssets;
+    ownedAssets = nullptr;
+    resourcesLoaded = false;
 
     isRunning = false;
 }
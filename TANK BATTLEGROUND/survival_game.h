@@ -11,18 +11,52 @@
 #include <algorithm>
 #include <cstdlib>
 #include <ctime>
+#include <random>
+#include "simulation.h"
+#include "spatial_grid.h"
+#include "enemy_store.h"
+#include "bullet_store.h"
+#include "job_system.h"
+#include "object_pool.h"
+#include "decal_layer.h"
+#include "text_renderer.h"
+#include "sprite_batch.h"
+#include "texture_atlas.h"
+#include "asset_loader.h"
+#include "sim_thread.h"
+#include "spsc_queue.h"
+#include "triple_buffer.h"
 
 class SurvivalGame {
 public:
-    SurvivalGame(SDL_Renderer* renderer, TTF_Font* font);
+    // Dung lượng mặc định của pool đạn và enemy, cấp phát một lần khi tạo game
+    static const int MAX_LIVE_BULLETS = 64;
+    static const int MAX_LIVE_ENEMIES = 256;
+
+    // renderer == nullptr: chạy headless, không tải texture/âm thanh và không vẽ
+    SurvivalGame(SDL_Renderer* renderer, TTF_Font* font, int maxEnemies = MAX_LIVE_ENEMIES,
+                 int maxBullets = MAX_LIVE_BULLETS);
     ~SurvivalGame();
 
-    bool Initialize();
-    void HandleInput();
+    bool Initialize();  // Gọi lại được: lần sau dùng tiếp tài nguyên đã nạp, chỉ đặt lại ván chơi
+    void ResetGame();   // Về trạng thái đầu ván, giữ texture/âm thanh và bộ nhớ của các pool
+    void StopSimulation();  // Chờ thread mô phỏng (do Initialize() chạy) kết thúc
+    // Main thread chuyển input sang thread mô phỏng; QueueKeys() gửi phím điều khiển sau mỗi lượt poll
+    void QueueEvent(const SDL_Event& event);
+    void QueueKeys();
     void Update();
-    void Render();
-    bool IsRunning() const { return isRunning; }
-    void Run();
+    void Step();  // Chạy đúng một tick mô phỏng
+    void SetTimeScale(double scale) { clock.SetTimeScale(scale); }
+    void Seed(unsigned int seed) { rng.seed(seed); }
+    void SetPlayerInput(const PlayerInput& input1, const PlayerInput& input2);
+    void SetJobSystem(JobSystem* jobSystem) { jobs = jobSystem; }  // nullptr: chạy tuần tự
+    void SetAssetCache(AssetCache* cache) { assets = cache; }  // Gọi trước Initialize(); nullptr: tự tạo cache riêng
+    static void QueueAssets(AssetLoader& loader);  // Xếp hàng đúng các tài nguyên Initialize() nạp, giữ hai nơi khớp nhau
+    MatchResult GetMatchResult() const;
+    void ReportPoolUsage(std::ostream& out) const;  // In số đối tượng sống nhiều nhất / dung lượng của từng pool
+    void Render();  // Vẽ snapshot mới nhất, không đọc trạng thái thread mô phỏng đang ghi; người gọi present
+    bool IsIdle() { return renderedIdle && !snapshots.HasFresh(); }  // Khung đã vẽ là pause/hết ván và chưa có gì mới
+    bool IsRunning() const { return headless ? isRunning : simulation.IsRunning(); }
 
 private:
     // Các hằng số game
@@ -51,6 +85,10 @@ private:
     static const int SHIELD_SIZE = 80;
     static const int BUTTON_WIDTH = 100;
     static const int BUTTON_HEIGHT = 50;
+    static const int COLLISION_CELL_SIZE = 64;
+    // Dung lượng các pool, cấp phát một lần khi tạo game
+    static const int MAX_EXPLOSIONS = 64;
+    static const int MAX_AFTER_BOOM_MARKS = 512;  // Vết chờ in vào lớp decal
 
 
     struct Player {
@@ -64,55 +102,80 @@ private:
     struct PlayerInfo {
         int lives;
         int score;
-        SDL_Texture* avatar;
-        SDL_Texture* heartTexture;
-    };
-
-    struct Bullet {
-        float x, y;
-        float angle;
-        Bullet(float x, float y, float angle) : x(x), y(y), angle(angle) {}
-    };
-
-    struct Enemy {
-        float x, y;
-        Enemy(float startX, float startY) : x(startX), y(startY) {}
+        Sprite avatar;
+        Sprite heartSprite;
     };
 
     struct Explosion {
         float x, y;
-        Uint32 startTime;
+        Uint32 startTick;
         bool active;
-        Explosion(float x, float y) : x(x), y(y), startTime(SDL_GetTicks()), active(true) {}
-    };
-
-    struct AfterBoomMark {
-        float x, y;
-        AfterBoomMark(float x, float y) : x(x), y(y) {}
+        Explosion(float x, float y, Uint32 startTick) : x(x), y(y), startTick(startTick), active(true) {}
     };
 
     struct BulletInfo {
         int currentBullets;
         float reloadTimer;
         std::vector<bool> bulletStates;
-        SDL_Texture* bulletIcon;
+        Sprite bulletIcon;
+
+        // Nạp đầy băng đạn khi chơi lại, dùng lại vector bulletStates thay vì tạo mới
+        void Refill() {
+            currentBullets = static_cast<int>(bulletStates.size());
+            reloadTimer = 0.0f;
+            std::fill(bulletStates.begin(), bulletStates.end(), true);
+        }
+    };
+
+    // Những gì Render() cần, thread mô phỏng chép ra sau mỗi lượt tick. Pool có dung lượng cố định
+    // nên chép bằng phép gán không cấp phát.
+    struct Snapshot {
+        Uint32 simTick;
+        Uint32 generation;  // Tăng mỗi lần ResetGame(): Render() xóa decal của ván trước
+        float alpha;        // clock.Alpha() lúc công bố; 1 khi đứng yên (pause, hết ván)
+        Uint64 publishedAt;
+        Player player1;
+        Player player2;
+        Player previousPlayer1;  // Trạng thái tick trước, Render() nội suy tới player1/player2
+        Player previousPlayer2;
+        Uint32 player1InvincibleUntil;
+        Uint32 player2InvincibleUntil;
+        PlayerInfo player1Info;
+        PlayerInfo player2Info;
+        BulletInfo player1BulletInfo;
+        BulletInfo player2BulletInfo;
+        BulletStore bullets;
+        EnemyStore enemies;
+        std::vector<Explosion> explosions;
+        bool isPaused;
+        bool showGameOverScreen;
+        Uint32 endGameTime;
+        int highScore;
+        int musicVolume;
+        int sfxVolume;
+
+        Snapshot();
     };
 
     // Biến thành viên
     SDL_Renderer* renderer;
     TTF_Font* font;
     bool isRunning;
+    bool headless;
+    bool resourcesLoaded;
+    std::mt19937 rng;
+    std::vector<GameSound> pendingSounds;
 
     // Textures
-    SDL_Texture* playerTexture;
-    SDL_Texture* player2Texture;
-    SDL_Texture* bulletTexture;
+    Sprite playerSprite;
+    Sprite player2Sprite;
+    Sprite bulletSprite;
     SDL_Texture* backgroundTexture;
-    SDL_Texture* grassTexture;
-    SDL_Texture* enemyTexture;
-    SDL_Texture* boomTexture;
-    SDL_Texture* afterBoomTexture;
-    SDL_Texture* shieldTexture;
+    Sprite grassSprite;
+    Sprite enemySprite;
+    Sprite boomSprite;
+    Sprite afterBoomSprite;
+    Sprite shieldSprite;
     SDL_Texture* gameOverBackgroundTexture;
     SDL_Texture* pauseTexture;
     SDL_Texture* menuButtonTexture;
@@ -124,15 +187,16 @@ private:
     Mix_Music* backgroundMusic;
 
     // Thông tin game
-    Uint32 startTime;
-    Uint32 lastFireTime1;
-    Uint32 lastFireTime2;
-    Uint32 lastSpawnTime;
+    FixedTimestep clock;
+    Uint32 simTick;
+    Uint32 nextFireTick1;
+    Uint32 nextFireTick2;
+    Uint32 nextSpawnTick;
     int spawnRate;
     BulletInfo player1BulletInfo;
     BulletInfo player2BulletInfo;
-    Uint32 player1InvincibleStart;
-    Uint32 player2InvincibleStart;
+    Uint32 player1InvincibleUntil;
+    Uint32 player2InvincibleUntil;
     bool player1IsInvincible;
     bool player2IsInvincible;
     bool isPaused;
@@ -150,32 +214,78 @@ private:
     // Đối tượng game
     Player player1;
     Player player2;
+    Player previousPlayer1;  // Đầu tick vừa chạy, chỉ để Render() nội suy
+    Player previousPlayer2;
+    PlayerInput player1Input;
+    PlayerInput player2Input;
     PlayerInfo player1Info;
     PlayerInfo player2Info;
-    std::vector<Bullet> bullets;
-    std::vector<Enemy> enemies;
-    std::vector<Explosion> explosions;
-    std::vector<AfterBoomMark> afterBoomMarks;
+    BulletStore bullets;
+    EnemyStore enemies;  // Survival chỉ có một loại enemy: type và texture luôn là 0
+    ObjectPool<Explosion> explosions;
+    DecalLayer decals;  // Nền và mọi vết cháy của ván, của main thread
+    TextRenderer textRenderer;  // Atlas cho HUD, cache cho chữ tĩnh
+    AssetCache* assets;       // Texture, âm thanh, nhạc; dùng chung với Game nếu được truyền vào
+    AssetCache* ownedAssets;  // Cache tự tạo khi không có cache dùng chung
+    TextureAtlas atlas;
+    SpriteBatch sprites;  // Sprite gom theo texture, vẽ bằng SDL_RenderGeometry
+
+    // Broadphase va chạm đạn - enemy, dựng lại mỗi tick
+    SpatialGrid enemyGrid;
+    std::vector<bool> enemyDead;  // Enemy bị xóa trong pha hiện tại, dồn mảng một lần bằng Compact()
+    std::vector<bool> bulletDead;
+
+    // Enemy dùng chung rng theo thứ tự nên chỉ có đạn được chia cho worker
+    JobSystem* jobs;
+
+    // Mô phỏng chạy trên thread riêng khi có renderer; chỉ trao đổi với main thread qua ba thứ dưới đây
+    SimulationThread simulation;
+    SpscQueue<InputMessage, 256> input;
+    struct QueuedMark {
+        float x, y;
+        Uint32 generation;  // Ván đã tạo vết; Render() chỉ in vết của ván đang vẽ
+    };
+    SpscQueue<QueuedMark, MAX_AFTER_BOOM_MARKS> newMarks;  // Vết cháy mới, main thread in vào decals
+    TripleBuffer<Snapshot> snapshots;
+    Uint32 generation;
+    Uint32 renderedGeneration;
+    bool renderedIdle;  // Snapshot vẽ gần nhất đang pause hoặc hết ván: không còn gì chuyển động
 
     // Phương thức private
     SDL_Texture* LoadTexture(const char* path);
+    Sprite LoadSprite(const char* id);  // Tìm trong atlas trước, không có thì nạp images/survivalmode/<id>.png
+    void DestroySprite(Sprite& sprite);
+    template <typename T>
+    void ReleaseAsset(T*& asset) {  // Trả tài nguyên về cache và xóa con trỏ, gọi lại lần nữa không sao
+        if (asset && assets) assets->Release(asset);
+        asset = nullptr;
+    }
     Mix_Chunk* LoadSound(const std::string& filePath);
     void SpawnEnemy();
+    void AddAfterBoomMark(float x, float y);
+    void RenderAfterBoomMarks();  // Main thread: in vết mới từ newMarks vào decals rồi vẽ nền kèm vết
     void UpdateEnemies();
     void UpdateBulletSystem(float deltaTime);
     void CheckBulletCollisions();
-    void RenderUI();
+    void RenderUI(const Snapshot& view);
     void CheckEnemyPlayerCollision();
     bool CheckCollision(float x1, float y1, float x2, float y2);
     void UpdateExplosions();
     void UpdateBullets();
-    bool IsPlayerInvincible(Uint32 invincibleStart);
-    void RenderShieldEffect(float playerX, float playerY, Uint32 invincibleStart);
+    void UpdatePlayers();
+    bool IsPlayerInvincible(Uint32 invincibleUntil);
+    void RenderShieldEffect(const Snapshot& view, const Player& player, Uint32 invincibleUntil);
     bool IsMouseOverButton(int mouseX, int mouseY, int buttonX, int buttonY, int buttonW, int buttonH);
-    void HandleGameOverInput();
-    void RenderGameOverScreen();
-    void ResetGame();
+    void HandleEvent(const SDL_Event& e);
+    void HandleGameOverClick(int mouseX, int mouseY);
+    void RenderGameOverScreen(const Snapshot& view);
     void Cleanup();
+    void QueueSound(GameSound sound);
+    void PlayPendingSounds();
+    bool StartSimulation();
+    bool SimulateFrame();  // Một vòng của thread mô phỏng; false khi thoát về menu
+    void PublishSnapshot();
+    void SavePreviousState();  // Đầu mỗi tick và khi ResetGame(): lưu vị trí để nội suy
 };
 
 #endif // SURVIVAL_GAME_H
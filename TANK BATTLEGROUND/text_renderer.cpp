@@ -0,0 +1,124 @@
+#include "text_renderer.h"
+#include <algorithm>
+#include <iostream>
+
+TextRenderer::TextRenderer()
+    : renderer(nullptr), font(nullptr), atlas(nullptr), glyphRects{}, lineHeight(0), emptyImage{nullptr, 0, 0} {}
+
+TextRenderer::~TextRenderer() {
+    Destroy();
+}
+
+bool TextRenderer::Create(SDL_Renderer* rend, TTF_Font* fnt) {
+    Destroy();
+    renderer = rend;
+    font = fnt;
+    if (!renderer || !font) return false;
+
+    // Mỗi ký tự được render riêng bằng TTF_RenderText_Solid nên có cùng chiều cao và đường chân chữ
+    // với chuỗi render trọn; chỉ mất phần kerning giữa các cặp ký tự
+    SDL_Color white = {255, 255, 255, 255};
+    SDL_Surface* glyphs[GLYPH_COUNT] = {};
+    lineHeight = TTF_FontHeight(font);
+    int cellWidth = 1;
+    for (int i = 0; i < GLYPH_COUNT; i++) {
+        char text[2] = {static_cast<char>(FIRST_GLYPH + i), '\0'};
+        glyphs[i] = TTF_RenderText_Solid(font, text, white);
+        int width = 0, height = 0;
+        if (glyphs[i]) width = glyphs[i]->w;
+        else TTF_SizeText(font, text, &width, &height);  // Dấu cách có thể không render được
+        glyphRects[i] = {0, 0, width, lineHeight};
+        cellWidth = std::max(cellWidth, width);
+    }
+
+    int rows = (GLYPH_COUNT + ATLAS_COLUMNS - 1) / ATLAS_COLUMNS;
+    SDL_Surface* atlasSurface = SDL_CreateRGBSurfaceWithFormat(0, cellWidth * ATLAS_COLUMNS, lineHeight * rows,
+                                                               32, SDL_PIXELFORMAT_RGBA32);
+    if (atlasSurface) {
+        SDL_FillRect(atlasSurface, nullptr, 0);
+        for (int i = 0; i < GLYPH_COUNT; i++) {
+            glyphRects[i].x = (i % ATLAS_COLUMNS) * cellWidth;
+            glyphRects[i].y = (i / ATLAS_COLUMNS) * lineHeight;
+            if (glyphs[i]) {
+                SDL_Rect dest = glyphRects[i];
+                SDL_BlitSurface(glyphs[i], nullptr, atlasSurface, &dest);
+            }
+        }
+        atlas = SDL_CreateTextureFromSurface(renderer, atlasSurface);
+        SDL_FreeSurface(atlasSurface);
+    }
+    for (SDL_Surface* glyph : glyphs) {
+        if (glyph) SDL_FreeSurface(glyph);
+    }
+
+    if (!atlas) {
+        std::cerr << "Unable to create glyph atlas! SDL_Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    SDL_SetTextureBlendMode(atlas, SDL_BLENDMODE_BLEND);
+    return true;
+}
+
+void TextRenderer::Destroy() {
+    if (atlas) {
+        SDL_DestroyTexture(atlas);
+        atlas = nullptr;
+    }
+    for (auto& entry : cache) {
+        if (entry.second.image.texture) SDL_DestroyTexture(entry.second.image.texture);
+    }
+    cache.clear();
+}
+
+SDL_Point TextRenderer::MeasureGlyphs(const std::string& text) const {
+    SDL_Point size = {0, lineHeight};
+    for (char c : text) {
+        int index = static_cast<unsigned char>(c) - FIRST_GLYPH;
+        if (index < 0 || index >= GLYPH_COUNT) index = '?' - FIRST_GLYPH;
+        size.x += glyphRects[index].w;
+    }
+    return size;
+}
+
+void TextRenderer::DrawGlyphs(const std::string& text, SDL_Color color, int x, int y) {
+    if (!atlas) return;
+    SDL_SetTextureColorMod(atlas, color.r, color.g, color.b);
+    for (char c : text) {
+        int index = static_cast<unsigned char>(c) - FIRST_GLYPH;
+        if (index < 0 || index >= GLYPH_COUNT) index = '?' - FIRST_GLYPH;
+        const SDL_Rect& source = glyphRects[index];
+        SDL_Rect dest = {x, y, source.w, source.h};
+        if (source.w > 0) SDL_RenderCopy(renderer, atlas, &source, &dest);
+        x += source.w;
+    }
+}
+
+const TextRenderer::TextImage& TextRenderer::Cached(const std::string& key, const std::string& text, SDL_Color color) {
+    if (!renderer || !font) return emptyImage;
+
+    CachedText& entry = cache[key];
+    bool sameColor = entry.color.r == color.r && entry.color.g == color.g &&
+                     entry.color.b == color.b && entry.color.a == color.a;
+    if (entry.image.texture && entry.text == text && sameColor) return entry.image;
+
+    // Nội dung đổi: render lại đúng một lần cho tới lần đổi tiếp theo
+    if (entry.image.texture) SDL_DestroyTexture(entry.image.texture);
+    entry.text = text;
+    entry.color = color;
+    entry.image = emptyImage;
+    SDL_Surface* surface = TTF_RenderText_Solid(font, text.c_str(), color);
+    if (surface) {
+        entry.image.texture = SDL_CreateTextureFromSurface(renderer, surface);
+        entry.image.w = surface->w;
+        entry.image.h = surface->h;
+        SDL_FreeSurface(surface);
+    }
+    return entry.image;
+}
+
+void TextRenderer::DrawCached(const std::string& key, const std::string& text, SDL_Color color, int x, int y) {
+    const TextImage& image = Cached(key, text, color);
+    if (!image.texture) return;
+    SDL_Rect dest = {x, y, image.w, image.h};
+    SDL_RenderCopy(renderer, image.texture, nullptr, &dest);
+}
@@ -0,0 +1,51 @@
+#ifndef TEXT_RENDERER_H
+#define TEXT_RENDERER_H
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <string>
+#include <unordered_map>
+
+// Vẽ chữ mà không phải TTF_RenderText + tạo texture mỗi frame:
+//  - DrawGlyphs(): ghép từng ký tự từ atlas ASCII dựng sẵn, hợp với chuỗi đổi liên tục (điểm, đồng hồ)
+//  - Cached(): texture của cả chuỗi theo key, chỉ render lại khi nội dung hoặc màu đổi
+class TextRenderer {
+public:
+    struct TextImage {
+        SDL_Texture* texture;
+        int w, h;
+    };
+
+    TextRenderer();
+    ~TextRenderer();
+
+    bool Create(SDL_Renderer* renderer, TTF_Font* font);
+    void Destroy();
+
+    SDL_Point MeasureGlyphs(const std::string& text) const;
+    void DrawGlyphs(const std::string& text, SDL_Color color, int x, int y);
+
+    const TextImage& Cached(const std::string& key, const std::string& text, SDL_Color color);
+    void DrawCached(const std::string& key, const std::string& text, SDL_Color color, int x, int y);
+
+private:
+    static const int FIRST_GLYPH = 32;   // ' '
+    static const int GLYPH_COUNT = 95;   // ' ' .. '~'
+    static const int ATLAS_COLUMNS = 16;
+
+    struct CachedText {
+        std::string text;
+        SDL_Color color;
+        TextImage image;
+    };
+
+    SDL_Renderer* renderer;
+    TTF_Font* font;
+    SDL_Texture* atlas;
+    SDL_Rect glyphRects[GLYPH_COUNT];  // Vị trí trong atlas; w cũng là bước tiến của ký tự
+    int lineHeight;
+    std::unordered_map<std::string, CachedText> cache;
+    TextImage emptyImage;
+};
+
+#endif // TEXT_RENDERER_H
@@ -0,0 +1,61 @@
+#include "texture_atlas.h"
+#include <iostream>
+#include <sstream>
+
+TextureAtlas::TextureAtlas() : assets(nullptr), texture(nullptr), width(0), height(0) {}
+
+TextureAtlas::~TextureAtlas() {
+    Destroy();
+}
+
+bool TextureAtlas::Load(AssetCache& cache, const std::string& directory) {
+    Destroy();
+    AtlasManifest manifest;
+    if (!ReadManifest(cache, directory, manifest)) return false;  // Chưa đóng gói: dùng ảnh rời
+
+    std::string imagePath = directory + "/" + manifest.image;
+    assets = &cache;
+    texture = assets->AcquireTexture(imagePath);
+    if (!texture) return false;
+    SDL_QueryTexture(texture, nullptr, nullptr, &width, &height);
+    if (width != manifest.width || height != manifest.height) {
+        std::cerr << "Atlas " << imagePath << " does not match its manifest" << std::endl;
+        Destroy();
+        return false;
+    }
+
+    for (const AtlasManifest::Entry& entry : manifest.entries) rects[entry.id] = entry.rect;
+    return true;
+}
+
+bool TextureAtlas::ReadManifest(const AssetCache& assets, const std::string& directory, AtlasManifest& manifest) {
+    std::string path = directory + "/" + AtlasManifest::FILE_NAME;
+    AssetPack::Blob blob;
+    if (assets.Pack() && assets.Pack()->Find(path, &blob)) {
+        std::istringstream text(std::string(reinterpret_cast<const char*>(blob.data), blob.size));
+        return manifest.Parse(text, path);
+    }
+    return manifest.Read(path);
+}
+
+void TextureAtlas::Destroy() {
+    if (texture) {
+        assets->Release(texture);
+        texture = nullptr;
+    }
+    rects.clear();
+    width = height = 0;
+}
+
+bool TextureAtlas::Find(const std::string& id, Sprite* sprite) const {
+    if (!texture) return false;
+    auto it = rects.find(id);
+    if (it == rects.end()) return false;
+
+    const SDL_Rect& rect = it->second;
+    sprite->texture = texture;
+    sprite->source = rect;
+    sprite->uv = {static_cast<float>(rect.x) / width, static_cast<float>(rect.y) / height,
+                  static_cast<float>(rect.w) / width, static_cast<float>(rect.h) / height};
+    return true;
+}
@@ -0,0 +1,48 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include <SDL.h>
+#include <string>
+#include <unordered_map>
+#include "atlas_manifest.h"
+#include "asset_cache.h"
+
+// Một sprite: texture chứa nó và vùng của nó trong texture đó.
+// Sprite nằm trong atlas thì nhiều sprite dùng chung một texture và SpriteBatch gom được vào một lần vẽ.
+struct Sprite {
+    SDL_Texture* texture;
+    SDL_Rect source;  // Vùng theo pixel, dùng cho SDL_RenderCopy
+    SDL_FRect uv;     // Cùng vùng đó theo tọa độ 0..1, dùng cho SDL_RenderGeometry
+};
+
+// Sprite phủ cả texture (ảnh rời); texture null cho sprite rỗng
+inline Sprite MakeSprite(SDL_Texture* texture) {
+    Sprite sprite = {texture, {0, 0, 0, 0}, {0.0f, 0.0f, 1.0f, 1.0f}};
+    if (texture) SDL_QueryTexture(texture, nullptr, nullptr, &sprite.source.w, &sprite.source.h);
+    return sprite;
+}
+
+// Atlas của một mode: images/<mode>/atlas.txt + atlas.png.
+// Không có atlas thì Load() trả về false và người gọi nạp ảnh rời như cũ.
+class TextureAtlas {
+public:
+    TextureAtlas();
+    ~TextureAtlas();
+
+    bool Load(AssetCache& assets, const std::string& directory);
+    // Đọc <directory>/atlas.txt, trong gói tài nguyên của cache nếu có
+    static bool ReadManifest(const AssetCache& assets, const std::string& directory, AtlasManifest& manifest);
+    void Destroy();
+    bool IsLoaded() const { return texture != nullptr; }
+
+    bool Find(const std::string& id, Sprite* sprite) const;
+    bool Owns(SDL_Texture* tex) const { return tex && tex == texture; }  // Texture của atlas không được hủy riêng
+
+private:
+    AssetCache* assets;
+    SDL_Texture* texture;
+    int width, height;
+    std::unordered_map<std::string, SDL_Rect> rects;
+};
+
+#endif // TEXTURE_ATLAS_H
@@ -0,0 +1,49 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <SDL.h>
+
+// Ba bản T để một thread ghi và một thread đọc cùng lúc mà không khóa, không chờ nhau.
+// Thread ghi điền bản của mình rồi Publish(): bản đó đổi chỗ với bản ở giữa. Thread đọc gọi
+// Read(): nếu bản ở giữa mới hơn thì đổi lấy nó. Bản thread đọc đang giữ không bao giờ bị ghi đè;
+// nếu đọc chậm hơn ghi thì các bản trung gian bị bỏ qua, luôn đọc được bản mới nhất.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : writeIndex(0), readIndex(1) {
+        SDL_AtomicSet(&middle, 2);
+    }
+
+    // Chỉ dùng trước khi hai thread chạy, vd. để reserve vector bên trong từng bản
+    T& Slot(int index) { return slots[index]; }
+
+    // Thread ghi
+    T& WriteBuffer() { return slots[writeIndex]; }
+    void Publish() {
+        int previous = SDL_AtomicSet(&middle, writeIndex | FRESH);
+        writeIndex = previous & INDEX_MASK;
+    }
+
+    // Thread đọc: có bản mới chưa Read() không
+    bool HasFresh() { return (SDL_AtomicGet(&middle) & FRESH) != 0; }
+
+    // Thread đọc: bản mới nhất đã Publish(), giữ nguyên tới lần Read() sau
+    const T& Read() {
+        if (SDL_AtomicGet(&middle) & FRESH) {
+            int previous = SDL_AtomicSet(&middle, readIndex);
+            readIndex = previous & INDEX_MASK;
+        }
+        return slots[readIndex];
+    }
+
+private:
+    static const int INDEX_MASK = 3;
+    static const int FRESH = 4;  // Bản ở giữa chưa được thread đọc lấy
+
+    T slots[3];
+    int writeIndex;      // Chỉ thread ghi dùng
+    int readIndex;       // Chỉ thread đọc dùng
+    SDL_atomic_t middle;  // Chỉ số bản ở giữa | FRESH
+};
+
+#endif // TRIPLE_BUFFER_H